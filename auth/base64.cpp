@@ -0,0 +1,457 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base64.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <glog/logging.h>
+
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) \
+      && (defined(__GNUC__) || defined(__clang__))
+# define XID_BASE64_X86 1
+# include <immintrin.h>
+#endif
+
+namespace xid
+{
+
+namespace
+{
+
+/** The base64 alphabet.  */
+constexpr char CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                         "abcdefghijklmnopqrstuvwxyz"
+                         "0123456789+/";
+
+/** The padding character.  */
+constexpr char PADDING = '=';
+
+/**
+ * Number of extra bytes the output buffer for decoding needs, since the
+ * SIMD kernels store full vectors even though not all bytes are used.
+ */
+constexpr size_t DECODE_SLACK = 8;
+
+/** Lookup table from characters to their 6-bit values.  */
+struct DecodeTable
+{
+  /** The value for each character, or -1 if it is not in the alphabet.  */
+  int8_t values[256];
+};
+
+constexpr DecodeTable
+MakeDecodeTable ()
+{
+  DecodeTable res {};
+  for (int i = 0; i < 256; ++i)
+    res.values[i] = -1;
+  for (int i = 0; i < 64; ++i)
+    res.values[static_cast<unsigned char> (CHARS[i])] = i;
+  return res;
+}
+
+constexpr DecodeTable DECODE = MakeDecodeTable ();
+
+/**
+ * Returns the 6-bit value of a character (or -1).
+ */
+inline int
+DecodeChar (const char c)
+{
+  return DECODE.values[static_cast<unsigned char> (c)];
+}
+
+/**
+ * Encodes one full group of three bytes.
+ */
+inline void
+EncodeGroup (const unsigned char* in, char* out)
+{
+  const uint32_t v = (in[0] << 16) | (in[1] << 8) | in[2];
+  out[0] = CHARS[v >> 18];
+  out[1] = CHARS[(v >> 12) & 0x3F];
+  out[2] = CHARS[(v >> 6) & 0x3F];
+  out[3] = CHARS[v & 0x3F];
+}
+
+/**
+ * Decodes one full group of four characters without padding.  Returns false
+ * if any of them is invalid.
+ */
+inline bool
+DecodeGroup (const char* in, unsigned char* out)
+{
+  const int a = DecodeChar (in[0]);
+  const int b = DecodeChar (in[1]);
+  const int c = DecodeChar (in[2]);
+  const int d = DecodeChar (in[3]);
+  if ((a | b | c | d) < 0)
+    return false;
+
+  const uint32_t v = (a << 18) | (b << 12) | (c << 6) | d;
+  out[0] = v >> 16;
+  out[1] = (v >> 8) & 0xFF;
+  out[2] = v & 0xFF;
+  return true;
+}
+
+#ifdef XID_BASE64_X86
+
+/* The SIMD kernels follow the well-known approach by Wojciech Muła and
+   Daniel Lemire.  They process as many full blocks as possible and return
+   the number of input bytes consumed.  The decoders also stop at the first
+   block containing an invalid character, and leave the exact checks to
+   the scalar code.  */
+
+__attribute__ ((target ("sse4.1")))
+size_t
+EncodeSse41 (const unsigned char* in, const size_t len, char* out)
+{
+  const __m128i shuffle = _mm_setr_epi8 (1, 0, 2, 1, 4, 3, 5, 4,
+                                         7, 6, 8, 7, 10, 9, 11, 10);
+  const __m128i lut = _mm_setr_epi8 (65, 71, -4, -4, -4, -4, -4, -4,
+                                     -4, -4, -4, -4, -19, -16, 0, 0);
+
+  size_t i = 0;
+  for (; i + 16 <= len; i += 12)
+    {
+      __m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i));
+
+      /* Split each group of three bytes into four 6-bit values.  */
+      v = _mm_shuffle_epi8 (v, shuffle);
+      const __m128i t0 = _mm_and_si128 (v, _mm_set1_epi32 (0x0FC0FC00));
+      const __m128i t1 = _mm_mulhi_epu16 (t0, _mm_set1_epi32 (0x04000040));
+      const __m128i t2 = _mm_and_si128 (v, _mm_set1_epi32 (0x003F03F0));
+      const __m128i t3 = _mm_mullo_epi16 (t2, _mm_set1_epi32 (0x01000010));
+      v = _mm_or_si128 (t1, t3);
+
+      /* Translate the values to ASCII.  */
+      __m128i idx = _mm_subs_epu8 (v, _mm_set1_epi8 (51));
+      idx = _mm_sub_epi8 (idx, _mm_cmpgt_epi8 (v, _mm_set1_epi8 (25)));
+      v = _mm_add_epi8 (v, _mm_shuffle_epi8 (lut, idx));
+
+      _mm_storeu_si128 (reinterpret_cast<__m128i*> (out + i / 3 * 4), v);
+    }
+
+  return i;
+}
+
+__attribute__ ((target ("avx2")))
+size_t
+EncodeAvx2 (const unsigned char* in, const size_t len, char* out)
+{
+  const __m256i shuffle = _mm256_setr_epi8 (
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+  const __m256i lut = _mm256_setr_epi8 (
+      65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+      65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+
+  size_t i = 0;
+  for (; i + 28 <= len; i += 24)
+    {
+      /* Each 128-bit lane gets twelve input bytes.  */
+      const __m128i lo
+          = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i));
+      const __m128i hi
+          = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i + 12));
+      __m256i v = _mm256_inserti128_si256 (_mm256_castsi128_si256 (lo), hi, 1);
+
+      v = _mm256_shuffle_epi8 (v, shuffle);
+      const __m256i t0 = _mm256_and_si256 (v, _mm256_set1_epi32 (0x0FC0FC00));
+      const __m256i t1
+          = _mm256_mulhi_epu16 (t0, _mm256_set1_epi32 (0x04000040));
+      const __m256i t2 = _mm256_and_si256 (v, _mm256_set1_epi32 (0x003F03F0));
+      const __m256i t3
+          = _mm256_mullo_epi16 (t2, _mm256_set1_epi32 (0x01000010));
+      v = _mm256_or_si256 (t1, t3);
+
+      __m256i idx = _mm256_subs_epu8 (v, _mm256_set1_epi8 (51));
+      idx = _mm256_sub_epi8 (idx, _mm256_cmpgt_epi8 (v, _mm256_set1_epi8 (25)));
+      v = _mm256_add_epi8 (v, _mm256_shuffle_epi8 (lut, idx));
+
+      _mm256_storeu_si256 (reinterpret_cast<__m256i*> (out + i / 3 * 4), v);
+    }
+
+  return i;
+}
+
+__attribute__ ((target ("sse4.1")))
+size_t
+DecodeSse41 (const char* in, const size_t len, unsigned char* out)
+{
+  /* A character is valid if the lookups for its low and high nibbles
+     have no bit in common.  */
+  const __m128i lutLo = _mm_setr_epi8 (0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                       0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                       0x1B, 0x1B, 0x1B, 0x1A);
+  const __m128i lutHi = _mm_setr_epi8 (0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                       0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                       0x10, 0x10, 0x10, 0x10);
+  /* Offsets to add to the characters, by high nibble (and '/').  */
+  const __m128i lutRoll = _mm_setr_epi8 (0, 16, 19, 4, -65, -65, -71, -71,
+                                         0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i mask2F = _mm_set1_epi8 (0x2F);
+  const __m128i pack = _mm_setr_epi8 (2, 1, 0, 6, 5, 4, 10, 9, 8,
+                                      14, 13, 12, -1, -1, -1, -1);
+
+  size_t i = 0;
+  for (; i + 16 <= len; i += 16)
+    {
+      __m128i v = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (in + i));
+
+      const __m128i hiNibbles
+          = _mm_and_si128 (_mm_srli_epi32 (v, 4), mask2F);
+      const __m128i loNibbles = _mm_and_si128 (v, mask2F);
+      const __m128i hi = _mm_shuffle_epi8 (lutHi, hiNibbles);
+      const __m128i lo = _mm_shuffle_epi8 (lutLo, loNibbles);
+      if (!_mm_testz_si128 (lo, hi))
+        break;
+
+      const __m128i eq2F = _mm_cmpeq_epi8 (v, mask2F);
+      const __m128i roll
+          = _mm_shuffle_epi8 (lutRoll, _mm_add_epi8 (eq2F, hiNibbles));
+      v = _mm_add_epi8 (v, roll);
+
+      /* Pack each four 6-bit values into three bytes.  */
+      v = _mm_maddubs_epi16 (v, _mm_set1_epi32 (0x01400140));
+      v = _mm_madd_epi16 (v, _mm_set1_epi32 (0x00011000));
+      v = _mm_shuffle_epi8 (v, pack);
+
+      _mm_storeu_si128 (reinterpret_cast<__m128i*> (out + i / 4 * 3), v);
+    }
+
+  return i;
+}
+
+__attribute__ ((target ("avx2")))
+size_t
+DecodeAvx2 (const char* in, const size_t len, unsigned char* out)
+{
+  const __m256i lutLo = _mm256_setr_epi8 (
+      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+      0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+      0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+  const __m256i lutHi = _mm256_setr_epi8 (
+      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+      0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+      0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+  const __m256i lutRoll = _mm256_setr_epi8 (
+      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m256i mask2F = _mm256_set1_epi8 (0x2F);
+  const __m256i pack = _mm256_setr_epi8 (
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  const __m256i joinLanes = _mm256_setr_epi32 (0, 1, 2, 4, 5, 6, -1, -1);
+
+  size_t i = 0;
+  for (; i + 32 <= len; i += 32)
+    {
+      __m256i v
+          = _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (in + i));
+
+      const __m256i hiNibbles
+          = _mm256_and_si256 (_mm256_srli_epi32 (v, 4), mask2F);
+      const __m256i loNibbles = _mm256_and_si256 (v, mask2F);
+      const __m256i hi = _mm256_shuffle_epi8 (lutHi, hiNibbles);
+      const __m256i lo = _mm256_shuffle_epi8 (lutLo, loNibbles);
+      if (!_mm256_testz_si256 (lo, hi))
+        break;
+
+      const __m256i eq2F = _mm256_cmpeq_epi8 (v, mask2F);
+      const __m256i roll
+          = _mm256_shuffle_epi8 (lutRoll, _mm256_add_epi8 (eq2F, hiNibbles));
+      v = _mm256_add_epi8 (v, roll);
+
+      v = _mm256_maddubs_epi16 (v, _mm256_set1_epi32 (0x01400140));
+      v = _mm256_madd_epi16 (v, _mm256_set1_epi32 (0x00011000));
+      v = _mm256_shuffle_epi8 (v, pack);
+      v = _mm256_permutevar8x32_epi32 (v, joinLanes);
+
+      _mm256_storeu_si256 (reinterpret_cast<__m256i*> (out + i / 4 * 3), v);
+    }
+
+  return i;
+}
+
+#endif // XID_BASE64_X86
+
+Base64Kernel
+ChooseKernel ()
+{
+  if (IsBase64KernelSupported (Base64Kernel::AVX2))
+    return Base64Kernel::AVX2;
+  if (IsBase64KernelSupported (Base64Kernel::SSE41))
+    return Base64Kernel::SSE41;
+  return Base64Kernel::SCALAR;
+}
+
+} // anonymous namespace
+
+bool
+IsBase64KernelSupported (const Base64Kernel k)
+{
+  switch (k)
+    {
+    case Base64Kernel::SCALAR:
+      return true;
+
+#ifdef XID_BASE64_X86
+    case Base64Kernel::SSE41:
+      return __builtin_cpu_supports ("sse4.1");
+    case Base64Kernel::AVX2:
+      return __builtin_cpu_supports ("avx2");
+#endif
+
+    default:
+      return false;
+    }
+}
+
+Base64Kernel
+GetDefaultBase64Kernel ()
+{
+  static const Base64Kernel kernel = ChooseKernel ();
+  return kernel;
+}
+
+void
+EncodeBase64 (const std::string_view data, std::string& out,
+              const Base64Kernel k)
+{
+  CHECK (IsBase64KernelSupported (k));
+
+  const auto* in = reinterpret_cast<const unsigned char*> (data.data ());
+  const size_t len = data.size ();
+  out.resize ((len + 2) / 3 * 4);
+
+  size_t i = 0;
+  switch (k)
+    {
+#ifdef XID_BASE64_X86
+    case Base64Kernel::SSE41:
+      i = EncodeSse41 (in, len, &out[0]);
+      break;
+    case Base64Kernel::AVX2:
+      i = EncodeAvx2 (in, len, &out[0]);
+      break;
+#endif
+
+    default:
+      break;
+    }
+
+  for (; i + 3 <= len; i += 3)
+    EncodeGroup (in + i, &out[i / 3 * 4]);
+
+  const size_t rest = len - i;
+  if (rest > 0)
+    {
+      unsigned char tail[3] = {in[i], 0, 0};
+      if (rest == 2)
+        tail[1] = in[i + 1];
+
+      char* o = &out[i / 3 * 4];
+      EncodeGroup (tail, o);
+      o[3] = PADDING;
+      if (rest == 1)
+        o[2] = PADDING;
+    }
+}
+
+void
+EncodeBase64 (const std::string_view data, std::string& out)
+{
+  EncodeBase64 (data, out, GetDefaultBase64Kernel ());
+}
+
+std::string
+EncodeBase64 (const std::string_view data)
+{
+  std::string res;
+  EncodeBase64 (data, res);
+  return res;
+}
+
+bool
+DecodeBase64 (const std::string_view encoded, std::string& data,
+              const Base64Kernel k)
+{
+  CHECK (IsBase64KernelSupported (k));
+
+  const size_t len = encoded.size ();
+  if (len % 4 != 0)
+    return false;
+  if (len == 0)
+    {
+      data.clear ();
+      return true;
+    }
+
+  /* The last group is handled separately, as it may contain padding.  */
+  const size_t body = len - 4;
+  data.resize (body / 4 * 3 + 3 + DECODE_SLACK);
+  const char* in = encoded.data ();
+  auto* out = reinterpret_cast<unsigned char*> (&data[0]);
+
+  size_t i = 0;
+  switch (k)
+    {
+#ifdef XID_BASE64_X86
+    case Base64Kernel::SSE41:
+      i = DecodeSse41 (in, body, out);
+      break;
+    case Base64Kernel::AVX2:
+      i = DecodeAvx2 (in, body, out);
+      break;
+#endif
+
+    default:
+      break;
+    }
+
+  for (; i < body; i += 4)
+    if (!DecodeGroup (in + i, out + i / 4 * 3))
+      return false;
+
+  const char* last = in + body;
+  unsigned char* o = out + body / 4 * 3;
+  size_t outLen = body / 4 * 3;
+  if (last[3] != PADDING)
+    {
+      if (!DecodeGroup (last, o))
+        return false;
+      outLen += 3;
+    }
+  else
+    {
+      /* The exact rules for padding (e.g. whether the unused bits must be
+         zero) are left to xaya::DecodeBase64, which has been used to decode
+         passwords before.  That way we accept exactly the same strings.  */
+      std::string tail;
+      if (!xaya::DecodeBase64 (std::string (last, 4), tail))
+        return false;
+      CHECK_LE (tail.size (), 3);
+      std::memcpy (o, tail.data (), tail.size ());
+      outLen += tail.size ();
+    }
+
+  data.resize (outLen);
+  return true;
+}
+
+bool
+DecodeBase64 (const std::string_view encoded, std::string& data)
+{
+  return DecodeBase64 (encoded, data, GetDefaultBase64Kernel ());
+}
+
+} // namespace xid
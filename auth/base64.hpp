@@ -0,0 +1,65 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XIDAUTH_BASE64_HPP
+#define XIDAUTH_BASE64_HPP
+
+#include <string>
+#include <string_view>
+
+namespace xid
+{
+
+/**
+ * Implementations ("kernels") of the base64 codec.  They all produce the
+ * same results, and the fastest one supported by the CPU is chosen at
+ * runtime.  The others can be selected explicitly for tests and benchmarks.
+ */
+enum class Base64Kernel
+{
+  /** Portable implementation processing one group of four characters.  */
+  SCALAR,
+  /** x86 SIMD with 128-bit vectors (needs SSE4.1).  */
+  SSE41,
+  /** x86 SIMD with 256-bit vectors (needs AVX2).  */
+  AVX2,
+};
+
+/**
+ * Returns true if the given kernel can be used on this CPU.
+ */
+bool IsBase64KernelSupported (Base64Kernel k);
+
+/**
+ * Returns the kernel used by default, i.e. the fastest supported one.
+ */
+Base64Kernel GetDefaultBase64Kernel ();
+
+/**
+ * Encodes data as base64 (standard alphabet with padding) into out.
+ * The output is the same as produced by xaya::EncodeBase64.
+ */
+void EncodeBase64 (std::string_view data, std::string& out);
+void EncodeBase64 (std::string_view data, std::string& out, Base64Kernel k);
+
+/**
+ * Encodes data as base64 and returns the result.
+ */
+std::string EncodeBase64 (std::string_view data);
+
+/**
+ * Decodes a base64 string into data.  Returns false if the input is not
+ * valid, i.e. if its length is not a multiple of four, it contains
+ * characters outside the alphabet or padding is not only in the last group.
+ * A last group with padding is decoded by xaya::DecodeBase64, so that the
+ * same strings are accepted as by it.  The contents of data are unspecified
+ * on failure.
+ */
+bool DecodeBase64 (std::string_view encoded, std::string& data);
+bool DecodeBase64 (std::string_view encoded, std::string& data,
+                   Base64Kernel k);
+
+} // namespace xid
+
+#endif // XIDAUTH_BASE64_HPP
@@ -0,0 +1,224 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base64.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace xid
+{
+namespace
+{
+
+/** The base64 alphabet.  */
+constexpr const char* ALPHABET
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+class Base64Tests : public testing::Test
+{
+
+protected:
+
+  /** Source of randomness (with fixed seed for reproducibility).  */
+  std::mt19937 rnd;
+
+  /** The kernels supported on this CPU.  */
+  std::vector<Base64Kernel> kernels;
+
+  Base64Tests ()
+    : rnd(42)
+  {
+    for (const auto k : {Base64Kernel::SCALAR, Base64Kernel::SSE41,
+                         Base64Kernel::AVX2})
+      if (IsBase64KernelSupported (k))
+        kernels.push_back (k);
+  }
+
+  /**
+   * Returns a random byte string of the given length.
+   */
+  std::string
+  RandomBytes (const size_t len)
+  {
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::string res;
+    for (size_t i = 0; i < len; ++i)
+      res.push_back (static_cast<char> (dist (rnd)));
+    return res;
+  }
+
+  /**
+   * Decodes with all kernels and xaya::DecodeBase64, and expects that
+   * they all agree.
+   */
+  void
+  ExpectDecodeSameAsXaya (const std::string& encoded)
+  {
+    std::string expected;
+    const bool expectedOk = xaya::DecodeBase64 (encoded, expected);
+
+    for (const auto k : kernels)
+      {
+        std::string actual;
+        const bool ok = DecodeBase64 (encoded, actual, k);
+        ASSERT_EQ (ok, expectedOk)
+            << "kernel " << static_cast<int> (k) << ": " << encoded;
+        if (ok)
+          {
+            ASSERT_EQ (actual, expected)
+                << "kernel " << static_cast<int> (k) << ": " << encoded;
+          }
+      }
+  }
+
+};
+
+TEST_F (Base64Tests, DefaultKernelSupported)
+{
+  EXPECT_TRUE (IsBase64KernelSupported (GetDefaultBase64Kernel ()));
+}
+
+TEST_F (Base64Tests, KnownValues)
+{
+  const std::vector<std::pair<std::string, std::string>> tests = {
+    {"", ""},
+    {"f", "Zg=="},
+    {"fo", "Zm8="},
+    {"foo", "Zm9v"},
+    {"foob", "Zm9vYg=="},
+    {"fooba", "Zm9vYmE="},
+    {"foobar", "Zm9vYmFy"},
+    {"\xFB\xFF", "+/8="},
+  };
+
+  for (const auto k : kernels)
+    for (const auto& t : tests)
+      {
+        std::string out;
+        EncodeBase64 (t.first, out, k);
+        EXPECT_EQ (out, t.second);
+        ASSERT_TRUE (DecodeBase64 (t.second, out, k));
+        EXPECT_EQ (out, t.first);
+      }
+}
+
+TEST_F (Base64Tests, EncodeSameAsXaya)
+{
+  for (size_t len = 0; len < 300; ++len)
+    {
+      const std::string data = RandomBytes (len);
+      const std::string expected = xaya::EncodeBase64 (data);
+      for (const auto k : kernels)
+        {
+          std::string actual;
+          EncodeBase64 (data, actual, k);
+          ASSERT_EQ (actual, expected) << "kernel " << static_cast<int> (k);
+        }
+      ExpectDecodeSameAsXaya (expected);
+    }
+}
+
+TEST_F (Base64Tests, CorruptedSameAsXaya)
+{
+  std::uniform_int_distribution<int> byteDist(0, 255);
+  for (unsigned trial = 0; trial < 5'000; ++trial)
+    {
+      const size_t len = 4 + trial % 200;
+      std::string encoded = xaya::EncodeBase64 (RandomBytes (len));
+
+      /* Replace a random character anywhere, including the last group.  */
+      std::uniform_int_distribution<size_t> posDist(0, encoded.size () - 1);
+      encoded[posDist (rnd)] = static_cast<char> (byteDist (rnd));
+      ExpectDecodeSameAsXaya (encoded);
+
+      /* Invalid characters are rejected anywhere.  */
+      std::string invalid = encoded;
+      invalid[trial % invalid.size ()] = '\n';
+      ExpectDecodeSameAsXaya (invalid);
+
+      /* So are invalid lengths.  */
+      ExpectDecodeSameAsXaya (
+          encoded.substr (0, encoded.size () - 1 - trial % 3));
+    }
+}
+
+TEST_F (Base64Tests, AllCharacters)
+{
+  /* Long enough for all SIMD kernels to process it as full blocks.  */
+  const std::string base = xaya::EncodeBase64 (RandomBytes (72));
+  ASSERT_EQ (base.size (), 96);
+
+  for (int c = 0; c < 256; ++c)
+    for (size_t pos = 0; pos < 64; ++pos)
+      {
+        std::string encoded = base;
+        encoded[pos] = static_cast<char> (c);
+
+        std::string expected;
+        const bool expectedOk
+            = DecodeBase64 (encoded, expected, Base64Kernel::SCALAR);
+        for (const auto k : kernels)
+          {
+            std::string actual;
+            ASSERT_EQ (DecodeBase64 (encoded, actual, k), expectedOk)
+                << "kernel " << static_cast<int> (k)
+                << ", char " << c << " at " << pos;
+            if (expectedOk)
+              {
+                ASSERT_EQ (actual, expected);
+              }
+          }
+      }
+}
+
+TEST_F (Base64Tests, InvalidPadding)
+{
+  const std::vector<std::string> invalid = {
+    "Zg=", "Zg", "Zg=a", "=Zg=", "Zm=v", "Zg==Zg==",
+  };
+
+  for (const auto k : kernels)
+    for (const auto& str : invalid)
+      {
+        std::string out;
+        EXPECT_FALSE (DecodeBase64 (str, out, k)) << str;
+      }
+}
+
+TEST_F (Base64Tests, LastGroupSameAsXaya)
+{
+  /* All combinations of characters in the last group are tried (with the
+     first one taken from a smaller set), both on their own and after
+     a prefix long enough for the SIMD kernels to process it as full blocks.
+     This includes all padding variants and non-zero padded bits.  */
+  std::string chars(ALPHABET);
+  chars += "=*";
+  const std::string prefix = xaya::EncodeBase64 (RandomBytes (48));
+
+  for (const std::string& base : {std::string (), prefix})
+    for (const char a : std::string ("Z=*"))
+      for (const char b : chars)
+        for (const char c : chars)
+          for (const char d : chars)
+            {
+              std::string encoded = base;
+              encoded.push_back (a);
+              encoded.push_back (b);
+              encoded.push_back (c);
+              encoded.push_back (d);
+              ExpectDecodeSameAsXaya (encoded);
+            }
+
+  for (const std::string str : {"Zh==", "Zm9=", "Z===", "===="})
+    ExpectDecodeSameAsXaya (str);
+}
+
+} // anonymous namespace
+} // namespace xid
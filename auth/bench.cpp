@@ -0,0 +1,294 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/* Microbenchmark for libxidauth.  It runs the operations on the credential
+   path (parsing, validation, building the auth message and encoding) for
+   passwords of different shapes, and reports the time and the number of
+   heap allocations per operation.  Allocations are counted by replacing
+   the global operator new.  */
+
+#include "base64.hpp"
+#include "credentials.hpp"
+#include "credentialsdata.hpp"
+#include "time.hpp"
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+DEFINE_int32 (iterations, 100'000, "number of iterations per operation");
+DEFINE_string (filter, "",
+               "if set, only run benchmarks whose label contains this");
+
+namespace
+{
+
+/** Number of allocations done through operator new so far.  */
+std::atomic<uint64_t> allocations(0);
+
+} // anonymous namespace
+
+void*
+operator new (const size_t n)
+{
+  allocations.fetch_add (1, std::memory_order_relaxed);
+  void* res = std::malloc (n == 0 ? 1 : n);
+  if (res == nullptr)
+    throw std::bad_alloc ();
+  return res;
+}
+
+void*
+operator new[] (const size_t n)
+{
+  return operator new (n);
+}
+
+void
+operator delete (void* p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void* p) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete (void* p, size_t) noexcept
+{
+  std::free (p);
+}
+
+void
+operator delete[] (void* p, size_t) noexcept
+{
+  std::free (p);
+}
+
+namespace xid
+{
+namespace
+{
+
+/** Sink for results, so that the compiler does not optimise work away.  */
+volatile size_t sink;
+
+/**
+ * Shape of the passwords for one benchmark case.
+ */
+struct PasswordShape
+{
+  std::string label;
+  unsigned numExtra;
+  bool expiry;
+  Protocol protocol;
+};
+
+/**
+ * Constructs a password of the given shape.  The signature is a dummy,
+ * but has the size of a real one.
+ */
+std::string
+MakePassword (const PasswordShape& shape)
+{
+  Credentials c("domob", "app.example/login");
+  c.SetSignature (EncodeBase64 (std::string (65, '\x42')));
+  c.SetProtocol (shape.protocol);
+  if (shape.expiry)
+    c.SetExpiry (1'800'000'000);
+  for (unsigned i = 0; i < shape.numExtra; ++i)
+    c.AddExtra ("key" + std::to_string (i), "value." + std::to_string (i));
+  return c.ToPassword ();
+}
+
+/**
+ * Runs a single benchmark and prints the time and allocations per
+ * operation.  The group and operation are combined for matching
+ * against --filter.
+ */
+template <typename Fcn>
+  void
+  Measure (const std::string& group, const std::string& op, const Fcn& fcn)
+{
+  if (!FLAGS_filter.empty ()
+        && (group + " / " + op).find (FLAGS_filter) == std::string::npos)
+    return;
+
+  /* Warm up caches and reusable buffers.  */
+  for (int i = 0; i < 100; ++i)
+    fcn ();
+
+  const uint64_t allocsBefore = allocations.load ();
+  const auto start = std::chrono::steady_clock::now ();
+  for (int i = 0; i < FLAGS_iterations; ++i)
+    fcn ();
+  const auto end = std::chrono::steady_clock::now ();
+  const uint64_t allocs = allocations.load () - allocsBefore;
+
+  const std::chrono::duration<double, std::nano> ns = end - start;
+  std::printf ("  %-40s %10.1f ns/op %8.2f allocs/op\n", op.c_str (),
+               ns.count () / FLAGS_iterations,
+               static_cast<double> (allocs) / FLAGS_iterations);
+}
+
+/**
+ * Runs all benchmarks for passwords of the given shape.
+ */
+void
+RunShape (const PasswordShape& shape)
+{
+  const std::string pwd = MakePassword (shape);
+  std::cout
+      << shape.label << " (password length " << pwd.size () << "):"
+      << std::endl;
+
+  const std::string name = "domob";
+  const std::string app = "app.example/login";
+
+  Measure (shape.label, "Credentials::FromPassword", [&] ()
+    {
+      Credentials c(name, app);
+      sink = c.FromPassword (pwd);
+    });
+
+  Credentials parsed(name, app);
+  CHECK (parsed.FromPassword (pwd));
+
+  Measure (shape.label, "Credentials::ValidateFormat", [&] ()
+    {
+      sink = parsed.ValidateFormat ();
+    });
+  Measure (shape.label, "Credentials::GetAuthMessage", [&] ()
+    {
+      sink = parsed.GetAuthMessage ().size ();
+    });
+  Measure (shape.label, "Credentials::GetExtra", [&] ()
+    {
+      sink = parsed.GetExtra ().size ();
+    });
+  Measure (shape.label, "Credentials::ToPassword", [&] ()
+    {
+      sink = parsed.ToPassword ().size ();
+    });
+
+  CredentialsData data;
+  Measure (shape.label, "CredentialsData::Parse", [&] ()
+    {
+      sink = data.Parse (pwd);
+    });
+  Measure (shape.label, "CredentialsData parse+validate+message", [&] ()
+    {
+      CHECK (data.Parse (pwd));
+      CHECK (data.ValidateFormat (name, app));
+      sink = data.BuildAuthMessage (name, app).size ();
+    });
+
+  std::cout << std::endl;
+}
+
+/**
+ * Returns a human-readable name for a base64 kernel.
+ */
+std::string
+KernelName (const Base64Kernel k)
+{
+  switch (k)
+    {
+    case Base64Kernel::SCALAR:
+      return "scalar";
+    case Base64Kernel::SSE41:
+      return "SSE4.1";
+    case Base64Kernel::AVX2:
+      return "AVX2";
+    }
+  return "unknown";
+}
+
+/**
+ * Runs the benchmarks for the base64 kernels and time helpers.
+ */
+void
+RunHelpers ()
+{
+  std::cout << "Helpers:" << std::endl;
+
+  const std::string raw(256, '\x5A');
+  const std::string encoded = EncodeBase64 (raw);
+  std::string buf;
+  for (const auto k : {Base64Kernel::SCALAR, Base64Kernel::SSE41,
+                       Base64Kernel::AVX2})
+    {
+      if (!IsBase64KernelSupported (k))
+        continue;
+
+      const std::string suffix = " (" + KernelName (k) + ")";
+      Measure ("helpers", "EncodeBase64 256 bytes" + suffix, [&] ()
+        {
+          EncodeBase64 (raw, buf, k);
+          sink = buf.size ();
+        });
+      Measure ("helpers", "DecodeBase64 256 bytes" + suffix, [&] ()
+        {
+          sink = DecodeBase64 (encoded, buf, k);
+        });
+    }
+
+  const std::time_t now = std::time (nullptr);
+  Measure ("helpers", "TimeToUnix", [&] ()
+    {
+      sink = TimeToUnix (now + sink % 2);
+    });
+  Measure ("helpers", "TimeFromUnix", [&] ()
+    {
+      sink = TimeFromUnix (1'800'000'000 + sink % 2);
+    });
+
+  std::cout << std::endl;
+}
+
+} // anonymous namespace
+} // namespace xid
+
+int
+main (int argc, char** argv)
+{
+  google::InitGoogleLogging (argv[0]);
+
+  gflags::SetUsageMessage ("Benchmark libxidauth credential handling");
+  gflags::ParseCommandLineFlags (&argc, &argv, true);
+
+  if (FLAGS_iterations <= 0)
+    {
+      std::cerr << "Error: --iterations must be positive" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  const std::vector<xid::PasswordShape> shapes = {
+    {"no extras", 0, false, xid::Protocol::XID_GSP},
+    {"no extras, expiry", 0, true, xid::Protocol::XID_GSP},
+    {"4 extras, expiry", 4, true, xid::Protocol::XID_GSP},
+    {"32 extras, expiry", 32, true, xid::Protocol::XID_GSP},
+    {"4 extras, delegation contract", 4, true,
+     xid::Protocol::DELEGATION_CONTRACT},
+  };
+
+  for (const auto& s : shapes)
+    xid::RunShape (s);
+  xid::RunHelpers ();
+
+  return EXIT_SUCCESS;
+}
@@ -1,17 +1,15 @@
-// Copyright (C) 2019 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "credentials.hpp"
 
+#include "base64.hpp"
+#include "credentialsdata.hpp"
 #include "time.hpp"
 
-#include <xayautil/base64.hpp>
-
 #include <glog/logging.h>
 
-#include <sstream>
-
 namespace xid
 {
 
@@ -19,7 +17,7 @@ bool
 Credentials::FromPassword (const std::string& pwd)
 {
   std::string decoded;
-  if (!xaya::DecodeBase64 (pwd, decoded))
+  if (!DecodeBase64 (pwd, decoded))
     return false;
 
   if (!data.ParseFromString (decoded))
@@ -39,69 +37,14 @@ Credentials::ToPassword () const
   std::string rawData;
   CHECK (data.SerializeToString (&rawData));
 
-  return xaya::EncodeBase64 (rawData);
+  return EncodeBase64 (rawData);
 }
 
-namespace
-{
-
-bool
-IsAlphaNumeric (const char c)
-{
-  if (c >= '0' && c <= '9')
-    return true;
-
-  if (c >= 'A' && c <= 'Z')
-    return true;
-  if (c >= 'a' && c <= 'z')
-    return true;
-
-  return false;
-}
-
-bool
-IsAlphaNumericOrDot (const std::string& str)
-{
-  for (const auto c : str)
-    if (!IsAlphaNumeric (c) && c != '.')
-      return false;
-  return true;
-}
-
-} // anonymous namespace
-
 bool
 Credentials::ValidateFormat () const
 {
-  for (const auto c : username)
-    if (c == '\n')
-      {
-        LOG (ERROR) << "Invalid username (contains newline): " << username;
-        return false;
-      }
-
-  for (const auto c : application)
-    if (!IsAlphaNumeric (c) && c != '.' && c != '/')
-      {
-        LOG (ERROR) << "Invalid application name: " <<  application;
-        return false;
-      }
-
-  for (const auto& entry : data.extra ())
-    {
-      if (!IsAlphaNumericOrDot (entry.first))
-        {
-          LOG (ERROR) << "Invalid extra key: " << entry.first;
-          return false;
-        }
-      if (!IsAlphaNumericOrDot (entry.second))
-        {
-          LOG (ERROR) << "Invalid extra value: " << entry.second;
-          return false;
-        }
-    }
-
-  return true;
+  return CredentialsData::ValidateFormat (
+      username, application, CredentialsData::GetSortedExtra (data));
 }
 
 std::string
@@ -109,24 +52,11 @@ Credentials::GetAuthMessage () const
 {
   CHECK (ValidateFormat ());
 
-  std::ostringstream out;
-
-  out << "Xid login\n";
-  out << username << "\n";
-  out << "at: " << application << "\n";
-
-  out << "expires: ";
-  if (HasExpiry ())
-    out << GetExpiry () << "\n";
-  else
-    out << "never\n";
-  out << "extra:\n";
-
-  const auto extra = GetExtra ();
-  for (const auto& entry : extra)
-    out << entry.first << "=" << entry.second << "\n";
-
-  return out.str ();
+  std::string res;
+  CredentialsData::BuildAuthMessage (username, application, data,
+                                     CredentialsData::GetSortedExtra (data),
+                                     res);
+  return res;
 }
 
 bool
@@ -146,13 +76,13 @@ Credentials::IsExpired () const
 std::string
 Credentials::GetSignature () const
 {
-  return xaya::EncodeBase64 (data.signature_bytes ());
+  return EncodeBase64 (data.signature_bytes ());
 }
 
 void
 Credentials::SetSignature (const std::string& sgn)
 {
-  CHECK (xaya::DecodeBase64 (sgn, *data.mutable_signature_bytes ()))
+  CHECK (DecodeBase64 (sgn, *data.mutable_signature_bytes ()))
       << "The signature is not valid Base64: " << sgn;
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2025 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -20,6 +20,9 @@ namespace xid
  * an application is building them up for constructing a password out
  * of them), or they can be created by parsing an existing password and
  * then validating the data.
+ *
+ * Where many passwords are parsed, CredentialsData should be used instead,
+ * which reuses its buffers between them.
  */
 class Credentials
 {
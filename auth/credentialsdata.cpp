@@ -0,0 +1,254 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "credentialsdata.hpp"
+
+#include "base64.hpp"
+#include "time.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <charconv>
+
+namespace xid
+{
+
+namespace
+{
+
+bool
+IsAlphaNumeric (const char c)
+{
+  if (c >= '0' && c <= '9')
+    return true;
+
+  if (c >= 'A' && c <= 'Z')
+    return true;
+  if (c >= 'a' && c <= 'z')
+    return true;
+
+  return false;
+}
+
+bool
+IsAlphaNumericOrDot (const std::string_view str)
+{
+  for (const auto c : str)
+    if (!IsAlphaNumeric (c) && c != '.')
+      return false;
+  return true;
+}
+
+} // anonymous namespace
+
+google::protobuf::ArenaOptions
+CredentialsData::MakeArenaOptions (char* block)
+{
+  google::protobuf::ArenaOptions res;
+  res.initial_block = block;
+  res.initial_block_size = ARENA_BLOCK_SIZE;
+  return res;
+}
+
+CredentialsData::CredentialsData ()
+  : arenaBlock(new char[ARENA_BLOCK_SIZE]),
+    arena(MakeArenaOptions (arenaBlock.get ()))
+{
+  data = google::protobuf::Arena::CreateMessage<AuthData> (&arena);
+}
+
+void
+CredentialsData::Reset ()
+{
+  /* Resetting the arena keeps the initial block, so that the next message
+     is allocated in the same memory again.  */
+  extra.clear ();
+  extraDirty = false;
+  arena.Reset ();
+  data = google::protobuf::Arena::CreateMessage<AuthData> (&arena);
+}
+
+CredentialsData::ExtraView
+CredentialsData::GetSortedExtra (const AuthData& data)
+{
+  ExtraView res;
+  res.reserve (data.extra_size ());
+  for (const auto& entry : data.extra ())
+    res.emplace_back (entry.first, entry.second);
+  std::sort (res.begin (), res.end ());
+  return res;
+}
+
+void
+CredentialsData::UpdateExtraView () const
+{
+  if (!extraDirty)
+    return;
+
+  extra.clear ();
+  for (const auto& entry : data->extra ())
+    extra.emplace_back (entry.first, entry.second);
+  std::sort (extra.begin (), extra.end ());
+  extraDirty = false;
+}
+
+bool
+CredentialsData::Parse (const std::string_view pwd)
+{
+  Reset ();
+
+  if (!DecodeBase64 (pwd, decoded))
+    return false;
+
+  if (!data->ParseFromArray (decoded.data (), decoded.size ()))
+    {
+      LOG (ERROR) << "Failed to parse AuthData from decoded password";
+      data->Clear ();
+      return false;
+    }
+
+  extraDirty = true;
+  return true;
+}
+
+std::string
+CredentialsData::ToPassword () const
+{
+  std::string rawData;
+  CHECK (data->SerializeToString (&rawData));
+
+  return EncodeBase64 (rawData);
+}
+
+bool
+CredentialsData::ValidateFormat (const std::string_view username,
+                                 const std::string_view application) const
+{
+  return ValidateFormat (username, application, GetExtra ());
+}
+
+bool
+CredentialsData::ValidateFormat (const std::string_view username,
+                                 const std::string_view application,
+                                 const ExtraView& extra)
+{
+  for (const auto c : username)
+    if (c == '\n')
+      {
+        LOG (ERROR) << "Invalid username (contains newline): " << username;
+        return false;
+      }
+
+  for (const auto c : application)
+    if (!IsAlphaNumeric (c) && c != '.' && c != '/')
+      {
+        LOG (ERROR) << "Invalid application name: " <<  application;
+        return false;
+      }
+
+  for (const auto& entry : extra)
+    {
+      if (!IsAlphaNumericOrDot (entry.first))
+        {
+          LOG (ERROR) << "Invalid extra key: " << entry.first;
+          return false;
+        }
+      if (!IsAlphaNumericOrDot (entry.second))
+        {
+          LOG (ERROR) << "Invalid extra value: " << entry.second;
+          return false;
+        }
+    }
+
+  return true;
+}
+
+const std::string&
+CredentialsData::BuildAuthMessage (const std::string_view username,
+                                   const std::string_view application) const
+{
+  BuildAuthMessage (username, application, *data, GetExtra (), authMessage);
+  return authMessage;
+}
+
+void
+CredentialsData::BuildAuthMessage (const std::string_view username,
+                                   const std::string_view application,
+                                   const AuthData& data, const ExtraView& extra,
+                                   std::string& out)
+{
+  out.clear ();
+
+  out.append ("Xid login\n");
+  out.append (username);
+  out.push_back ('\n');
+  out.append ("at: ");
+  out.append (application);
+  out.push_back ('\n');
+
+  out.append ("expires: ");
+  if (data.has_expiry ())
+    {
+      const std::time_t expiry = TimeFromUnix (data.expiry ());
+      char buf[32];
+      const auto conv = std::to_chars (buf, buf + sizeof (buf), expiry);
+      CHECK (conv.ec == std::errc ());
+      out.append (buf, conv.ptr);
+      out.push_back ('\n');
+    }
+  else
+    out.append ("never\n");
+  out.append ("extra:\n");
+
+  for (const auto& entry : extra)
+    {
+      out.append (entry.first);
+      out.push_back ('=');
+      out.append (entry.second);
+      out.push_back ('\n');
+    }
+}
+
+void
+CredentialsData::AddExtra (const std::string& key, const std::string& value)
+{
+  CHECK_EQ (data->extra ().count (key), 0);
+  (*data->mutable_extra ())[key] = value;
+  extraDirty = true;
+}
+
+bool
+CredentialsData::IsExpired (const std::time_t at) const
+{
+  if (!data->has_expiry ())
+    return false;
+  return at > GetExpiry ();
+}
+
+std::time_t
+CredentialsData::GetExpiry () const
+{
+  return TimeFromUnix (data->expiry ());
+}
+
+void
+CredentialsData::SetExpiry (const std::time_t t)
+{
+  data->set_expiry (TimeToUnix (t));
+}
+
+std::string
+CredentialsData::GetSignature () const
+{
+  return EncodeBase64 (data->signature_bytes ());
+}
+
+bool
+CredentialsData::SetSignature (const std::string& sgn)
+{
+  return DecodeBase64 (sgn, *data->mutable_signature_bytes ());
+}
+
+} // namespace xid
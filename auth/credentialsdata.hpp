@@ -0,0 +1,209 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XIDAUTH_CREDENTIALSDATA_HPP
+#define XIDAUTH_CREDENTIALSDATA_HPP
+
+#include "auth.pb.h"
+
+#include <google/protobuf/arena.h>
+
+#include <ctime>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace xid
+{
+
+/**
+ * The authentication data of a password, held in a protocol buffer arena.
+ * This is the low-level, high-throughput interface for parsing passwords:
+ * A single instance can be used to parse many passwords one after the other,
+ * and reuses its buffers for the decoded password, the protocol buffer
+ * (through the arena) and the authentication message.  In the steady state,
+ * parsing and building the authentication message thus need (almost) no
+ * allocations.
+ *
+ * Extra data is exposed as string_view's into the protocol buffer, and the
+ * returned authentication message is a reference to the internal buffer.
+ * Both are only valid until the next call to Parse or a modification.
+ *
+ * Instances are not thread-safe; each thread needs its own.
+ */
+class CredentialsData
+{
+
+public:
+
+  /** Extra data as key/value views, sorted by key.  */
+  using ExtraView
+      = std::vector<std::pair<std::string_view, std::string_view>>;
+
+private:
+
+  /** Size of the arena block that is allocated once and reused.  */
+  static constexpr size_t ARENA_BLOCK_SIZE = 1'024;
+
+  /** The initial block of the arena.  */
+  std::unique_ptr<char[]> arenaBlock;
+
+  /** The arena holding the AuthData message.  */
+  google::protobuf::Arena arena;
+
+  /** The current data.  It is owned by the arena.  */
+  AuthData* data;
+
+  /** Buffer for the decoded password.  */
+  std::string decoded;
+
+  /**
+   * The extra data as sorted views into data.  It is rebuilt lazily
+   * after modifications (if extraDirty is set).
+   */
+  mutable ExtraView extra;
+
+  /** Set if the extra view needs to be rebuilt.  */
+  mutable bool extraDirty = false;
+
+  /** Buffer for the authentication message.  */
+  mutable std::string authMessage;
+
+  /**
+   * Constructs the options for our arena.
+   */
+  static google::protobuf::ArenaOptions MakeArenaOptions (char* block);
+
+  /**
+   * Clears the arena and creates a fresh, empty AuthData message.
+   */
+  void Reset ();
+
+  /**
+   * Rebuilds the extra view from the data if needed.
+   */
+  void UpdateExtraView () const;
+
+public:
+
+  CredentialsData ();
+
+  CredentialsData (const CredentialsData&) = delete;
+  void operator= (const CredentialsData&) = delete;
+
+  /**
+   * Parses a password, replacing the current data.  Returns false if
+   * parsing fails (in which case the data is empty).  The data itself is
+   * not validated.
+   */
+  bool Parse (std::string_view pwd);
+
+  /**
+   * Encodes the current data as password string.  This does not check
+   * the format of the data.
+   */
+  std::string ToPassword () const;
+
+  /**
+   * Validates the data together with the given username and application.
+   * See Credentials::ValidateFormat for details.
+   */
+  bool ValidateFormat (std::string_view username,
+                       std::string_view application) const;
+
+  /**
+   * Validates username, application and the given extra data.  This is
+   * the implementation of ValidateFormat, which is shared with Credentials.
+   */
+  static bool ValidateFormat (std::string_view username,
+                              std::string_view application,
+                              const ExtraView& extra);
+
+  /**
+   * Builds the authentication message for the given username and application
+   * into the internal buffer and returns it.  The data must be valid
+   * (which is not checked again here).
+   */
+  const std::string& BuildAuthMessage (std::string_view username,
+                                       std::string_view application) const;
+
+  /**
+   * Builds the authentication message for the given data (with its
+   * extra entries sorted in the view) into out.  This is the implementation
+   * of BuildAuthMessage, which is shared with Credentials.
+   */
+  static void BuildAuthMessage (std::string_view username,
+                                std::string_view application,
+                                const AuthData& data, const ExtraView& extra,
+                                std::string& out);
+
+  /**
+   * Returns the extra entries of the given data as sorted views.
+   */
+  static ExtraView GetSortedExtra (const AuthData& data);
+
+  /**
+   * Returns the underlying protocol buffer.
+   */
+  const AuthData&
+  GetData () const
+  {
+    return *data;
+  }
+
+  /**
+   * Returns the extra data, sorted by key.
+   */
+  const ExtraView&
+  GetExtra () const
+  {
+    UpdateExtraView ();
+    return extra;
+  }
+
+  /**
+   * Adds an extra key/value pair.  The key must not exist yet.
+   */
+  void AddExtra (const std::string& key, const std::string& value);
+
+  /**
+   * Returns true if the credentials are expired at the given time.
+   */
+  bool IsExpired (std::time_t at) const;
+
+  std::time_t GetExpiry () const;
+  void SetExpiry (std::time_t t);
+
+  /**
+   * Returns the signature encoded as base64.
+   */
+  std::string GetSignature () const;
+
+  /**
+   * Sets the raw signature bytes.  Returns false if sgn is not
+   * valid base64.
+   */
+  bool SetSignature (const std::string& sgn);
+
+  Protocol
+  GetProtocol () const
+  {
+    if (data->has_protocol ())
+      return data->protocol ();
+    return Protocol::XID_GSP;
+  }
+
+  void
+  SetProtocol (const Protocol p)
+  {
+    data->set_protocol (p);
+  }
+
+};
+
+} // namespace xid
+
+#endif // XIDAUTH_CREDENTIALSDATA_HPP
@@ -0,0 +1,145 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "credentialsdata.hpp"
+
+#include "credentials.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+class CredentialsDataTests : public testing::Test
+{
+
+protected:
+
+  CredentialsData data;
+
+  /**
+   * Constructs a password with the given expiry and extra data.
+   */
+  static std::string
+  MakePassword (const std::time_t expiry,
+                const Credentials::ExtraMap& extra)
+  {
+    Credentials c("domob", "app");
+    c.SetSignature (xaya::EncodeBase64 ("signature"));
+    c.SetExpiry (expiry);
+    for (const auto& entry : extra)
+      c.AddExtra (entry.first, entry.second);
+    return c.ToPassword ();
+  }
+
+};
+
+TEST_F (CredentialsDataTests, ParseMultiple)
+{
+  ASSERT_TRUE (data.Parse (MakePassword (1234, {
+    {"foo", "bar"},
+    {"abc", "def"},
+  })));
+  EXPECT_EQ (data.GetSignature (), xaya::EncodeBase64 ("signature"));
+  EXPECT_EQ (data.GetExpiry (), 1234);
+  EXPECT_EQ (data.GetExtra (), CredentialsData::ExtraView ({
+    {"abc", "def"},
+    {"foo", "bar"},
+  }));
+
+  ASSERT_TRUE (data.Parse (MakePassword (42, {{"x", "y"}})));
+  EXPECT_EQ (data.GetExpiry (), 42);
+  EXPECT_EQ (data.GetExtra (), CredentialsData::ExtraView ({{"x", "y"}}));
+}
+
+TEST_F (CredentialsDataTests, FailedParseClears)
+{
+  ASSERT_TRUE (data.Parse (MakePassword (1234, {{"foo", "bar"}})));
+
+  EXPECT_FALSE (data.Parse ("invalid base64"));
+  EXPECT_FALSE (data.GetData ().has_expiry ());
+  EXPECT_TRUE (data.GetExtra ().empty ());
+
+  ASSERT_TRUE (data.Parse (MakePassword (1234, {{"foo", "bar"}})));
+  EXPECT_FALSE (data.Parse (xaya::EncodeBase64 ("\xFF")));
+  EXPECT_FALSE (data.GetData ().has_expiry ());
+  EXPECT_TRUE (data.GetExtra ().empty ());
+}
+
+TEST_F (CredentialsDataTests, AddExtra)
+{
+  ASSERT_TRUE (data.Parse (MakePassword (1234, {{"foo", "bar"}})));
+  EXPECT_EQ (data.GetExtra (), CredentialsData::ExtraView ({{"foo", "bar"}}));
+
+  data.AddExtra ("zzz", "1");
+  data.AddExtra ("abc", "2");
+  data.AddExtra ("def", "3");
+  EXPECT_EQ (data.GetExtra (), CredentialsData::ExtraView ({
+    {"abc", "2"},
+    {"def", "3"},
+    {"foo", "bar"},
+    {"zzz", "1"},
+  }));
+  EXPECT_EQ (data.BuildAuthMessage ("domob", "app"),
+u8R"(Xid login
+domob
+at: app
+expires: 1234
+extra:
+abc=2
+def=3
+foo=bar
+zzz=1
+)");
+}
+
+TEST_F (CredentialsDataTests, ValidateFormat)
+{
+  ASSERT_TRUE (data.Parse (MakePassword (1234, {{"foo", "bar"}})));
+  EXPECT_TRUE (data.ValidateFormat ("domob", "app"));
+  EXPECT_FALSE (data.ValidateFormat ("do\nmob", "app"));
+  EXPECT_FALSE (data.ValidateFormat ("domob", "a p p"));
+
+  data.AddExtra ("invalid key", "value");
+  EXPECT_FALSE (data.ValidateFormat ("domob", "app"));
+}
+
+TEST_F (CredentialsDataTests, AuthMessage)
+{
+  const auto pwd = MakePassword (1234, {
+    {"foo", "bar"},
+    {"abc", "def"},
+  });
+
+  Credentials c("domob", "app");
+  ASSERT_TRUE (c.FromPassword (pwd));
+
+  ASSERT_TRUE (data.Parse (pwd));
+  EXPECT_EQ (data.BuildAuthMessage ("domob", "app"), c.GetAuthMessage ());
+
+  ASSERT_TRUE (data.Parse (MakePassword (42, {})));
+  EXPECT_EQ (data.BuildAuthMessage ("other", "app"),
+u8R"(Xid login
+other
+at: app
+expires: 42
+extra:
+)");
+}
+
+TEST_F (CredentialsDataTests, ToPassword)
+{
+  const auto pwd = MakePassword (1234, {{"foo", "bar"}});
+  ASSERT_TRUE (data.Parse (pwd));
+  EXPECT_EQ (data.ToPassword (), pwd);
+}
+
+} // anonymous namespace
+} // namespace xid
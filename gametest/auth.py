@@ -52,6 +52,7 @@ class AuthTest (XidTest):
     self.testAuthDataValidation ()
     self.testPasswordErrors ()
     self.testVerification ()
+    self.testVerificationBatch ()
 
   def testGetAuthMessage (self):
     self.mainLogger.info ("Testing getauthmessage...")
@@ -300,5 +301,49 @@ class AuthTest (XidTest):
     })
 
 
+  def testVerificationBatch (self):
+    self.mainLogger.info ("Testing batch verification...")
+
+    entries = [
+      {
+        "name": "domob",
+        "application": "app",
+        "password": self.createPassword ("domob", "app", self.addrGeneral),
+      },
+      {
+        "name": "domob",
+        "application": "other",
+        "password": self.createPassword ("domob", "other", self.addrApp),
+      },
+      {
+        "name": "domob",
+        "application": "app",
+        "password": "invalid base64",
+      },
+      {
+        "name": "",
+        "application": "app",
+        "password": self.createPassword ("", "app", self.addrGeneral,
+                                         expiry=42),
+      },
+    ]
+    entries = entries * 10
+
+    res = self.getRpc ("verifyauthbatch", credentials=entries)
+    self.assertEqual (len (res), len (entries))
+    for e, r in zip (entries, res):
+      self.assertEqual (r, self.getRpc ("verifyauth", **e))
+    self.assertEqual ([r["state"] for r in res[:4]],
+                      ["valid", "invalid-signature", "malformed", "expired"])
+
+    self.assertEqual (self.getRpc ("verifyauthbatch", credentials=[]), [])
+
+    for invalid in [[{"name": "domob"}],
+                    [{"name": "domob", "application": "app", "password": 42}],
+                    entries[:1] * 1001]:
+      self.expectError (-1, ".*credentials must be an array.*",
+                        self.rpc.game.verifyauthbatch, credentials=invalid)
+
+
 if __name__ == "__main__":
   AuthTest ().main ()
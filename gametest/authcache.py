@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 The Xaya developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+"""
+Tests verifyauth with the cache for verification results enabled.
+"""
+
+from xidtest import XidTest
+
+import time
+
+
+class AuthCacheTest (XidTest):
+
+  def verifyAuth (self, name, app, pwd):
+    return self.getRpc ("verifyauth", name=name, application=app, password=pwd)
+
+  def run (self):
+    self.generate (101)
+
+    addr = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [addr]}})
+    self.generate (1)
+
+    for signerIndex in ["off", "on"]:
+      self.mainLogger.info ("Testing with signer index %s..." % signerIndex)
+      self.stopGameDaemon ()
+      self.startGameDaemon (extraArgs=[
+        "--auth_cache_size=100",
+        "--signer_index=%s" % signerIndex,
+      ])
+      self.syncGame ()
+      self.testCache (addr)
+
+  def testCache (self, addr):
+    """
+    Runs the tests with a freshly started daemon.  The signers of "domob"
+    are just addr before and after.
+    """
+
+    self.mainLogger.info ("Repeated verification...")
+    pwd = self.createPassword ("domob", "app", addr)
+    expected = {
+      "valid": True,
+      "state": "valid",
+      "expiry": None,
+      "extra": {},
+    }
+    for _ in range (3):
+      self.assertEqual (self.verifyAuth ("domob", "app", pwd), expected)
+    self.assertEqual (self.verifyAuth ("domob", "other", pwd)["state"],
+                      "invalid-signature")
+    self.assertEqual (self.verifyAuth ("domob", "app", "x" + pwd)["state"],
+                      "malformed")
+
+    self.mainLogger.info ("Expiry is checked on every call...")
+    expiry = int (time.time ()) + 3
+    limited = self.createPassword ("domob", "app", addr, expiry=expiry)
+    self.assertEqual (self.verifyAuth ("domob", "app", limited)["state"],
+                      "valid")
+    time.sleep (5)
+    self.assertEqual (self.verifyAuth ("domob", "app", limited), {
+      "valid": False,
+      "state": "expired",
+      "expiry": expiry,
+      "extra": {},
+    })
+    res = self.rpc.game.verifyauthbatch (credentials=[
+      {"name": "domob", "application": "app", "password": p}
+      for p in [pwd, limited]
+    ])["data"]
+    self.assertEqual ([r["state"] for r in res], ["valid", "expired"])
+
+    self.mainLogger.info ("Address updates keep the result...")
+    self.sendMove ("domob", {"ca": {"btc": "1domob"}})
+    self.generate (1)
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd), expected)
+
+    self.mainLogger.info ("Signer changes invalidate the result...")
+    newAddr = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [newAddr]}})
+    self.generate (1)
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd)["state"],
+                      "invalid-signature")
+    newPwd = self.createPassword ("domob", "app", newAddr)
+    res = self.rpc.game.verifyauthbatch (credentials=[
+      {"name": "domob", "application": "app", "password": p}
+      for p in [pwd, newPwd, newPwd]
+    ])["data"]
+    self.assertEqual ([r["state"] for r in res],
+                      ["invalid-signature", "valid", "valid"])
+
+    self.sendMove ("domob", {"s": {"g": [addr]}})
+    self.generate (1)
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd), expected)
+
+
+if __name__ == "__main__":
+  AuthCacheTest ().main ()
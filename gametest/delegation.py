@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 The Xaya developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+"""
+Tests verifyauth for credentials with the delegation-contract protocol,
+verified against the contracts on the test EVM chain.
+"""
+
+from xidauth.credentials import Credentials, Protocol
+from xidauth.delegation import Encoder, Verifier
+
+from xidtest import XidTest
+
+import time
+
+
+class DelegationTest (XidTest):
+
+  def verifyAuth (self, cred):
+    return self.getRpc ("verifyauth", name=cred.name, application=cred.app,
+                        password=cred.password)
+
+  def register (self, name, owner):
+    sender = self.env.contracts.account
+    self.env.register ("p", name, addr=sender)
+    self.generate (1)
+
+    tokenId = self.contracts.registry.functions \
+        .tokenIdForName ("p", name).call ()
+    self.contracts.registry.functions \
+        .transferFrom (sender, owner, tokenId) \
+        .transact ({"from": sender})
+    self.generate (1)
+
+  def createCredentials (self, name, app, signer, expiry=None):
+    cred = Credentials (name, app)
+    cred.protocol = Protocol.DELEGATION_CONTRACT
+    if expiry is not None:
+      cred.expiry = expiry
+
+    msg = self.encoder.encodeCredentials (cred)
+    acc = self.env.lookupSignerAccount (signer)
+    cred.raw_signature = acc.sign_message (msg).signature
+
+    return cred
+
+  def run (self):
+    self.generate (101)
+
+    abi = Verifier.loadAbi ("XayaDelegation")
+    self.contracts.delegation = self.env.evm.deployContract (
+        self.env.contracts.account, abi,
+        self.contracts.registry.address, "0x" + "00" * 20)
+    self.generate (1)
+    self.encoder = Encoder (self.env.evm.w3.eth.chain_id,
+                            self.contracts.delegation.address)
+
+    owner = self.env.createSignerAddress ()
+    other = self.env.createSignerAddress ()
+    self.register ("domob", owner)
+
+    self.mainLogger.info ("Delegation credentials are unsupported by default...")
+    cred = self.createCredentials ("domob", "app", owner)
+    self.assertEqual (self.verifyAuth (cred)["state"], "unsupported-protocol")
+
+    self.mainLogger.info ("Enabling delegation-contract verification...")
+    self.stopGameDaemon ()
+    self.startGameDaemon (extraArgs=[
+      "--delegation_rpc_url=%s" % self.env.evm.w3.provider.endpoint_uri,
+      "--delegation_contract=%s" % self.contracts.delegation.address,
+      "--session_lifetime=3600",
+      "--auth_cache_size=100",
+    ])
+    self.syncGame ()
+
+    self.assertEqual (self.verifyAuth (cred), {
+      "valid": True,
+      "state": "valid",
+      "expiry": None,
+      "extra": {},
+    })
+
+    wrongApp = self.createCredentials ("domob", "app", owner)
+    wrongApp.app = "other"
+    self.assertEqual (self.verifyAuth (wrongApp)["state"], "invalid-signature")
+    self.assertEqual (
+        self.verifyAuth (self.createCredentials ("domob", "app", other))
+            ["state"],
+        "invalid-signature")
+    self.assertEqual (
+        self.verifyAuth (self.createCredentials ("andy", "app", owner))
+            ["state"],
+        "invalid-signature")
+
+    expired = self.createCredentials ("domob", "app", owner, expiry=123)
+    self.assertEqual (self.verifyAuth (expired), {
+      "valid": False,
+      "state": "expired",
+      "expiry": 123,
+      "extra": {},
+    })
+
+    self.mainLogger.info ("Granting permission to another address...")
+    self.env.evm.w3.eth.send_transaction ({
+      "from": self.env.contracts.account,
+      "to": owner,
+      "value": 10**18,
+    })
+    self.generate (1)
+    tx = self.contracts.delegation.functions \
+        .grant ("p", "domob", ["g", "id", "xidauth", "app"],
+                other, 2**256 - 1, False) \
+        .build_transaction ({
+          "from": owner,
+          "gas": 1_000_000,
+          "nonce": self.env.evm.w3.eth.get_transaction_count (owner),
+        })
+    signed = self.env.lookupSignerAccount (owner).sign_transaction (tx)
+    self.env.evm.w3.eth.send_raw_transaction (signed.raw_transaction)
+    self.generate (1)
+
+    # The block number is refreshed at most once per second.
+    time.sleep (2)
+    delegated = self.createCredentials ("domob", "app", other)
+    self.assertEqual (self.verifyAuth (delegated)["state"], "valid")
+
+    self.mainLogger.info ("Batch verification...")
+    gsp = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [gsp]}})
+    self.generate (1)
+    batch = [
+      {"name": c.name, "application": c.app, "password": c.password}
+      for c in [cred, delegated, wrongApp]
+    ]
+    batch.append ({
+      "name": "domob",
+      "application": "app",
+      "password": self.createPassword ("domob", "app", gsp),
+    })
+    res = self.rpc.game.verifyauthbatch (credentials=batch)["data"]
+    self.assertEqual ([r["state"] for r in res],
+                      ["valid", "valid", "invalid-signature", "valid"])
+
+    # Only the result from the game state gets a session token.
+    assert "session" not in res[0]
+    assert "session" not in res[1]
+    assert "session" in res[3]
+
+
+if __name__ == "__main__":
+  DelegationTest ().main ()
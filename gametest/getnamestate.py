@@ -1,13 +1,13 @@
 #!/usr/bin/env python3
 
-# Copyright (C) 2019-2021 The Xaya developers
+# Copyright (C) 2019-2026 The Xaya developers
 # Distributed under the MIT software license, see the accompanying
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 from xidtest import XidTest
 
 """
-Tests the getnamestate RPC method.
+Tests the getnamestate and getnamestates RPC methods.
 """
 
 
@@ -34,6 +34,17 @@ class GetNameStateTest (XidTest):
       "addresses": {},
     })
 
+    self.mainLogger.info ("Testing batch lookup...")
+    names = ["foo", "domob", "", "foo"]
+    self.assertEqual (self.getRpc ("getnamestates", names=names), [
+      self.getRpc ("getnamestate", name=n) for n in names
+    ])
+    self.assertEqual (self.getRpc ("getnamestates", names=[]), [])
+    self.expectError (-1, ".*array of at most.*",
+                      self.rpc.game.getnamestates, names=["foo", 42])
+    self.expectError (-1, ".*array of at most.*",
+                      self.rpc.game.getnamestates, names=["foo"] * 501)
+
 
 if __name__ == "__main__":
   GetNameStateTest ().main ()
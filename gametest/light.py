@@ -1,7 +1,7 @@
 #!/usr/bin/env python3
 # coding=utf8
 
-# Copyright (C) 2020-2025 The Xaya developers
+# Copyright (C) 2020-2026 The Xaya developers
 # Distributed under the MIT software license, see the accompanying
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -164,6 +164,17 @@ class LightModeTest (XidTest):
       for name in ["domob", "foo/bar", "", "abc def", u"kräfti"]:
         self.assertEqual (l.rpc.getnamestate (name=name),
                           self.rpc.game.getnamestate (name=name))
+      names = ["domob", "foo/bar", "", "abc def", u"kräfti", "domob"]
+      self.assertEqual (l.rpc.getnamestates (names=names),
+                        self.rpc.game.getnamestates (names=names))
+
+      # Long batches are split into multiple REST requests.
+      names = ["domob", ""] + [u"kräfti %03d %s" % (i, "x" * 200)
+                               for i in range (100)] + ["domob"]
+      self.assertEqual (l.rpc.getnamestates (names=names),
+                        self.rpc.game.getnamestates (names=names))
+      self.expectError (-1, ".*array of at most.*",
+                        l.rpc.getnamestates, names=[42])
 
       authmsg = l.rpc.getauthmessage (name="domob", application="app", data={})
       sgn = self.env.signMessage (addr, authmsg["authmessage"])
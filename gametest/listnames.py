@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 The Xaya developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+from xidtest import XidTest
+
+"""
+Tests the listnames RPC method.
+"""
+
+
+class ListNamesTest (XidTest):
+
+  def run (self):
+    self.generate (101)
+
+    addr = self.env.createSignerAddress ()
+    names = ["abc", "domob", "foo", "xyz", "zzz"]
+    for n in names:
+      self.sendMove (n, {"s": {"g": [addr]}})
+    self.sendMove ("bar", {"ca": {"btc": "1bar"}})
+    self.generate (1)
+    names = sorted (names + ["bar"])
+
+    self.mainLogger.info ("Listing all names in one page...")
+    res = self.getRpc ("listnames", count=100, cursor="")
+    self.assertEqual (res["next"], None)
+    self.assertEqual ([e["name"] for e in res["names"]], names)
+    for e in res["names"]:
+      self.assertEqual (e, self.getRpc ("getnamestate", name=e["name"]))
+
+    self.mainLogger.info ("Paging through the names...")
+    found = []
+    cursor = ""
+    while True:
+      res = self.getRpc ("listnames", count=4, cursor=cursor)
+      found.extend ([e["name"] for e in res["names"]])
+      if res["next"] is None:
+        break
+      cursor = res["next"]
+    self.assertEqual (found, names)
+
+    self.mainLogger.info ("Testing error cases...")
+    self.expectError (-1, "count must be between 1 and 1000",
+                      self.rpc.game.listnames, count=0, cursor="")
+    self.expectError (-1, "count must be between 1 and 1000",
+                      self.rpc.game.listnames, count=1001, cursor="")
+    self.expectError (-1, "invalid cursor",
+                      self.rpc.game.listnames, count=1, cursor="x")
+
+
+if __name__ == "__main__":
+  ListNamesTest ().main ()
@@ -0,0 +1,66 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 The Xaya developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+from xidtest import XidTest
+
+"""
+Tests the lookupsigner and lookupaddress RPC methods.
+"""
+
+
+class LookupTest (XidTest):
+
+  def run (self):
+    self.generate (101)
+
+    addr = self.env.createSignerAddress ()
+    other = self.env.createSignerAddress ()
+
+    self.sendMove ("foo", {
+      "s": {"g": [addr], "a": {"app": [addr]}},
+      "ca": {"btc": "1abc", "eth": "0xabc"},
+    })
+    self.sendMove ("bar", {
+      "s": {"a": {"app": [addr, other]}},
+      "ca": {"btc": "1abc"},
+    })
+    self.sendMove ("baz", {"s": {"g": [other]}})
+    self.generate (1)
+
+    self.mainLogger.info ("Looking up signers...")
+    self.assertEqual (self.getRpc ("lookupsigner", address=addr), [
+      {"name": "bar", "application": "app"},
+      {"name": "foo"},
+      {"name": "foo", "application": "app"},
+    ])
+    self.assertEqual (self.getRpc ("lookupsigner", address=other), [
+      {"name": "bar", "application": "app"},
+      {"name": "baz"},
+    ])
+    self.assertEqual (self.getRpc ("lookupsigner", address="invalid"), [])
+
+    self.mainLogger.info ("Looking up crypto addresses...")
+    self.assertEqual (self.getRpc ("lookupaddress", key="btc", address="1abc"),
+                      ["bar", "foo"])
+    self.assertEqual (self.getRpc ("lookupaddress",
+                                   key="eth", address="0xabc"),
+                      ["foo"])
+    self.assertEqual (self.getRpc ("lookupaddress", key="eth", address="1abc"),
+                      [])
+
+    self.mainLogger.info ("Removing entries...")
+    self.sendMove ("foo", {"s": {"g": []}, "ca": {"btc": None}})
+    self.generate (1)
+    self.assertEqual (self.getRpc ("lookupsigner", address=addr), [
+      {"name": "bar", "application": "app"},
+      {"name": "foo", "application": "app"},
+    ])
+    self.assertEqual (self.getRpc ("lookupaddress", key="btc", address="1abc"),
+                      ["bar"])
+
+
+if __name__ == "__main__":
+  LookupTest ().main ()
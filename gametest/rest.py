@@ -1,7 +1,7 @@
 #!/usr/bin/env python3
 # coding=utf8
 
-# Copyright (C) 2019-2022 The Xaya developers
+# Copyright (C) 2019-2026 The Xaya developers
 # Distributed under the MIT software license, see the accompanying
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -43,7 +43,8 @@ class GetNameStateTest (XidTest):
     self.stopGameDaemon ()
     self.restPort = next (self.ports)
     self.log.info ("Using port %d for the REST API" % self.restPort)
-    self.startGameDaemon (extraArgs=["--rest_port=%d" % self.restPort])
+    self.startGameDaemon (extraArgs=["--rest_port=%d" % self.restPort,
+                                     "--rest_full_state"])
 
     self.mainLogger.info ("Testing error cases...")
     self.expectError (405, "/state", data=b"POST data")
@@ -58,6 +59,16 @@ class GetNameStateTest (XidTest):
     res = json.loads (resp.read ())
     self.assertEqual (res, self.rpc.game.getnullstate ())
 
+    self.mainLogger.info ("Testing /fullstate...")
+    resp = urllib.request.urlopen ("http://localhost:%d/fullstate"
+                                      % self.restPort)
+    self.assertEqual (resp.getcode (), 200)
+    res = json.loads (resp.read ())
+    self.assertEqual (res, self.rpc.game.getcurrentstate ())
+    self.assertEqual (res["gamestate"]["names"]["domob"]["signers"], [
+      {"addresses": [addr]},
+    ])
+
     self.mainLogger.info ("Testing /healthz...")
     resp = urllib.request.urlopen ("http://localhost:%d/healthz"
                                       % self.restPort)
@@ -75,6 +86,28 @@ class GetNameStateTest (XidTest):
       self.assertEqual (res["data"]["name"], name)
       self.assertEqual (res, self.rpc.game.getnamestate (name=name))
 
+    self.mainLogger.info ("Testing batch name retrieval...")
+    names = ["domob", "foo/bar", "", "abc def", u"kräfti"]
+    encoded = urllib.parse.quote (json.dumps (names))
+    url = "http://localhost:%d/names/%s" % (self.restPort, encoded)
+    resp = urllib.request.urlopen (url)
+    self.assertEqual (resp.getcode (), 200)
+    res = json.loads (resp.read ())
+    self.assertEqual (res, self.rpc.game.getnamestates (names=names))
+    self.expectError (400, "/names/invalid")
+    self.expectError (400, "/names/%s" % urllib.parse.quote ('{"a": 1}'))
+
+    self.mainLogger.info ("Testing name listing...")
+    self.expectError (400, "/listnames/0")
+    self.expectError (400, "/listnames/abc")
+    self.expectError (400, "/listnames/10/invalid")
+    url = "http://localhost:%d/listnames/10" % self.restPort
+    resp = urllib.request.urlopen (url)
+    self.assertEqual (resp.getcode (), 200)
+    res = json.loads (resp.read ())
+    self.assertEqual (res, self.rpc.game.listnames (count=10, cursor=""))
+    self.assertEqual ([e["name"] for e in res["data"]["names"]], ["domob"])
+
 
 if __name__ == "__main__":
   GetNameStateTest ().main ()
@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 The Xaya developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+"""
+Tests session tokens issued by verifyauth and checked by verifysession.
+"""
+
+from xidtest import XidTest
+
+
+class SessionsTest (XidTest):
+
+  def verifyAuth (self, name, app, pwd):
+    return self.getRpc ("verifyauth", name=name, application=app, password=pwd)
+
+  def verifySession (self, name, app, token):
+    return self.rpc.game.verifysession (name=name, application=app,
+                                        token=token)
+
+  def run (self):
+    self.generate (101)
+
+    addr = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [addr]}})
+    self.generate (1)
+
+    self.mainLogger.info ("Sessions are disabled by default...")
+    pwd = self.createPassword ("domob", "app", addr)
+    res = self.verifyAuth ("domob", "app", pwd)
+    self.assertEqual (res["state"], "valid")
+    assert "session" not in res
+    self.expectError (-5, ".*not enabled.*", self.verifySession,
+                      "domob", "app", "")
+
+    self.mainLogger.info ("Enabling session tokens...")
+    self.stopGameDaemon ()
+    self.startGameDaemon (extraArgs=["--session_lifetime=3600"])
+    self.syncGame ()
+
+    res = self.verifyAuth ("domob", "app", pwd)
+    self.assertEqual (res["state"], "valid")
+    token = res["session"]["token"]
+    expiry = res["session"]["expiry"]
+    self.assertEqual (self.verifySession ("domob", "app", token), {
+      "valid": True,
+      "state": "valid",
+      "expiry": expiry,
+    })
+
+    self.mainLogger.info ("Session expiry is capped by the credentials...")
+    limited = self.createPassword ("domob", "app", addr, expiry=expiry - 10)
+    res = self.verifyAuth ("domob", "app", limited)
+    self.assertEqual (res["session"]["expiry"], expiry - 10)
+
+    self.mainLogger.info ("Invalid tokens...")
+    self.assertEqual (self.verifySession ("domob", "app", "invalid base64"), {
+      "valid": False,
+      "state": "malformed",
+    })
+    for name, app in [("domob", "other"), ("other", "app")]:
+      self.assertEqual (self.verifySession (name, app, token), {
+        "valid": False,
+        "state": "invalid",
+      })
+
+    self.mainLogger.info ("Address updates do not invalidate sessions...")
+    self.sendMove ("domob", {"ca": {"btc": "1domob"}})
+    self.generate (1)
+    self.assertEqual (self.verifySession ("domob", "app", token)["state"],
+                      "valid")
+
+    self.mainLogger.info ("Signer changes invalidate sessions...")
+    newAddr = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [newAddr]}})
+    self.generate (1)
+    self.assertEqual (self.verifySession ("domob", "app", token), {
+      "valid": False,
+      "state": "outdated",
+      "expiry": expiry,
+    })
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd)["state"],
+                      "invalid-signature")
+
+    pwd = self.createPassword ("domob", "app", newAddr)
+    res = self.verifyAuth ("domob", "app", pwd)
+    self.assertEqual (res["state"], "valid")
+    self.assertEqual (
+        self.verifySession ("domob", "app", res["session"]["token"])["state"],
+        "valid")
+
+    self.mainLogger.info ("Restarting invalidates sessions...")
+    token = res["session"]["token"]
+    self.stopGameDaemon ()
+    self.startGameDaemon (extraArgs=["--session_lifetime=3600"])
+    self.syncGame ()
+    self.assertEqual (self.verifySession ("domob", "app", token), {
+      "valid": False,
+      "state": "invalid",
+    })
+
+
+if __name__ == "__main__":
+  SessionsTest ().main ()
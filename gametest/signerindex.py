@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2026 The Xaya developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+"""
+Tests verifyauth with the in-memory signer index enabled.
+"""
+
+from xidtest import XidTest
+
+
+class SignerIndexTest (XidTest):
+
+  def verifyAuth (self, name, app, pwd):
+    return self.getRpc ("verifyauth", name=name, application=app, password=pwd)
+
+  def run (self):
+    self.generate (101)
+
+    addr = self.env.createSignerAddress ()
+    appAddr = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [addr]}})
+    self.sendMove ("andy", {"s": {"app": [appAddr]}})
+    self.generate (1)
+
+    self.stopGameDaemon ()
+    self.startGameDaemon (extraArgs=["--signer_index=on"])
+    self.syncGame ()
+
+    pwd = self.createPassword ("domob", "app", addr)
+    appPwd = self.createPassword ("andy", "app", appAddr)
+    otherPwd = self.createPassword ("andy", "other", appAddr)
+    expected = {
+      "valid": True,
+      "state": "valid",
+      "expiry": None,
+      "extra": {},
+    }
+
+    self.mainLogger.info ("Verification with the index built at startup...")
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd), expected)
+    self.assertEqual (self.verifyAuth ("andy", "app", appPwd), expected)
+    res = self.rpc.game.verifyauth (name="domob", application="app",
+                                    password=pwd)
+    state = self.rpc.game.getnullstate ()
+    self.assertEqual (res["state"], "up-to-date")
+    self.assertEqual (res["blockhash"], state["blockhash"])
+    self.assertEqual (res["height"], state["height"])
+
+    self.mainLogger.info ("Verification with the updated index...")
+    self.generate (1)
+    for _ in range (3):
+      self.assertEqual (self.verifyAuth ("domob", "app", pwd), expected)
+    self.assertEqual (self.verifyAuth ("andy", "app", appPwd), expected)
+    self.assertEqual (self.verifyAuth ("andy", "other", otherPwd)["state"],
+                      "invalid-signature")
+    self.assertEqual (self.verifyAuth ("domob", "app", "x" + pwd)["state"],
+                      "malformed")
+
+    res = self.rpc.game.verifyauth (name="domob", application="app",
+                                    password=pwd)
+    self.assertEqual (res["blockhash"],
+                      self.rpc.game.getcurrentstate ()["blockhash"])
+    self.assertEqual (res["state"], "up-to-date")
+
+    res = self.rpc.game.verifyauthbatch (credentials=[
+      {"name": "domob", "application": "app", "password": pwd},
+      {"name": "andy", "application": "app", "password": appPwd},
+      {"name": "andy", "application": "other", "password": otherPwd},
+    ])["data"]
+    self.assertEqual ([r["state"] for r in res],
+                      ["valid", "valid", "invalid-signature"])
+
+    self.mainLogger.info ("Signer changes update the index...")
+    newAddr = self.env.createSignerAddress ()
+    self.sendMove ("domob", {"s": {"g": [newAddr]}})
+    self.sendMove ("andy", {"s": {"other": [appAddr]}})
+    self.generate (1)
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd)["state"],
+                      "invalid-signature")
+    self.assertEqual (
+        self.verifyAuth ("domob", "app",
+                         self.createPassword ("domob", "app", newAddr)),
+        expected)
+    self.assertEqual (self.verifyAuth ("andy", "app", appPwd), expected)
+    self.assertEqual (self.verifyAuth ("andy", "other", otherPwd), expected)
+
+    self.sendMove ("domob", {"s": {"g": []}})
+    self.generate (1)
+    self.assertEqual (
+        self.verifyAuth ("domob", "app",
+                         self.createPassword ("domob", "app", newAddr))
+            ["state"],
+        "invalid-signature")
+
+    self.mainLogger.info ("Cross-checking against the database...")
+    self.stopGameDaemon ()
+    self.startGameDaemon (extraArgs=["--signer_index=crosscheck"])
+    self.syncGame ()
+    self.generate (1)
+    self.assertEqual (self.verifyAuth ("andy", "app", appPwd), expected)
+    self.assertEqual (self.verifyAuth ("domob", "app", pwd)["state"],
+                      "invalid-signature")
+
+
+if __name__ == "__main__":
+  SignerIndexTest ().main ()
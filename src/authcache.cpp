@@ -0,0 +1,171 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "authcache.hpp"
+
+#include <openssl/evp.h>
+
+#include <glog/logging.h>
+
+namespace xid
+{
+
+namespace
+{
+
+/** After how many lookups the statistics are logged.  */
+constexpr uint64_t STATS_LOG_INTERVAL = 10'000;
+
+/**
+ * Logs the given cache statistics.
+ */
+void
+LogStats (const AuthCache::Stats& s)
+{
+  LOG (INFO)
+      << "Auth cache: " << s.size << " entries, "
+      << s.hits << " hits, " << s.misses << " misses, "
+      << s.outdated << " outdated, " << s.evictions << " evictions";
+}
+
+/**
+ * Appends a string with its length to the data, so that the concatenation
+ * of multiple strings is unambiguous.
+ */
+void
+AppendString (const std::string& str, std::string& out)
+{
+  const uint64_t len = str.size ();
+  for (int i = 7; i >= 0; --i)
+    out.push_back (static_cast<char> ((len >> (8 * i)) & 0xFF));
+  out.append (str);
+}
+
+} // anonymous namespace
+
+std::string
+AuthCache::MakeKey (const std::string& name, const std::string& app,
+                    const std::string& password)
+{
+  std::string res;
+  AppendString (name, res);
+  AppendString (app, res);
+
+  unsigned char hash[EVP_MAX_MD_SIZE];
+  unsigned hashLen;
+  CHECK_EQ (EVP_Digest (password.data (), password.size (), hash, &hashLen,
+                        EVP_sha256 (), nullptr),
+            1);
+  res.append (reinterpret_cast<const char*> (hash), hashLen);
+
+  return res;
+}
+
+AuthCache::AuthCache (const NameGenerations& g, const size_t s)
+  : generations(g), maxSize(s)
+{
+  index.reserve (maxSize);
+}
+
+AuthCache::~AuthCache ()
+{
+  LogStats (GetStats ());
+}
+
+bool
+AuthCache::Lookup (const std::string& name, const std::string& app,
+                   const std::string& password,
+                   Json::Value& result, uint64_t& generation)
+{
+  const std::string key = MakeKey (name, app, password);
+
+  std::lock_guard<std::mutex> lock(mut);
+
+  if ((stats.hits + stats.misses + stats.outdated + 1)
+        % STATS_LOG_INTERVAL == 0)
+    {
+      Stats s = stats;
+      s.size = entries.size ();
+      LogStats (s);
+    }
+
+  const auto mit = index.find (key);
+  if (mit == index.end ())
+    {
+      ++stats.misses;
+      return false;
+    }
+
+  /* The generation is read after finding the entry.  If it is still the
+     same as when the result was computed, then the signers of the name have
+     not changed since, not even in a block that is being processed.  */
+  const auto eit = mit->second;
+  if (eit->generation != generations.Get (name))
+    {
+      ++stats.outdated;
+      index.erase (mit);
+      entries.erase (eit);
+      return false;
+    }
+
+  ++stats.hits;
+  entries.splice (entries.begin (), entries, eit);
+  result = eit->result;
+  generation = eit->generation;
+
+  return true;
+}
+
+void
+AuthCache::Insert (const std::string& name, const std::string& app,
+                   const std::string& password, const uint64_t generation,
+                   const Json::Value& result)
+{
+  if (maxSize == 0)
+    return;
+
+  std::string key = MakeKey (name, app, password);
+
+  std::lock_guard<std::mutex> lock(mut);
+
+  const auto mit = index.find (key);
+  if (mit != index.end ())
+    {
+      /* Another thread may have inserted a result for the same credentials
+         concurrently.  Keep whichever was computed at the later
+         generation.  */
+      const auto eit = mit->second;
+      entries.splice (entries.begin (), entries, eit);
+      if (generation >= eit->generation)
+        {
+          eit->generation = generation;
+          eit->result = result;
+        }
+      return;
+    }
+
+  if (entries.size () >= maxSize)
+    {
+      index.erase (entries.back ().key);
+      entries.pop_back ();
+      ++stats.evictions;
+    }
+
+  entries.push_front (Entry {std::move (key), generation, result});
+  index.emplace (entries.front ().key, entries.begin ());
+  CHECK_EQ (entries.size (), index.size ());
+}
+
+AuthCache::Stats
+AuthCache::GetStats () const
+{
+  std::lock_guard<std::mutex> lock(mut);
+
+  Stats res = stats;
+  res.size = entries.size ();
+
+  return res;
+}
+
+} // namespace xid
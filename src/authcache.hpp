@@ -0,0 +1,146 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_AUTHCACHE_HPP
+#define XID_AUTHCACHE_HPP
+
+#include "namegenerations.hpp"
+
+#include <json/json.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xid
+{
+
+/**
+ * Bounded LRU cache for full verifyauth results, keyed by name, application
+ * and a hash of the password.  Each entry records the NameGenerations value
+ * of the name at the time the result was computed, and is dropped on lookup
+ * if the generation has changed since (i.e. the signers of the name may have
+ * been changed by a move or the undo of one).
+ *
+ * Lookups only take the cache's own lock and read the (atomic) generation
+ * counters, so they neither touch the database nor wait for block processing.
+ * The cached results are returned as they were inserted; anything that
+ * depends on the current time (like expiry) has to be re-evaluated by
+ * the caller.
+ *
+ * All methods are thread-safe.
+ */
+class AuthCache
+{
+
+public:
+
+  /** Statistics about the cache usage.  */
+  struct Stats
+  {
+
+    /** Number of lookups that found a current entry.  */
+    uint64_t hits = 0;
+
+    /** Number of lookups that did not find an entry.  */
+    uint64_t misses = 0;
+
+    /** Number of entries dropped because the name's generation changed.  */
+    uint64_t outdated = 0;
+
+    /** Number of entries removed to make room for new ones.  */
+    uint64_t evictions = 0;
+
+    /** Current number of entries.  */
+    size_t size = 0;
+
+  };
+
+private:
+
+  /** An entry in the LRU list.  */
+  struct Entry
+  {
+
+    /** The key (see MakeKey).  */
+    std::string key;
+
+    /** The generation of the name when the result was computed.  */
+    uint64_t generation;
+
+    /** The cached result.  */
+    Json::Value result;
+
+  };
+
+  /** The generations of names, against which entries are checked.  */
+  const NameGenerations& generations;
+
+  /** Maximum number of entries.  */
+  const size_t maxSize;
+
+  /** Lock for the cache state.  */
+  mutable std::mutex mut;
+
+  /** The entries, with the most recently used one at the front.  */
+  std::list<Entry> entries;
+
+  /** Index of the entries by key.  */
+  std::unordered_map<std::string, std::list<Entry>::iterator> index;
+
+  /** Usage statistics.  */
+  Stats stats;
+
+  /**
+   * Constructs the key for an entry.  This encodes name and application
+   * unambiguously, together with the SHA-256 hash of the password (so that
+   * long passwords do not bloat the cache).
+   */
+  static std::string MakeKey (const std::string& name, const std::string& app,
+                              const std::string& password);
+
+public:
+
+  /**
+   * Constructs an empty cache with the given maximum number of entries.
+   * If the size is zero, nothing is ever cached.
+   */
+  explicit AuthCache (const NameGenerations& g, size_t s);
+
+  ~AuthCache ();
+
+  AuthCache (const AuthCache&) = delete;
+  void operator= (const AuthCache&) = delete;
+
+  /**
+   * Looks up the result for the given credentials.  Returns true and sets
+   * result and the generation it was computed at (which is the current one)
+   * if a current entry is found.
+   */
+  bool Lookup (const std::string& name, const std::string& app,
+               const std::string& password,
+               Json::Value& result, uint64_t& generation);
+
+  /**
+   * Adds the result for the given credentials to the cache, evicting the
+   * least recently used entry if the cache is full.  generation must have
+   * been read before the state snapshot the result was computed from.
+   */
+  void Insert (const std::string& name, const std::string& app,
+               const std::string& password, uint64_t generation,
+               const Json::Value& result);
+
+  /**
+   * Returns the current usage statistics.
+   */
+  Stats GetStats () const;
+
+};
+
+} // namespace xid
+
+#endif // XID_AUTHCACHE_HPP
@@ -0,0 +1,137 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "authcache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <json/json.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+class AuthCacheTests : public testing::Test
+{
+
+protected:
+
+  NameGenerations generations;
+
+  Json::Value result;
+  uint64_t generation;
+
+  /**
+   * Inserts a result with the current generation of the name.
+   */
+  void
+  Insert (AuthCache& cache, const std::string& name, const std::string& app,
+          const std::string& password, const Json::Value& val)
+  {
+    cache.Insert (name, app, password, generations.Get (name), val);
+  }
+
+};
+
+TEST_F (AuthCacheTests, HitAndMiss)
+{
+  AuthCache cache(generations, 10);
+
+  EXPECT_FALSE (cache.Lookup ("domob", "app", "pwd", result, generation));
+  Insert (cache, "domob", "app", "pwd", "foo");
+  ASSERT_TRUE (cache.Lookup ("domob", "app", "pwd", result, generation));
+  EXPECT_EQ (result, "foo");
+  EXPECT_EQ (generation, generations.Get ("domob"));
+
+  EXPECT_FALSE (cache.Lookup ("other", "app", "pwd", result, generation));
+  EXPECT_FALSE (cache.Lookup ("domob", "other", "pwd", result, generation));
+  EXPECT_FALSE (cache.Lookup ("domob", "app", "other", result, generation));
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.hits, 1);
+  EXPECT_EQ (stats.misses, 4);
+  EXPECT_EQ (stats.outdated, 0);
+  EXPECT_EQ (stats.size, 1);
+}
+
+TEST_F (AuthCacheTests, KeyIsNotConcatenation)
+{
+  AuthCache cache(generations, 10);
+  Insert (cache, "ab", "c", "pwd", "foo");
+  EXPECT_FALSE (cache.Lookup ("a", "bc", "pwd", result, generation));
+}
+
+TEST_F (AuthCacheTests, NameChanged)
+{
+  AuthCache cache(generations, 10);
+  Insert (cache, "domob", "app", "pwd", "foo");
+
+  generations.Bump ("domob");
+  EXPECT_FALSE (cache.Lookup ("domob", "app", "pwd", result, generation));
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.outdated, 1);
+  EXPECT_EQ (stats.size, 0);
+
+  Insert (cache, "domob", "app", "pwd", "bar");
+  ASSERT_TRUE (cache.Lookup ("domob", "app", "pwd", result, generation));
+  EXPECT_EQ (result, "bar");
+}
+
+TEST_F (AuthCacheTests, InsertedWithOldGeneration)
+{
+  /* If the signers change while a result is computed, it is inserted
+     with the generation from before and thus never returned.  */
+  AuthCache cache(generations, 10);
+  const auto gen = generations.Get ("domob");
+  generations.Bump ("domob");
+  cache.Insert ("domob", "app", "pwd", gen, "foo");
+  EXPECT_FALSE (cache.Lookup ("domob", "app", "pwd", result, generation));
+}
+
+TEST_F (AuthCacheTests, ConcurrentInsertKeepsNewer)
+{
+  AuthCache cache(generations, 10);
+  const auto gen = generations.Get ("domob");
+  generations.Bump ("domob");
+
+  cache.Insert ("domob", "app", "pwd", gen + 1, "new");
+  cache.Insert ("domob", "app", "pwd", gen, "old");
+  ASSERT_TRUE (cache.Lookup ("domob", "app", "pwd", result, generation));
+  EXPECT_EQ (result, "new");
+}
+
+TEST_F (AuthCacheTests, LeastRecentlyUsedEvicted)
+{
+  AuthCache cache(generations, 2);
+
+  Insert (cache, "a", "app", "pwd", "a");
+  Insert (cache, "b", "app", "pwd", "b");
+  ASSERT_TRUE (cache.Lookup ("a", "app", "pwd", result, generation));
+  Insert (cache, "c", "app", "pwd", "c");
+
+  EXPECT_FALSE (cache.Lookup ("b", "app", "pwd", result, generation));
+  ASSERT_TRUE (cache.Lookup ("a", "app", "pwd", result, generation));
+  EXPECT_EQ (result, "a");
+  ASSERT_TRUE (cache.Lookup ("c", "app", "pwd", result, generation));
+  EXPECT_EQ (result, "c");
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.evictions, 1);
+  EXPECT_EQ (stats.size, 2);
+}
+
+TEST_F (AuthCacheTests, ZeroSize)
+{
+  AuthCache cache(generations, 0);
+  Insert (cache, "domob", "app", "pwd", "foo");
+  EXPECT_FALSE (cache.Lookup ("domob", "app", "pwd", result, generation));
+  EXPECT_EQ (cache.GetStats ().size, 0);
+}
+
+} // anonymous namespace
+} // namespace xid
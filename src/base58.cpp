@@ -0,0 +1,142 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base58.hpp"
+
+#include <openssl/evp.h>
+
+#include <glog/logging.h>
+
+#include <array>
+#include <vector>
+
+namespace xid
+{
+
+namespace
+{
+
+/** The base58 alphabet.  */
+const char* const ALPHABET
+    = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+/** Size of the checksum in bytes.  */
+constexpr size_t CHECKSUM_SIZE = 4;
+
+/**
+ * Computes the checksum (first bytes of the double SHA-256) of the
+ * given data.
+ */
+std::string
+Checksum (const std::string& data)
+{
+  std::array<unsigned char, 32> hash;
+  unsigned len;
+
+  CHECK_EQ (EVP_Digest (data.data (), data.size (), hash.data (), &len,
+                        EVP_sha256 (), nullptr), 1);
+  CHECK_EQ (len, hash.size ());
+  CHECK_EQ (EVP_Digest (hash.data (), hash.size (), hash.data (), &len,
+                        EVP_sha256 (), nullptr), 1);
+  CHECK_EQ (len, hash.size ());
+
+  return std::string (reinterpret_cast<const char*> (hash.data ()),
+                      CHECKSUM_SIZE);
+}
+
+/**
+ * Returns the value of a base58 character, or -1 if it is invalid.
+ */
+int
+DecodeBase58Char (const char c)
+{
+  static const std::array<int, 256> values = [] ()
+    {
+      std::array<int, 256> res;
+      res.fill (-1);
+      for (int i = 0; i < 58; ++i)
+        res[static_cast<unsigned char> (ALPHABET[i])] = i;
+      return res;
+    } ();
+
+  return values[static_cast<unsigned char> (c)];
+}
+
+} // anonymous namespace
+
+std::string
+EncodeBase58Check (const std::string& data)
+{
+  const std::string full = data + Checksum (data);
+
+  size_t zeros = 0;
+  while (zeros < full.size () && full[zeros] == '\0')
+    ++zeros;
+
+  /* Base-58 digits of the number, least significant first.  */
+  std::vector<unsigned char> digits;
+  digits.reserve (full.size () * 138 / 100 + 1);
+  for (size_t i = zeros; i < full.size (); ++i)
+    {
+      unsigned carry = static_cast<unsigned char> (full[i]);
+      for (auto& d : digits)
+        {
+          carry += static_cast<unsigned> (d) << 8;
+          d = carry % 58;
+          carry /= 58;
+        }
+      while (carry > 0)
+        {
+          digits.push_back (carry % 58);
+          carry /= 58;
+        }
+    }
+
+  std::string res(zeros, '1');
+  for (auto it = digits.rbegin (); it != digits.rend (); ++it)
+    res.push_back (ALPHABET[*it]);
+
+  return res;
+}
+
+bool
+DecodeBase58Check (const std::string& str, std::string& data)
+{
+  size_t zeros = 0;
+  while (zeros < str.size () && str[zeros] == '1')
+    ++zeros;
+
+  /* Bytes of the number, least significant first.  */
+  std::vector<unsigned char> bytes;
+  bytes.reserve (str.size () * 733 / 1000 + 1);
+  for (size_t i = zeros; i < str.size (); ++i)
+    {
+      const int val = DecodeBase58Char (str[i]);
+      if (val < 0)
+        return false;
+
+      unsigned carry = val;
+      for (auto& b : bytes)
+        {
+          carry += static_cast<unsigned> (b) * 58;
+          b = carry & 0xFF;
+          carry >>= 8;
+        }
+      while (carry > 0)
+        {
+          bytes.push_back (carry & 0xFF);
+          carry >>= 8;
+        }
+    }
+
+  std::string full(zeros, '\0');
+  full.append (bytes.rbegin (), bytes.rend ());
+  if (full.size () < CHECKSUM_SIZE)
+    return false;
+
+  data = full.substr (0, full.size () - CHECKSUM_SIZE);
+  return full.substr (data.size ()) == Checksum (data);
+}
+
+} // namespace xid
@@ -0,0 +1,27 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_BASE58_HPP
+#define XID_BASE58_HPP
+
+#include <string>
+
+namespace xid
+{
+
+/**
+ * Encodes the given data (raw bytes, e.g. version byte and hash of an
+ * address) in base58 with a checksum, as done by Xaya Core.
+ */
+std::string EncodeBase58Check (const std::string& data);
+
+/**
+ * Decodes a base58 string with checksum into the raw data.  Returns false
+ * if the string is not valid base58 or the checksum does not match.
+ */
+bool DecodeBase58Check (const std::string& str, std::string& data);
+
+} // namespace xid
+
+#endif // XID_BASE58_HPP
@@ -0,0 +1,76 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "base58.hpp"
+
+#include "evmabi.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+/**
+ * Decodes a hex string (with 0x prefix) to raw bytes.
+ */
+std::string
+FromHex (const std::string& hex)
+{
+  std::string res;
+  EXPECT_TRUE (DecodeEvmHex (hex, res));
+  return res;
+}
+
+TEST (Base58Tests, Addresses)
+{
+  const std::string hash = "06afd46bcdfd22ef94ac122aa11f241244a37ecc";
+
+  const std::string main = FromHex ("0x1c" + hash);
+  EXPECT_EQ (EncodeBase58Check (main), "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C");
+
+  const std::string test = FromHex ("0x58" + hash);
+  EXPECT_EQ (EncodeBase58Check (test), "cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn");
+
+  std::string data;
+  ASSERT_TRUE (DecodeBase58Check ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C", data));
+  EXPECT_EQ (data, main);
+  ASSERT_TRUE (DecodeBase58Check ("cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn", data));
+  EXPECT_EQ (data, test);
+}
+
+TEST (Base58Tests, LeadingZeros)
+{
+  EXPECT_EQ (EncodeBase58Check (""), "3QJmnh");
+  EXPECT_EQ (EncodeBase58Check (FromHex ("0x00000102")), "11WARUd14");
+  EXPECT_EQ (EncodeBase58Check (std::string (21, '\0')),
+             "1111111111111111111114oLvT2");
+
+  std::string data;
+  ASSERT_TRUE (DecodeBase58Check ("3QJmnh", data));
+  EXPECT_EQ (data, "");
+  ASSERT_TRUE (DecodeBase58Check ("11WARUd14", data));
+  EXPECT_EQ (data, FromHex ("0x00000102"));
+  ASSERT_TRUE (DecodeBase58Check ("1111111111111111111114oLvT2", data));
+  EXPECT_EQ (data, std::string (21, '\0'));
+}
+
+TEST (Base58Tests, Invalid)
+{
+  std::string data;
+  EXPECT_FALSE (DecodeBase58Check ("", data));
+  EXPECT_FALSE (DecodeBase58Check ("111", data));
+  EXPECT_FALSE (DecodeBase58Check ("domob", data));
+  EXPECT_FALSE (DecodeBase58Check ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5D", data));
+  EXPECT_FALSE (DecodeBase58Check ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5", data));
+  EXPECT_FALSE (DecodeBase58Check ("0H5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C", data));
+  EXPECT_FALSE (DecodeBase58Check ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C ",
+                                   data));
+}
+
+} // anonymous namespace
+} // namespace xid
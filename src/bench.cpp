@@ -0,0 +1,394 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+/* Throughput benchmark for MoveProcessor.  It generates deterministic
+   synthetic blocks and processes them against an in-memory as well as
+   an on-disk SQLite database, reporting moves/sec, rows written and
+   the latency distribution per block.  It also reports the cost of keeping
+   the SignerIndex updated and of lookups in it.  */
+
+#include "base58.hpp"
+#include "dictionary.hpp"
+#include "moveprocessor.hpp"
+#include "schema.hpp"
+#include "signerindex.hpp"
+#include "statementregistry.hpp"
+#include "workerpool.hpp"
+
+#include <xayagame/sqlitestorage.hpp>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include <json/json.h>
+
+#include <sqlite3.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+DEFINE_int32 (names, 10'000, "number of distinct names that send moves");
+DEFINE_int32 (apps_per_name, 2,
+              "number of applications with signers per name");
+DEFINE_int32 (signers_per_app, 3, "number of signer addresses per app");
+DEFINE_int32 (address_keys, 2, "number of crypto address keys per name");
+DEFINE_double (churn, 0.2,
+               "fraction of updates that actually change data, as opposed"
+               " to re-sending the current values");
+
+DEFINE_int32 (blocks, 100, "number of blocks to process");
+DEFINE_int32 (moves_per_block, 1'000, "number of moves in each block");
+DEFINE_int32 (decode_threads, 0,
+              "if positive, decode moves in parallel on that many threads");
+DEFINE_int32 (seed, 42, "seed for the random generator");
+DEFINE_int32 (index_lookups, 1'000'000,
+              "number of signer lookups to run against the index");
+
+DEFINE_string (disk_file, "",
+               "file for the on-disk database (a temporary file if empty)");
+
+namespace xid
+{
+namespace
+{
+
+/** Version byte of P2PKH addresses on Xaya mainnet.  */
+constexpr char ADDRESS_VERSION = 28;
+
+/**
+ * Generator for synthetic blocks.  It keeps track of the data each name
+ * has set, so that "unchanged" updates can re-send the current values
+ * like real-world clients do.
+ */
+class BlockGenerator
+{
+
+private:
+
+  /** The data we track for each name.  */
+  struct NameData
+  {
+    std::vector<std::vector<std::string>> signers;
+    std::vector<std::string> addresses;
+  };
+
+  /** Random generator used.  */
+  std::mt19937_64 rnd;
+
+  /** Current data of all names.  */
+  std::vector<NameData> names;
+
+  /** Counter used to make new addresses unique.  */
+  unsigned long nextAddress = 0;
+
+  /**
+   * Returns a new and unique address string.  It is a valid Base58Check
+   * P2PKH address (with the counter as hash), so that it is stored in
+   * binary form like real signer addresses.
+   */
+  std::string
+  NewAddress ()
+  {
+    std::string raw(1 + 20, '\0');
+    raw[0] = ADDRESS_VERSION;
+    for (unsigned long val = nextAddress++, i = 0; val > 0; val >>= 8, ++i)
+      raw[raw.size () - 1 - i] = static_cast<char> (val & 0xFF);
+    return EncodeBase58Check (raw);
+  }
+
+  /**
+   * Returns true with the configured churn probability.
+   */
+  bool
+  IsChurn ()
+  {
+    return std::uniform_real_distribution<double> (0, 1) (rnd) < FLAGS_churn;
+  }
+
+public:
+
+  explicit BlockGenerator (const unsigned seed)
+    : rnd(seed)
+  {
+    names.resize (FLAGS_names);
+    for (auto& n : names)
+      {
+        n.signers.resize (FLAGS_apps_per_name);
+        for (auto& s : n.signers)
+          for (int i = 0; i < FLAGS_signers_per_app; ++i)
+            s.push_back (NewAddress ());
+        for (int i = 0; i < FLAGS_address_keys; ++i)
+          n.addresses.push_back (NewAddress ());
+      }
+  }
+
+  /**
+   * Generates the next block's moves array.
+   */
+  Json::Value
+  NextBlock ()
+  {
+    Json::Value res(Json::arrayValue);
+    for (int i = 0; i < FLAGS_moves_per_block; ++i)
+      {
+        const unsigned ind = rnd () % names.size ();
+        auto& n = names[ind];
+
+        Json::Value apps(Json::objectValue);
+        for (size_t a = 0; a < n.signers.size (); ++a)
+          {
+            auto& signers = n.signers[a];
+            if (!signers.empty () && IsChurn ())
+              signers[rnd () % signers.size ()] = NewAddress ();
+
+            Json::Value arr(Json::arrayValue);
+            for (const auto& s : signers)
+              arr.append (s);
+            apps["app " + std::to_string (a)] = arr;
+          }
+
+        Json::Value ca(Json::objectValue);
+        for (size_t k = 0; k < n.addresses.size (); ++k)
+          {
+            if (IsChurn ())
+              n.addresses[k] = NewAddress ();
+            ca["key " + std::to_string (k)] = n.addresses[k];
+          }
+
+        Json::Value s(Json::objectValue);
+        s["a"] = apps;
+        Json::Value mv(Json::objectValue);
+        mv["s"] = s;
+        mv["ca"] = ca;
+
+        Json::Value entry(Json::objectValue);
+        entry["name"] = "name " + std::to_string (ind);
+        entry["move"] = mv;
+        res.append (entry);
+      }
+
+    return res;
+  }
+
+  /**
+   * Returns a random current signer (name, application and address).
+   * Returns false if there are no signers.
+   */
+  bool
+  RandomSigner (std::string& name, std::string& app, std::string& addr)
+  {
+    const unsigned ind = rnd () % names.size ();
+    const auto& signers = names[ind].signers;
+    if (signers.empty ())
+      return false;
+    const unsigned a = rnd () % signers.size ();
+    if (signers[a].empty ())
+      return false;
+
+    name = "name " + std::to_string (ind);
+    app = "app " + std::to_string (a);
+    addr = signers[a][rnd () % signers[a].size ()];
+    return true;
+  }
+
+};
+
+/**
+ * Returns the total number of rows changed so far on the database.
+ */
+int64_t
+GetTotalChanges (xaya::SQLiteDatabase& db)
+{
+  auto stmt = db.Prepare ("SELECT total_changes ()");
+  CHECK (stmt.Step ());
+  return stmt.Get<int64_t> (0);
+}
+
+/**
+ * Returns the given percentile of the (sorted) latencies.
+ */
+double
+Percentile (const std::vector<double>& sorted, const double p)
+{
+  CHECK (!sorted.empty ());
+  size_t ind = static_cast<size_t> (p * sorted.size ());
+  ind = std::min (ind, sorted.size () - 1);
+  return sorted[ind];
+}
+
+/**
+ * Runs the benchmark against the given database and prints the results.
+ */
+void
+RunBenchmark (const std::string& label, xaya::SQLiteDatabase& db)
+{
+  SetupDatabaseSchema (db);
+
+  std::unique_ptr<WorkerPool> pool;
+  if (FLAGS_decode_threads > 0)
+    pool = std::make_unique<WorkerPool> (FLAGS_decode_threads);
+
+  BlockGenerator gen(FLAGS_seed);
+
+  /* Like in XidGame, prepared statements are kept across blocks, and only
+     released before the connection is closed.  */
+  StatementRegistry stmts;
+  Dictionaries dicts;
+  SignerIndex index;
+  const int64_t changesBefore = GetTotalChanges (db);
+
+  std::vector<double> latencies;
+  std::vector<double> indexLatencies;
+  double total = 0.0;
+  for (int b = 0; b < FLAGS_blocks; ++b)
+    {
+      const auto block = gen.NextBlock ();
+
+      /* Like SQLiteGame, each block is processed in its own transaction.  */
+      const auto start = std::chrono::steady_clock::now ();
+      db.Execute ("BEGIN");
+      std::chrono::steady_clock::time_point indexStart, indexEnd;
+      {
+        MoveProcessor proc(db, stmts, dicts);
+        if (pool != nullptr)
+          proc.SetDecodePool (*pool);
+        proc.ProcessAll (block);
+
+        /* Like XidGame, the index is updated before committing.  */
+        indexStart = std::chrono::steady_clock::now ();
+        index.Update (db, proc.GetSignerChanges (), "block", b, "up-to-date");
+        indexEnd = std::chrono::steady_clock::now ();
+      }
+      db.Execute ("COMMIT");
+      const auto end = std::chrono::steady_clock::now ();
+
+      const std::chrono::duration<double, std::milli> ms = end - start;
+      latencies.push_back (ms.count ());
+      total += ms.count ();
+
+      const std::chrono::duration<double, std::milli> indexMs
+          = indexEnd - indexStart;
+      indexLatencies.push_back (indexMs.count ());
+    }
+  const unsigned prepared = stmts.GetNumPrepared ();
+  stmts.Clear ();
+
+  /* The signers for lookups are chosen beforehand, so that only the
+     lookups themselves are timed.  Names that did not send any move
+     yet have no signers, so not all lookups are hits.  */
+  struct Lookup
+  {
+    std::string name;
+    std::string app;
+    std::string addr;
+  };
+  std::vector<Lookup> lookups;
+  for (int i = 0; i < FLAGS_index_lookups; ++i)
+    {
+      Lookup l;
+      if (gen.RandomSigner (l.name, l.app, l.addr))
+        lookups.push_back (std::move (l));
+    }
+
+  const auto lookupStart = std::chrono::steady_clock::now ();
+  const auto snapshot = index.GetSnapshot ();
+  CHECK (snapshot != nullptr);
+  size_t found = 0;
+  for (const auto& l : lookups)
+    if (snapshot->IsValidSigner (l.name, l.app, l.addr))
+      ++found;
+  const auto lookupEnd = std::chrono::steady_clock::now ();
+  const std::chrono::duration<double, std::nano> lookupNs
+      = lookupEnd - lookupStart;
+
+  const int64_t rows = GetTotalChanges (db) - changesBefore;
+  std::sort (latencies.begin (), latencies.end ());
+  std::sort (indexLatencies.begin (), indexLatencies.end ());
+
+  const double moves
+      = static_cast<double> (FLAGS_blocks) * FLAGS_moves_per_block;
+  std::cout
+      << label << ":\n"
+      << "  moves/sec:       " << (moves / (total / 1'000.0)) << "\n"
+      << "  rows written:    " << rows << "\n"
+      << "  rows per block:  " << (static_cast<double> (rows) / FLAGS_blocks)
+      << "\n"
+      << "  statements:      " << prepared << "\n"
+      << "  p50 block (ms):  " << Percentile (latencies, 0.5) << "\n"
+      << "  p99 block (ms):  " << Percentile (latencies, 0.99) << "\n"
+      << "  p50 index (ms):  " << Percentile (indexLatencies, 0.5) << "\n"
+      << "  p99 index (ms):  " << Percentile (indexLatencies, 0.99) << "\n"
+      << "  lookups found:   " << found << " / " << lookups.size () << "\n"
+      << "  lookup (ns):     "
+      << (lookups.empty () ? 0.0 : lookupNs.count () / lookups.size ())
+      << "\n"
+      << std::endl;
+}
+
+} // anonymous namespace
+} // namespace xid
+
+int
+main (int argc, char** argv)
+{
+  google::InitGoogleLogging (argv[0]);
+
+  gflags::SetUsageMessage ("Benchmark processing of xid moves");
+  gflags::ParseCommandLineFlags (&argc, &argv, true);
+
+  if (FLAGS_names <= 0 || FLAGS_blocks <= 0 || FLAGS_moves_per_block <= 0)
+    {
+      std::cerr
+          << "Error: --names, --blocks and --moves_per_block must be positive"
+          << std::endl;
+      return EXIT_FAILURE;
+    }
+  if (FLAGS_index_lookups < 0)
+    {
+      std::cerr << "Error: --index_lookups must not be negative" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::cout
+      << "Processing " << FLAGS_blocks << " blocks with "
+      << FLAGS_moves_per_block << " moves each, for "
+      << FLAGS_names << " names (churn " << FLAGS_churn << ")\n"
+      << std::endl;
+
+  {
+    xaya::SQLiteDatabase db("bench",
+                            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE
+                              | SQLITE_OPEN_MEMORY);
+    xid::RunBenchmark ("In-memory database", db);
+  }
+
+  std::string file = FLAGS_disk_file;
+  if (file.empty ())
+    {
+      char tmpl[] = "/tmp/xid-bench-XXXXXX";
+      const int fd = mkstemp (tmpl);
+      CHECK_GE (fd, 0) << "Failed to create temporary file";
+      close (fd);
+      file = tmpl;
+    }
+
+  {
+    xaya::SQLiteDatabase db(file, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    xid::RunBenchmark ("On-disk database (" + file + ")", db);
+  }
+
+  if (FLAGS_disk_file.empty ())
+    std::remove (file.c_str ());
+
+  return EXIT_SUCCESS;
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -22,6 +22,52 @@ DBTestWithSchema::DBTestWithSchema ()
 {
   LOG (INFO) << "Setting up game-state schema in test database...";
   SetupDatabaseSchema (GetDb ());
+
+  GetDb ().Execute (R"(
+    CREATE TEMP VIEW `test_signers` AS
+      SELECT `n`.`value` AS `name`,
+             `a`.`value` AS `application`,
+             `s`.`address` AS `address`
+        FROM `signers` AS `s`
+          INNER JOIN `names` AS `n` ON `n`.`id` = `s`.`name_id`
+          LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`;
+
+    CREATE TEMP TRIGGER `test_signers_insert`
+      INSTEAD OF INSERT ON `test_signers`
+      BEGIN
+        INSERT OR IGNORE INTO `names` (`value`) VALUES (NEW.`name`);
+        INSERT OR IGNORE INTO `applications` (`value`)
+          SELECT NEW.`application` WHERE NEW.`application` IS NOT NULL;
+        INSERT INTO `signers` (`name_id`, `application_id`, `address`)
+          VALUES (
+            (SELECT `id` FROM `names` WHERE `value` = NEW.`name`),
+            IFNULL ((SELECT `id` FROM `applications`
+                       WHERE `value` = NEW.`application`), 0),
+            NEW.`address`
+          );
+      END;
+
+    CREATE TEMP VIEW `test_addresses` AS
+      SELECT `n`.`value` AS `name`,
+             `k`.`value` AS `key`,
+             `d`.`address` AS `address`
+        FROM `addresses` AS `d`
+          INNER JOIN `names` AS `n` ON `n`.`id` = `d`.`name_id`
+          INNER JOIN `keys` AS `k` ON `k`.`id` = `d`.`key_id`;
+
+    CREATE TEMP TRIGGER `test_addresses_insert`
+      INSTEAD OF INSERT ON `test_addresses`
+      BEGIN
+        INSERT OR IGNORE INTO `names` (`value`) VALUES (NEW.`name`);
+        INSERT OR IGNORE INTO `keys` (`value`) VALUES (NEW.`key`);
+        INSERT INTO `addresses` (`name_id`, `key_id`, `address`)
+          VALUES (
+            (SELECT `id` FROM `names` WHERE `value` = NEW.`name`),
+            (SELECT `id` FROM `keys` WHERE `value` = NEW.`key`),
+            NEW.`address`
+          );
+      END;
+  )");
 }
 
 } // namespace xid
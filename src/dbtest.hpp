@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -44,6 +44,14 @@ protected:
 /**
  * Test fixture that opens an in-memory database and also installs the
  * game-state schema in it.
+ *
+ * Since names, applications and keys are stored as IDs into the dictionary
+ * tables, it also creates the temporary views test_signers and
+ * test_addresses.  They show the signers and addresses tables with
+ * the strings resolved, and rows can be inserted into them with the
+ * strings directly.  Signer addresses are inserted as TEXT, so tests using
+ * them must not use valid base58 addresses (which would be stored
+ * in binary form by the move processor).
  */
 class DBTestWithSchema : public DBTest
 {
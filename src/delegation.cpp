@@ -0,0 +1,421 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "delegation.hpp"
+
+#include "evmabi.hpp"
+#include "keccak.hpp"
+
+#include <secp256k1_recovery.h>
+
+#include <glog/logging.h>
+
+#include <ctime>
+#include <vector>
+
+namespace xid
+{
+
+namespace
+{
+
+/** EIP-712 type of the domain.  */
+const std::string DOMAIN_TYPE
+    = "EIP712Domain(string name,string version,uint256 chainId,"
+      "address verifyingContract)";
+
+/** EIP-712 type of the extra data entries.  */
+const std::string EXTRA_TYPE = "ExtraData(string key,string value)";
+
+/** EIP-712 type of the signed challenge (including referenced types).  */
+const std::string CHALLENGE_TYPE
+    = "XidAuthChallenge(string name,string application,int64 expiry,"
+      "ExtraData[] extra)" + EXTRA_TYPE;
+
+/** Size of a raw signature (r, s and v).  */
+constexpr size_t SIGNATURE_SIZE = 65;
+
+/** The namespace of Xaya names that credentials are for.  */
+const std::string NAME_NS = "p";
+
+/**
+ * Appends a string with a fixed-size length prefix to the output.
+ */
+void
+AppendString (const std::string& str, std::string& out)
+{
+  const uint64_t len = str.size ();
+  for (int i = 7; i >= 0; --i)
+    out.push_back (static_cast<char> ((len >> (8 * i)) & 0xFF));
+  out.append (str);
+}
+
+} // anonymous namespace
+
+constexpr std::chrono::milliseconds DelegationVerifier::DEFAULT_BLOCK_REFRESH;
+
+/* ************************************************************************** */
+
+DelegationEncoder::DelegationEncoder (const uint64_t chainId,
+                                      const std::string& contract)
+{
+  domainSeparator = Keccak256 (
+      Keccak256 (DOMAIN_TYPE)
+        + Keccak256 ("xidauth delegation-contract")
+        + Keccak256 ("1")
+        + EncodeAbiUint (chainId)
+        + EncodeAbiAddress (contract));
+}
+
+std::string
+DelegationEncoder::HashChallenge (const std::string_view name,
+                                  const std::string_view application,
+                                  const CredentialsData& cred)
+{
+  static const std::string extraTypeHash = Keccak256 (EXTRA_TYPE);
+  static const std::string challengeTypeHash = Keccak256 (CHALLENGE_TYPE);
+
+  /* The extra data is already sorted by key, as required.  */
+  std::string extraHashes;
+  for (const auto& entry : cred.GetExtra ())
+    extraHashes += Keccak256 (extraTypeHash
+                                + Keccak256 (entry.first)
+                                + Keccak256 (entry.second));
+
+  const int64_t expiry
+      = cred.GetData ().has_expiry ()
+          ? static_cast<int64_t> (cred.GetData ().expiry ())
+          : -1;
+
+  return Keccak256 (challengeTypeHash
+                      + Keccak256 (name)
+                      + Keccak256 (application)
+                      + EncodeAbiInt (expiry)
+                      + Keccak256 (extraHashes));
+}
+
+std::string
+DelegationEncoder::Hash (const std::string_view name,
+                         const std::string_view application,
+                         const CredentialsData& cred) const
+{
+  return Keccak256 ("\x19\x01" + domainSeparator
+                      + HashChallenge (name, application, cred));
+}
+
+/* ************************************************************************** */
+
+DelegationVerifier::DelegationVerifier (std::unique_ptr<EvmRpc> r,
+                                        const std::string& contract,
+                                        const std::chrono::milliseconds refresh)
+  : rpc(std::move (r)), delegation(contract), blockRefresh(refresh)
+{
+  ctx = secp256k1_context_create (SECP256K1_CONTEXT_VERIFY);
+  CHECK (ctx != nullptr);
+
+  if (!Initialise ())
+    LOG (WARNING)
+        << "The EVM chain is not available, delegation-contract credentials"
+           " cannot be verified until it is";
+}
+
+DelegationVerifier::~DelegationVerifier ()
+{
+  secp256k1_context_destroy (ctx);
+}
+
+std::string
+DelegationVerifier::RecoverSigner (const std::string& hash,
+                                   const std::string& sgn) const
+{
+  CHECK_EQ (hash.size (), 32);
+  if (sgn.size () != SIGNATURE_SIZE)
+    return "";
+
+  /* Ethereum uses v = 27 + recid, but some signers produce just the
+     recid instead.  */
+  const auto* sgnData = reinterpret_cast<const unsigned char*> (sgn.data ());
+  int recid = sgnData[SIGNATURE_SIZE - 1];
+  if (recid >= 27)
+    recid -= 27;
+  if (recid < 0 || recid > 1)
+    return "";
+
+  secp256k1_ecdsa_recoverable_signature sig;
+  if (!secp256k1_ecdsa_recoverable_signature_parse_compact (ctx, &sig,
+                                                            sgnData, recid))
+    return "";
+
+  secp256k1_pubkey pubkey;
+  const auto* hashData = reinterpret_cast<const unsigned char*> (hash.data ());
+  if (!secp256k1_ecdsa_recover (ctx, &pubkey, &sig, hashData))
+    return "";
+
+  unsigned char serialised[65];
+  size_t len = sizeof (serialised);
+  CHECK (secp256k1_ec_pubkey_serialize (ctx, serialised, &len, &pubkey,
+                                        SECP256K1_EC_UNCOMPRESSED));
+  CHECK_EQ (len, sizeof (serialised));
+
+  /* The address is the last 20 bytes of the hash of the public key
+     (without the 0x04 prefix byte).  */
+  const std::string pubkeyBytes (reinterpret_cast<const char*> (serialised)
+                                    + 1, len - 1);
+  return Keccak256 (pubkeyBytes).substr (12);
+}
+
+bool
+DelegationVerifier::Initialise ()
+{
+  if (initialised.load (std::memory_order_acquire))
+    return true;
+
+  std::lock_guard<std::mutex> lock(initMut);
+  if (initialised.load (std::memory_order_relaxed))
+    return true;
+
+  uint64_t chainId, num;
+  if (!rpc->GetChainId (chainId))
+    {
+      LOG (WARNING) << "Failed to query EVM chain ID";
+      return false;
+    }
+  if (!rpc->GetBlockNumber (num))
+    {
+      LOG (WARNING) << "Failed to query EVM block number";
+      return false;
+    }
+  if (!CallAddress (delegation, AbiEncoder ("accounts()").Finish (),
+                    num, accounts))
+    {
+      LOG (WARNING)
+          << "Failed to query accounts contract from delegation contract";
+      return false;
+    }
+
+  LOG (INFO)
+      << "Verifying delegation-contract credentials on chain " << chainId
+      << " with delegation contract " << EncodeEvmHex (delegation)
+      << " and accounts contract " << EncodeEvmHex (accounts);
+
+  encoder = std::make_unique<DelegationEncoder> (chainId, delegation);
+  initialised.store (true, std::memory_order_release);
+
+  return true;
+}
+
+bool
+DelegationVerifier::GetBlock (uint64_t& num)
+{
+  const auto now = std::chrono::steady_clock::now ();
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    if (blockTime.time_since_epoch ().count () != 0
+          && now - blockTime < blockRefresh)
+      {
+        num = block;
+        return true;
+      }
+  }
+
+  /* The RPC call is done without holding the lock.  If several threads
+     do it at the same time, that is fine.  */
+  if (!rpc->GetBlockNumber (num))
+    return false;
+
+  std::lock_guard<std::mutex> lock(mut);
+  if (num != block)
+    {
+      VLOG (1) << "New EVM block: " << num;
+      permissions.clear ();
+      block = num;
+    }
+  blockTime = now;
+
+  return true;
+}
+
+bool
+DelegationVerifier::CallBool (const std::string& to, const std::string& data,
+                              const uint64_t num, bool& out) const
+{
+  std::string result;
+  if (!rpc->Call (to, data, num, result))
+    return false;
+  if (!DecodeAbiBool (result, out))
+    {
+      LOG (WARNING) << "Invalid bool result: " << EncodeEvmHex (result);
+      return false;
+    }
+  return true;
+}
+
+bool
+DelegationVerifier::CallAddress (const std::string& to,
+                                 const std::string& data, const uint64_t num,
+                                 std::string& out) const
+{
+  std::string result;
+  if (!rpc->Call (to, data, num, result))
+    return false;
+  if (!DecodeAbiAddress (result, out))
+    {
+      LOG (WARNING) << "Invalid address result: " << EncodeEvmHex (result);
+      return false;
+    }
+  return true;
+}
+
+DelegationVerifier::Result
+DelegationVerifier::CheckPermission (const std::string& name,
+                                     const std::string& application,
+                                     const std::string& signer,
+                                     const uint64_t num, const int64_t now,
+                                     bool& timeBound) const
+{
+  /* This follows xidauth.delegation.Verifier:  The name has to exist, and
+     then the signer needs either delegated access to the xidauth path
+     of the application (which includes the owner), or an ERC-721 approval
+     for the name's token.
+
+     Delegated permissions may expire, so the result of hasAccess depends
+     on the time.  Ownership is checked first, so that the common case of
+     the owner signing is independent of time (and can be cached for the
+     whole block).  */
+  timeBound = false;
+
+  std::string tokenId;
+  {
+    std::string result;
+    if (!rpc->Call (accounts, AbiEncoder ("tokenIdForName(string,string)")
+                                  .AddString (NAME_NS)
+                                  .AddString (name)
+                                  .Finish (),
+                    num, result)
+          || result.size () < 32)
+      return Result::UNAVAILABLE;
+    tokenId = result.substr (0, 32);
+  }
+
+  bool flag;
+  if (!CallBool (accounts, AbiEncoder ("exists(uint256)")
+                              .AddWord (tokenId)
+                              .Finish (),
+                 num, flag))
+    return Result::UNAVAILABLE;
+  if (!flag)
+    {
+      VLOG (1) << "Name does not exist: " << name;
+      return Result::INVALID;
+    }
+
+  std::string owner;
+  if (!CallAddress (accounts, AbiEncoder ("ownerOf(uint256)")
+                                  .AddWord (tokenId)
+                                  .Finish (),
+                    num, owner))
+    return Result::UNAVAILABLE;
+  if (owner == signer)
+    return Result::VALID;
+
+  std::string addr;
+  if (!CallAddress (accounts, AbiEncoder ("getApproved(uint256)")
+                                  .AddWord (tokenId)
+                                  .Finish (),
+                    num, addr))
+    return Result::UNAVAILABLE;
+  if (addr == signer)
+    return Result::VALID;
+
+  if (!CallBool (accounts, AbiEncoder ("isApprovedForAll(address,address)")
+                              .AddWord (EncodeAbiAddress (owner))
+                              .AddWord (EncodeAbiAddress (signer))
+                              .Finish (),
+                 num, flag))
+    return Result::UNAVAILABLE;
+  if (flag)
+    return Result::VALID;
+
+  const std::vector<std::string> path = {"g", "id", "xidauth", application};
+  if (!CallBool (delegation,
+                 AbiEncoder ("hasAccess(string,string,string[],address,"
+                             "uint256)")
+                    .AddString (NAME_NS)
+                    .AddString (name)
+                    .AddStringArray (path)
+                    .AddWord (EncodeAbiAddress (signer))
+                    .AddWord (EncodeAbiUint (now))
+                    .Finish (),
+                 num, flag))
+    return Result::UNAVAILABLE;
+  timeBound = true;
+
+  return flag ? Result::VALID : Result::INVALID;
+}
+
+DelegationVerifier::Result
+DelegationVerifier::Verify (const std::string& name,
+                            const std::string& application,
+                            const CredentialsData& cred)
+{
+  return Verify (name, application, cred, std::time (nullptr));
+}
+
+DelegationVerifier::Result
+DelegationVerifier::Verify (const std::string& name,
+                            const std::string& application,
+                            const CredentialsData& cred, const int64_t now)
+{
+  if (!Initialise ())
+    return Result::UNAVAILABLE;
+
+  const std::string signer
+      = RecoverSigner (encoder->Hash (name, application, cred),
+                       cred.GetData ().signature_bytes ());
+  if (signer.empty ())
+    return Result::INVALID;
+  VLOG (1) << "Delegation signer: " << EncodeEvmHex (signer);
+
+  uint64_t num;
+  if (!GetBlock (num))
+    return Result::UNAVAILABLE;
+
+  /* The signer address has a fixed size, so it needs no length prefix.  */
+  std::string key;
+  AppendString (name, key);
+  AppendString (application, key);
+  key += signer;
+
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    if (num == block)
+      {
+        const auto mit = permissions.find (key);
+        if (mit != permissions.end ()
+              && (mit->second.checkedAt == -1
+                    || mit->second.checkedAt == now))
+          return mit->second.valid ? Result::VALID : Result::INVALID;
+      }
+  }
+
+  bool timeBound;
+  const Result res = CheckPermission (name, application, signer, num,
+                                      now, timeBound);
+  if (res == Result::UNAVAILABLE)
+    return res;
+
+  std::lock_guard<std::mutex> lock(mut);
+  if (num == block)
+    {
+      if (permissions.size () >= MAX_PERMISSIONS)
+        permissions.clear ();
+      CachedPermission& entry = permissions[key];
+      entry.valid = (res == Result::VALID);
+      entry.checkedAt = timeBound ? now : -1;
+    }
+
+  return res;
+}
+
+} // namespace xid
@@ -0,0 +1,273 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_DELEGATION_HPP
+#define XID_DELEGATION_HPP
+
+#include "auth/credentialsdata.hpp"
+
+#include <secp256k1.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace xid
+{
+
+/**
+ * Interface for the calls to an EVM chain's JSON-RPC interface that are
+ * needed to verify delegation-contract credentials.  Addresses and data
+ * are passed as raw bytes.  All methods return false if the call failed.
+ *
+ * Implementations must be thread-safe.
+ */
+class EvmRpc
+{
+
+public:
+
+  EvmRpc () = default;
+  virtual ~EvmRpc () = default;
+
+  EvmRpc (const EvmRpc&) = delete;
+  void operator= (const EvmRpc&) = delete;
+
+  /** Queries the chain ID (eth_chainId).  */
+  virtual bool GetChainId (uint64_t& id) = 0;
+
+  /** Queries the current block number (eth_blockNumber).  */
+  virtual bool GetBlockNumber (uint64_t& num) = 0;
+
+  /**
+   * Calls a view function of a contract (eth_call) at the given block
+   * and returns the raw result data.
+   */
+  virtual bool Call (const std::string& to, const std::string& data,
+                     uint64_t block, std::string& result) = 0;
+
+};
+
+/**
+ * Encoder for the EIP-712 typed data that is signed for credentials with
+ * the delegation-contract protocol (see doc/auth.md).  This matches
+ * xidauth.delegation.Encoder.
+ */
+class DelegationEncoder
+{
+
+private:
+
+  /** The EIP-712 domain separator (for chain ID and contract).  */
+  std::string domainSeparator;
+
+public:
+
+  /**
+   * Constructs the encoder for the given chain ID and delegation contract
+   * (as raw 20-byte address).
+   */
+  explicit DelegationEncoder (uint64_t chainId, const std::string& contract);
+
+  /**
+   * Returns the domain separator (the "header" of the signed data).
+   */
+  const std::string&
+  GetDomainSeparator () const
+  {
+    return domainSeparator;
+  }
+
+  /**
+   * Computes the hash of the XidAuthChallenge struct for the given
+   * credentials (the "body" of the signed data).
+   */
+  static std::string HashChallenge (std::string_view name,
+                                    std::string_view application,
+                                    const CredentialsData& cred);
+
+  /**
+   * Computes the final hash that is signed for the given credentials.
+   */
+  std::string Hash (std::string_view name, std::string_view application,
+                    const CredentialsData& cred) const;
+
+};
+
+/**
+ * Verifier for credentials with the delegation-contract protocol.  It
+ * recovers the signer of the EIP-712 data locally, and checks its
+ * permissions through calls to the delegation and accounts contracts.
+ * Those are cached per name, application and signer address for the
+ * current block, so that repeated logins only need the signature check.
+ *
+ * The chain ID and accounts contract are queried when the verifier is
+ * constructed.  If the EVM chain is not reachable at that point, this is
+ * retried on each verification, and credentials are reported as
+ * unavailable until it succeeds.
+ *
+ * Instances are thread-safe.
+ */
+class DelegationVerifier
+{
+
+public:
+
+  /** Result of verifying credentials.  */
+  enum class Result
+  {
+    /** The signer has permission for the name and application.  */
+    VALID,
+    /** The signature is invalid or the signer has no permission.  */
+    INVALID,
+    /** The EVM chain could not be queried.  */
+    UNAVAILABLE,
+  };
+
+  /** Default interval after which the current block number is refreshed.  */
+  static constexpr std::chrono::milliseconds DEFAULT_BLOCK_REFRESH{1'000};
+
+private:
+
+  /** Maximum number of cached permissions (for a single block).  */
+  static constexpr size_t MAX_PERMISSIONS = 100'000;
+
+  /** The RPC interface to the EVM chain.  */
+  std::unique_ptr<EvmRpc> rpc;
+
+  /** The libsecp256k1 context used for recovery.  */
+  secp256k1_context* ctx;
+
+  /** The delegation contract (raw address).  */
+  const std::string delegation;
+
+  /** Lock for initialising accounts and encoder.  */
+  std::mutex initMut;
+
+  /**
+   * Set once accounts and encoder have been initialised.  They are not
+   * changed afterwards, and can then be used without locking.
+   */
+  std::atomic<bool> initialised{false};
+
+  /** The accounts contract (raw address), queried from the delegation.  */
+  std::string accounts;
+
+  /** The encoder for signed data.  */
+  std::unique_ptr<DelegationEncoder> encoder;
+
+  /** How often the current block number is queried at most.  */
+  const std::chrono::milliseconds blockRefresh;
+
+  /** Lock for the block number and cached permissions.  */
+  mutable std::mutex mut;
+
+  /** The current block number (if blockTime is set).  */
+  uint64_t block = 0;
+
+  /** When the block number was last queried.  */
+  std::chrono::steady_clock::time_point blockTime;
+
+  /** A permission that has been checked at the current block.  */
+  struct CachedPermission
+  {
+
+    /** Whether the signer has permission.  */
+    bool valid;
+
+    /**
+     * If the result depends on the current time (i.e. it comes from
+     * hasAccess of the delegation contract, whose permissions may expire),
+     * the time at which it was checked.  It is then only used for the
+     * same second.  -1 if the result is independent of time.
+     */
+    int64_t checkedAt;
+
+  };
+
+  /**
+   * Permissions checked at the current block, keyed by name, application
+   * and signer address.
+   */
+  std::unordered_map<std::string, CachedPermission> permissions;
+
+  /**
+   * Queries the chain ID and accounts contract and sets up the encoder,
+   * if not yet done.  Returns false if the EVM chain cannot be queried.
+   */
+  bool Initialise ();
+
+  /**
+   * Returns the current block number, querying it if it has not been
+   * refreshed recently.  Returns false if that fails.
+   */
+  bool GetBlock (uint64_t& num);
+
+  /**
+   * Calls a view function and decodes its result as bool or address.
+   */
+  bool CallBool (const std::string& to, const std::string& data,
+                 uint64_t num, bool& out) const;
+  bool CallAddress (const std::string& to, const std::string& data,
+                    uint64_t num, std::string& out) const;
+
+  /**
+   * Checks with the contracts whether the signer has permission for
+   * the name and application at the given block and time.  timeBound
+   * is set to whether the result depends on the time.
+   */
+  Result CheckPermission (const std::string& name,
+                          const std::string& application,
+                          const std::string& signer, uint64_t num,
+                          int64_t now, bool& timeBound) const;
+
+public:
+
+  /**
+   * Constructs the verifier, connecting to the given delegation contract
+   * (raw address) through the RPC interface.  This tries to query the
+   * chain ID and accounts contract right away.
+   */
+  explicit DelegationVerifier (
+      std::unique_ptr<EvmRpc> r, const std::string& contract,
+      std::chrono::milliseconds refresh = DEFAULT_BLOCK_REFRESH);
+
+  ~DelegationVerifier ();
+
+  DelegationVerifier (const DelegationVerifier&) = delete;
+  void operator= (const DelegationVerifier&) = delete;
+
+  /**
+   * Recovers the address (raw bytes) that produced the given 65-byte
+   * signature (r, s and v) of a 32-byte hash.  Returns the empty string
+   * if the signature is invalid.
+   */
+  std::string RecoverSigner (const std::string& hash,
+                             const std::string& sgn) const;
+
+  /**
+   * Verifies the signature of the given credentials, and whether the
+   * signer has permission for the name and application at the given
+   * time (as Unix timestamp).  This does not check the format of the
+   * credentials or whether they are expired.
+   */
+  Result Verify (const std::string& name, const std::string& application,
+                 const CredentialsData& cred, int64_t now);
+
+  /**
+   * Verifies the credentials at the current time.
+   */
+  Result Verify (const std::string& name, const std::string& application,
+                 const CredentialsData& cred);
+
+};
+
+} // namespace xid
+
+#endif // XID_DELEGATION_HPP
@@ -0,0 +1,488 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "delegation.hpp"
+
+#include "evmabi.hpp"
+#include "keccak.hpp"
+
+#include "auth/base64.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+
+namespace xid
+{
+namespace
+{
+
+/**
+ * Decodes a hex string, which must be valid.
+ */
+std::string
+Hex (const std::string& hex)
+{
+  std::string res;
+  CHECK (DecodeEvmHex (hex, res)) << hex;
+  return res;
+}
+
+/** Chain ID used in the tests.  */
+constexpr uint64_t CHAIN_ID = 137;
+
+/** Delegation contract used in the tests.  */
+const std::string DELEGATION
+    = Hex ("0xEB4c2EF7874628B646B8A59e4A309B94e14C2a6B");
+
+/** Accounts contract returned by the fake delegation contract.  */
+const std::string ACCOUNTS
+    = Hex ("0xD5fd31CfD529498B1668fE9dFa336c475AC57C76");
+
+/** Address for the private key 1.  */
+const std::string ADDR1 = Hex ("0x7e5f4552091a69125d5dfcb7b8c2659029395bdf");
+/** Address for the private key 2.  */
+const std::string ADDR2 = Hex ("0x2b5ad5c4795c026514f8317c7a215e218dccd6cf");
+
+/**
+ * Signatures of credentials for domob and app (no expiry or extra data)
+ * with the private keys 1 and 2, and for domob and "other" with key 1.
+ */
+const std::string SGN_APP_1 = Hex (
+    "0x03be502a851fe76327ab4fa5cf7d979cc63774357c1c6435c8c31526c174d21f"
+    "34b982de08f7585ac626324eb199bca32cff6ee8d5505e9213b71523d51c747c1b");
+const std::string SGN_APP_2 = Hex (
+    "0x3d102aa2b1487cdca95b9b8d32d38fb679a2f4046aeac0799da3a74729c813e9"
+    "31b7dafc13ea200ea197c7233e094ccaaf0157480ba1a8362cdd0b4b3f194ebb1c");
+const std::string SGN_OTHER_1 = Hex (
+    "0xb82cc8903d5b1a38345f672c3262adae215fdfc5026770b01a9152705bb4a652"
+    "6385043598f52fee8c7545bf9469a9365b2dcf2e8f050de95e6c03879d9550831c");
+
+/**
+ * Reads the string at the given byte offset into ABI-encoded arguments.
+ */
+std::string
+ReadStringAt (const std::string& args, const size_t offset)
+{
+  uint64_t len = 0;
+  for (size_t i = offset + 24; i < offset + 32; ++i)
+    len = (len << 8) | static_cast<unsigned char> (args[i]);
+  return args.substr (offset + 32, len);
+}
+
+/**
+ * Reads the offset stored in the given word of ABI-encoded data.
+ */
+size_t
+ReadOffset (const std::string& args, const size_t word)
+{
+  size_t res = 0;
+  for (size_t i = 32 * word + 24; i < 32 * (word + 1); ++i)
+    res = (res << 8) | static_cast<unsigned char> (args[i]);
+  return res;
+}
+
+/**
+ * Simple stand-in for the EVM chain with the delegation and accounts
+ * contracts.  It decodes the calls that DelegationVerifier makes, and
+ * answers them based on the state configured by the test.
+ */
+class FakeEvm : public EvmRpc
+{
+
+private:
+
+  /** Names for the token IDs that have been returned.  */
+  std::map<std::string, std::string> tokenNames;
+
+  /**
+   * Returns the name for a token ID.
+   */
+  const std::string&
+  LookupToken (const std::string& tokenId) const
+  {
+    return tokenNames.at (tokenId);
+  }
+
+  /**
+   * Answers a call to a contract.
+   */
+  std::string
+  Answer (const std::string& to, const std::string& data)
+  {
+    const std::string selector = data.substr (0, 4);
+    const std::string args = data.substr (4);
+
+    if (to == DELEGATION)
+      {
+        if (selector == AbiEncoder::Selector ("accounts()"))
+          return EncodeAbiAddress (ACCOUNTS);
+
+        CHECK_EQ (selector, AbiEncoder::Selector (
+            "hasAccess(string,string,string[],address,uint256)"));
+        CHECK_EQ (ReadStringAt (args, ReadOffset (args, 0)), "p");
+        const std::string name = ReadStringAt (args, ReadOffset (args, 1));
+        const size_t pathOffset = ReadOffset (args, 2) + 32;
+        const std::string pathArgs = args.substr (pathOffset);
+        CHECK_EQ (ReadOffset (args, ReadOffset (args, 2) / 32), 4);
+        CHECK_EQ (ReadStringAt (pathArgs, ReadOffset (pathArgs, 2)),
+                  "xidauth");
+        const std::string app = ReadStringAt (pathArgs,
+                                              ReadOffset (pathArgs, 3));
+        const std::string signer = args.substr (3 * 32 + 12, 20);
+
+        const bool res
+            = (owners.count (name) > 0 && owners.at (name) == signer)
+                || access.count (std::make_tuple (name, app, signer)) > 0;
+        return EncodeAbiUint (res);
+      }
+
+    CHECK_EQ (to, ACCOUNTS);
+    if (selector == AbiEncoder::Selector ("tokenIdForName(string,string)"))
+      {
+        const std::string name = ReadStringAt (args, ReadOffset (args, 1));
+        const std::string tokenId = Keccak256 (name);
+        tokenNames[tokenId] = name;
+        return tokenId;
+      }
+    if (selector == AbiEncoder::Selector ("exists(uint256)"))
+      return EncodeAbiUint (owners.count (LookupToken (args)) > 0);
+    if (selector == AbiEncoder::Selector ("getApproved(uint256)"))
+      {
+        const auto mit = approved.find (LookupToken (args));
+        if (mit == approved.end ())
+          return std::string (32, '\0');
+        return EncodeAbiAddress (mit->second);
+      }
+    if (selector == AbiEncoder::Selector ("ownerOf(uint256)"))
+      return EncodeAbiAddress (owners.at (LookupToken (args)));
+
+    CHECK_EQ (selector,
+              AbiEncoder::Selector ("isApprovedForAll(address,address)"));
+    const std::string owner = args.substr (12, 20);
+    const std::string op = args.substr (32 + 12, 20);
+    return EncodeAbiUint (approvedForAll.count ({owner, op}) > 0);
+  }
+
+public:
+
+  /** The current block number.  */
+  uint64_t block = 10;
+
+  /** If set, all calls fail.  */
+  bool fail = false;
+
+  /** Number of eth_call requests made.  */
+  unsigned calls = 0;
+
+  /** Owners of registered names.  */
+  std::map<std::string, std::string> owners;
+
+  /** Delegated access as name, application and address.  */
+  std::set<std::tuple<std::string, std::string, std::string>> access;
+
+  /** ERC-721 approved addresses per name.  */
+  std::map<std::string, std::string> approved;
+
+  /** Operator approvals as owner and operator.  */
+  std::set<std::pair<std::string, std::string>> approvedForAll;
+
+  bool
+  GetChainId (uint64_t& id) override
+  {
+    id = CHAIN_ID;
+    return !fail;
+  }
+
+  bool
+  GetBlockNumber (uint64_t& num) override
+  {
+    num = block;
+    return !fail;
+  }
+
+  bool
+  Call (const std::string& to, const std::string& data, const uint64_t num,
+        std::string& result) override
+  {
+    if (fail)
+      return false;
+
+    CHECK_EQ (num, block);
+    ++calls;
+    result = Answer (to, data);
+    return true;
+  }
+
+};
+
+/* ************************************************************************** */
+
+class DelegationEncoderTests : public testing::Test
+{
+
+protected:
+
+  CredentialsData cred;
+
+  DelegationEncoderTests ()
+  {
+    cred.SetProtocol (Protocol::DELEGATION_CONTRACT);
+    cred.SetExpiry (123);
+    cred.AddExtra ("foo", "bar");
+    cred.AddExtra ("abc", "def");
+  }
+
+};
+
+TEST_F (DelegationEncoderTests, GoldenData)
+{
+  /* These values match the test for the Python implementation in
+     xidauth/tests/delegation.py.  */
+  const DelegationEncoder enc(CHAIN_ID, DELEGATION);
+  EXPECT_EQ (EncodeEvmHex (enc.GetDomainSeparator ()),
+      "0x7b1448ef6131957018ab89a7dceebb1560c5b38e2734ba37f18a82d00415a624");
+  EXPECT_EQ (EncodeEvmHex (enc.HashChallenge ("name", "app", cred)),
+      "0xf5ceadeccbac2325db615f77a2a73280ff0b1c5c0e49587d578d9ba0eeecd01b");
+  EXPECT_EQ (EncodeEvmHex (enc.Hash ("name", "app", cred)),
+      "0x660f29637fca69077b0b4b993d0fc61778b1b1ea5c758c3d36bc428b5806efb8");
+}
+
+TEST_F (DelegationEncoderTests, Commitment)
+{
+  const DelegationEncoder enc(CHAIN_ID, DELEGATION);
+  const std::string base = enc.Hash ("name", "app", cred);
+
+  EXPECT_NE (DelegationEncoder (100, DELEGATION).Hash ("name", "app", cred),
+             base);
+  EXPECT_NE (DelegationEncoder (CHAIN_ID, ACCOUNTS).Hash ("name", "app", cred),
+             base);
+  EXPECT_NE (enc.Hash ("other", "app", cred), base);
+  EXPECT_NE (enc.Hash ("name", "other", cred), base);
+
+  cred.SetExpiry (124);
+  EXPECT_NE (enc.Hash ("name", "app", cred), base);
+  cred.SetExpiry (123);
+  EXPECT_EQ (enc.Hash ("name", "app", cred), base);
+
+  cred.AddExtra ("x", "y");
+  EXPECT_NE (enc.Hash ("name", "app", cred), base);
+}
+
+/* ************************************************************************** */
+
+class DelegationVerifierTests : public testing::Test
+{
+
+protected:
+
+  /** The fake EVM, owned by the verifier.  */
+  FakeEvm* evm;
+
+  DelegationVerifier verifier;
+
+  DelegationVerifierTests ()
+    : evm(new FakeEvm ()),
+      verifier(std::unique_ptr<EvmRpc> (evm), DELEGATION,
+               std::chrono::milliseconds (0))
+  {}
+
+  /**
+   * Verifies credentials for the given name and application with
+   * the given signature (at the given time).
+   */
+  DelegationVerifier::Result
+  Verify (const std::string& name, const std::string& app,
+          const std::string& sgn, const int64_t now = 1'000)
+  {
+    CredentialsData cred;
+    cred.SetProtocol (Protocol::DELEGATION_CONTRACT);
+    CHECK (cred.SetSignature (EncodeBase64 (sgn)));
+    return verifier.Verify (name, app, cred, now);
+  }
+
+};
+
+using Result = DelegationVerifier::Result;
+
+TEST_F (DelegationVerifierTests, RecoverSigner)
+{
+  CredentialsData cred;
+  cred.SetExpiry (123);
+  cred.AddExtra ("foo", "bar");
+  cred.AddExtra ("abc", "def");
+  const std::string hash
+      = DelegationEncoder (CHAIN_ID, DELEGATION).Hash ("name", "app", cred);
+
+  std::string sgn = Hex (
+      "0x0976293f7bcaac1392e2bee11bea351bfe2ffad76dffdd4ac58e14ce379fa2e2"
+      "02aa8ca6727261a56f8af9e5538bb6bf172a696f145e56b1de15371b77cbb7471b");
+  EXPECT_EQ (verifier.RecoverSigner (hash, sgn), ADDR1);
+
+  /* v can also be just the recovery ID.  */
+  sgn.back () = 0;
+  EXPECT_EQ (verifier.RecoverSigner (hash, sgn), ADDR1);
+
+  /* The other recovery ID yields a different address.  */
+  sgn.back () = 1;
+  const std::string other = verifier.RecoverSigner (hash, sgn);
+  EXPECT_NE (other, ADDR1);
+
+  sgn.back () = 29;
+  EXPECT_EQ (verifier.RecoverSigner (hash, sgn), "");
+  EXPECT_EQ (verifier.RecoverSigner (hash, sgn.substr (1)), "");
+  EXPECT_EQ (verifier.RecoverSigner (hash, std::string (65, '\0')), "");
+}
+
+TEST_F (DelegationVerifierTests, OwnerAndSignature)
+{
+  evm->owners["domob"] = ADDR1;
+
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::VALID);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::INVALID);
+  EXPECT_EQ (Verify ("domob", "other", SGN_APP_1), Result::INVALID);
+  EXPECT_EQ (Verify ("domob", "other", SGN_OTHER_1), Result::VALID);
+  EXPECT_EQ (Verify ("andy", "app", SGN_APP_1), Result::INVALID);
+  EXPECT_EQ (Verify ("domob", "app", ""), Result::INVALID);
+}
+
+TEST_F (DelegationVerifierTests, NameDoesNotExist)
+{
+  evm->access.emplace ("domob", "app", ADDR1);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::INVALID);
+}
+
+TEST_F (DelegationVerifierTests, DelegatedAccess)
+{
+  evm->owners["domob"] = ADDR1;
+  evm->access.emplace ("domob", "app", ADDR2);
+
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::VALID);
+
+  evm->access.clear ();
+  evm->access.emplace ("domob", "other", ADDR2);
+  ++evm->block;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::INVALID);
+}
+
+TEST_F (DelegationVerifierTests, Approvals)
+{
+  evm->owners["domob"] = ADDR1;
+  evm->approved["domob"] = ADDR2;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::VALID);
+
+  evm->approved.clear ();
+  evm->approvedForAll.emplace (ADDR1, ADDR2);
+  ++evm->block;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::VALID);
+
+  evm->approvedForAll.clear ();
+  evm->approvedForAll.emplace (ADDR2, ADDR1);
+  ++evm->block;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::INVALID);
+}
+
+TEST_F (DelegationVerifierTests, CachedPerBlock)
+{
+  evm->owners["domob"] = ADDR1;
+  evm->access.emplace ("domob", "app", ADDR2);
+
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::VALID);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::VALID);
+  const unsigned calls = evm->calls;
+
+  /* Permissions are not queried again in the same block, even if they
+     changed (which can only happen with a new block on a real chain).  */
+  evm->access.clear ();
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::VALID);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::VALID);
+  EXPECT_EQ (evm->calls, calls);
+
+  /* Different names, applications or signers are not cached.  */
+  EXPECT_EQ (Verify ("domob", "other", SGN_OTHER_1), Result::VALID);
+  EXPECT_GT (evm->calls, calls);
+
+  ++evm->block;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::VALID);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2), Result::INVALID);
+}
+
+TEST_F (DelegationVerifierTests, DelegatedAccessCachedPerSecond)
+{
+  evm->owners["domob"] = ADDR1;
+  evm->access.emplace ("domob", "app", ADDR2);
+
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1, 1'000), Result::VALID);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2, 1'000), Result::VALID);
+  const unsigned calls = evm->calls;
+
+  /* Delegated permissions may expire without a new block.  Their results
+     are thus only reused for the same time, while ownership is not
+     time-dependent and stays cached for the block.  */
+  evm->access.clear ();
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2, 1'000), Result::VALID);
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1, 1'001), Result::VALID);
+  EXPECT_EQ (evm->calls, calls);
+
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_2, 1'001), Result::INVALID);
+  EXPECT_GT (evm->calls, calls);
+}
+
+TEST_F (DelegationVerifierTests, BlockRefresh)
+{
+  FakeEvm* slowEvm = new FakeEvm ();
+  DelegationVerifier slow(std::unique_ptr<EvmRpc> (slowEvm), DELEGATION,
+                          std::chrono::hours (1));
+
+  CredentialsData cred;
+  cred.SetProtocol (Protocol::DELEGATION_CONTRACT);
+  CHECK (cred.SetSignature (EncodeBase64 (SGN_APP_1)));
+
+  slowEvm->owners["domob"] = ADDR1;
+  EXPECT_EQ (slow.Verify ("domob", "app", cred), Result::VALID);
+
+  /* The block number is not queried again, so the result stays cached
+     even though the fake chain moved on.  The fake checks that calls
+     are made for the current block, so we must not trigger any.  */
+  slowEvm->owners.clear ();
+  slowEvm->block = 5;
+  EXPECT_EQ (slow.Verify ("domob", "app", cred), Result::VALID);
+}
+
+TEST_F (DelegationVerifierTests, Unavailable)
+{
+  evm->owners["domob"] = ADDR1;
+  evm->fail = true;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::UNAVAILABLE);
+
+  /* Failures are not cached.  */
+  evm->fail = false;
+  EXPECT_EQ (Verify ("domob", "app", SGN_APP_1), Result::VALID);
+}
+
+TEST_F (DelegationVerifierTests, UnavailableAtStartup)
+{
+  FakeEvm* downEvm = new FakeEvm ();
+  downEvm->fail = true;
+  DelegationVerifier down(std::unique_ptr<EvmRpc> (downEvm), DELEGATION,
+                          std::chrono::milliseconds (0));
+
+  CredentialsData cred;
+  cred.SetProtocol (Protocol::DELEGATION_CONTRACT);
+  CHECK (cred.SetSignature (EncodeBase64 (SGN_APP_1)));
+
+  downEvm->owners["domob"] = ADDR1;
+  EXPECT_EQ (down.Verify ("domob", "app", cred), Result::UNAVAILABLE);
+
+  downEvm->fail = false;
+  EXPECT_EQ (down.Verify ("domob", "app", cred), Result::VALID);
+}
+
+} // anonymous namespace
+} // namespace xid
@@ -0,0 +1,70 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dictionary.hpp"
+
+#include <glog/logging.h>
+
+namespace xid
+{
+
+constexpr size_t Dictionary::MAX_CACHED;
+
+Dictionary::Dictionary (const std::string& table)
+  : sqlSelect("SELECT `id` FROM `" + table + "` WHERE `value` = ?1"),
+    sqlInsert("INSERT INTO `" + table + "` (`value`) VALUES (?1)")
+{}
+
+void
+Dictionary::Cache (const std::string& str, const int64_t id)
+{
+  /* Most lookups are for a few frequent strings (like applications), which
+     will quickly be cached again.  So just start over when the cache gets
+     too large.  */
+  if (ids.size () >= MAX_CACHED)
+    ids.clear ();
+
+  ids.emplace (str, id);
+}
+
+bool
+Dictionary::Lookup (xaya::SQLiteDatabase& db, StatementRegistry& stmts,
+                    const std::string& str, int64_t& id)
+{
+  const auto mit = ids.find (str);
+  if (mit != ids.end ())
+    {
+      id = mit->second;
+      return true;
+    }
+
+  auto& stmt = stmts.Get (db, sqlSelect);
+  stmt.Bind (1, str);
+  if (!stmt.Step ())
+    return false;
+
+  id = stmt.Get<int64_t> (0);
+  CHECK (!stmt.Step ());
+  Cache (str, id);
+
+  return true;
+}
+
+int64_t
+Dictionary::Intern (xaya::SQLiteDatabase& db, StatementRegistry& stmts,
+                    const std::string& str)
+{
+  int64_t id;
+  if (Lookup (db, stmts, str, id))
+    return id;
+
+  auto& stmt = stmts.Get (db, sqlInsert);
+  stmt.Bind (1, str);
+  stmt.Execute ();
+
+  CHECK (Lookup (db, stmts, str, id));
+  return id;
+}
+
+} // namespace xid
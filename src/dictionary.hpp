@@ -0,0 +1,117 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_DICTIONARY_HPP
+#define XID_DICTIONARY_HPP
+
+#include "statementregistry.hpp"
+
+#include <xayagame/sqlitestorage.hpp>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace xid
+{
+
+/**
+ * Access to one of the dictionary tables in the database.  They map strings
+ * that are repeated in many rows (names, applications and address keys)
+ * to integer IDs, which the signers and addresses tables reference instead
+ * of storing the strings themselves.
+ *
+ * This is used when updating the game state, and keeps the IDs of strings
+ * cached in memory.  Since undoing a block may remove entries from the
+ * dictionary tables (and their IDs may then be reused), the cache must be
+ * cleared in that case.  Instances are not thread-safe.
+ */
+class Dictionary
+{
+
+private:
+
+  /** Maximum number of IDs held in the cache.  */
+  static constexpr size_t MAX_CACHED = 100'000;
+
+  /** SQL for querying the ID of a string.  */
+  const std::string sqlSelect;
+
+  /** SQL for inserting a new string.  */
+  const std::string sqlInsert;
+
+  /** The cached IDs, keyed by string.  */
+  std::unordered_map<std::string, int64_t> ids;
+
+  /**
+   * Adds an entry to the cache.
+   */
+  void Cache (const std::string& str, int64_t id);
+
+public:
+
+  /**
+   * Constructs the dictionary for the given table.
+   */
+  explicit Dictionary (const std::string& table);
+
+  Dictionary (const Dictionary&) = delete;
+  void operator= (const Dictionary&) = delete;
+
+  /**
+   * Looks up the ID of a string.  Returns false if it is not in the
+   * dictionary table.
+   */
+  bool Lookup (xaya::SQLiteDatabase& db, StatementRegistry& stmts,
+               const std::string& str, int64_t& id);
+
+  /**
+   * Returns the ID of a string, inserting it into the dictionary table
+   * if it is not there yet.
+   */
+  int64_t Intern (xaya::SQLiteDatabase& db, StatementRegistry& stmts,
+                  const std::string& str);
+
+  /**
+   * Clears the cache.
+   */
+  void
+  Clear ()
+  {
+    ids.clear ();
+  }
+
+};
+
+/**
+ * The dictionaries for all interned columns of the game state.
+ */
+struct Dictionaries
+{
+
+  /** Dictionary of Xaya names.  */
+  Dictionary names{"names"};
+
+  /** Dictionary of signer applications.  */
+  Dictionary applications{"applications"};
+
+  /** Dictionary of address keys.  */
+  Dictionary keys{"keys"};
+
+  /**
+   * Clears the caches of all dictionaries.
+   */
+  void
+  Clear ()
+  {
+    names.Clear ();
+    applications.Clear ();
+    keys.Clear ();
+  }
+
+};
+
+} // namespace xid
+
+#endif // XID_DICTIONARY_HPP
@@ -0,0 +1,104 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "dictionary.hpp"
+
+#include "dbtest.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+namespace xid
+{
+namespace
+{
+
+class DictionaryTests : public DBTestWithSchema
+{
+
+protected:
+
+  StatementRegistry stmts;
+  Dictionary dict;
+
+  DictionaryTests ()
+    : dict("names")
+  {}
+
+  /**
+   * Returns the number of rows in the dictionary table.
+   */
+  unsigned
+  CountRows ()
+  {
+    auto stmt = GetDb ().Prepare (R"(
+      SELECT COUNT(*) FROM `names`
+    )");
+    CHECK (stmt.Step ());
+    return stmt.Get<int64_t> (0);
+  }
+
+};
+
+TEST_F (DictionaryTests, InternAndLookup)
+{
+  int64_t id;
+  EXPECT_FALSE (dict.Lookup (GetDb (), stmts, "foo", id));
+  EXPECT_EQ (CountRows (), 0);
+
+  const int64_t foo = dict.Intern (GetDb (), stmts, "foo");
+  const int64_t bar = dict.Intern (GetDb (), stmts, "bar");
+  const int64_t empty = dict.Intern (GetDb (), stmts, "");
+  EXPECT_NE (foo, bar);
+  EXPECT_NE (foo, empty);
+  EXPECT_NE (bar, empty);
+  EXPECT_EQ (CountRows (), 3);
+
+  EXPECT_EQ (dict.Intern (GetDb (), stmts, "foo"), foo);
+  ASSERT_TRUE (dict.Lookup (GetDb (), stmts, "bar", id));
+  EXPECT_EQ (id, bar);
+  EXPECT_EQ (CountRows (), 3);
+}
+
+TEST_F (DictionaryTests, ExistingEntries)
+{
+  GetDb ().Execute (R"(
+    INSERT INTO `names` (`id`, `value`) VALUES (42, 'domob')
+  )");
+
+  int64_t id;
+  ASSERT_TRUE (dict.Lookup (GetDb (), stmts, "domob", id));
+  EXPECT_EQ (id, 42);
+  EXPECT_EQ (dict.Intern (GetDb (), stmts, "domob"), 42);
+  EXPECT_EQ (CountRows (), 1);
+}
+
+TEST_F (DictionaryTests, Cached)
+{
+  const int64_t foo = dict.Intern (GetDb (), stmts, "foo");
+  GetDb ().Execute (R"(
+    UPDATE `names` SET `id` = `id` + 100
+  )");
+
+  /* The cache still returns the old ID until it is cleared.  */
+  EXPECT_EQ (dict.Intern (GetDb (), stmts, "foo"), foo);
+  dict.Clear ();
+  EXPECT_EQ (dict.Intern (GetDb (), stmts, "foo"), foo + 100);
+}
+
+TEST_F (DictionaryTests, StatementsPreparedOnce)
+{
+  dict.Intern (GetDb (), stmts, "foo");
+  dict.Clear ();
+  dict.Intern (GetDb (), stmts, "foo");
+  const unsigned prepared = stmts.GetNumPrepared ();
+
+  for (unsigned i = 0; i < 10; ++i)
+    dict.Intern (GetDb (), stmts, "name " + std::to_string (i));
+  EXPECT_EQ (stmts.GetNumPrepared (), prepared);
+}
+
+} // anonymous namespace
+} // namespace xid
@@ -0,0 +1,266 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "evmabi.hpp"
+
+#include "keccak.hpp"
+
+#include <glog/logging.h>
+
+#include <algorithm>
+
+namespace xid
+{
+
+namespace
+{
+
+/** Size of an ABI word in bytes.  */
+constexpr size_t WORD = 32;
+
+/** Size of an address in bytes.  */
+constexpr size_t ADDRESS_SIZE = 20;
+
+/**
+ * Decodes a hex character to its value.  Returns -1 if it is invalid.
+ */
+int
+DecodeHexChar (const char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * Strips the "0x" prefix from a hex string.  Returns false if it
+ * is not there.
+ */
+bool
+StripHexPrefix (std::string_view& hex)
+{
+  if (hex.size () < 2 || hex[0] != '0' || (hex[1] != 'x' && hex[1] != 'X'))
+    return false;
+  hex.remove_prefix (2);
+  return true;
+}
+
+/**
+ * Encodes string data (without the length) padded to a multiple of
+ * the word size.
+ */
+std::string
+PadRight (const std::string_view data)
+{
+  std::string res(data);
+  res.resize ((data.size () + WORD - 1) / WORD * WORD, '\0');
+  return res;
+}
+
+/**
+ * Encodes a string argument for the tail (length and padded data).
+ */
+std::string
+EncodeStringData (const std::string_view str)
+{
+  return EncodeAbiUint (str.size ()) + PadRight (str);
+}
+
+/**
+ * Returns the first ABI word of return data, or false if there is none.
+ */
+bool
+FirstWord (const std::string_view data, std::string_view& word)
+{
+  if (data.size () < WORD)
+    return false;
+  word = data.substr (0, WORD);
+  return true;
+}
+
+} // anonymous namespace
+
+std::string
+EncodeEvmHex (const std::string_view data)
+{
+  static const char* const HEX_CHARS = "0123456789abcdef";
+
+  std::string res = "0x";
+  res.reserve (2 + 2 * data.size ());
+  for (const unsigned char c : data)
+    {
+      res.push_back (HEX_CHARS[c >> 4]);
+      res.push_back (HEX_CHARS[c & 0xF]);
+    }
+
+  return res;
+}
+
+bool
+DecodeEvmHex (std::string_view hex, std::string& out)
+{
+  if (!StripHexPrefix (hex) || hex.size () % 2 != 0)
+    return false;
+
+  out.clear ();
+  out.reserve (hex.size () / 2);
+  for (size_t i = 0; i < hex.size (); i += 2)
+    {
+      const int hi = DecodeHexChar (hex[i]);
+      const int lo = DecodeHexChar (hex[i + 1]);
+      if (hi < 0 || lo < 0)
+        return false;
+      out.push_back (static_cast<char> ((hi << 4) | lo));
+    }
+
+  return true;
+}
+
+bool
+DecodeEvmQuantity (std::string_view hex, uint64_t& out)
+{
+  if (!StripHexPrefix (hex) || hex.empty () || hex.size () > 16)
+    return false;
+
+  out = 0;
+  for (const char c : hex)
+    {
+      const int val = DecodeHexChar (c);
+      if (val < 0)
+        return false;
+      out = (out << 4) | val;
+    }
+
+  return true;
+}
+
+std::string
+EncodeAbiUint (const uint64_t val)
+{
+  std::string res(WORD, '\0');
+  for (unsigned i = 0; i < 8; ++i)
+    res[WORD - 1 - i] = static_cast<char> ((val >> (8 * i)) & 0xFF);
+  return res;
+}
+
+std::string
+EncodeAbiInt (const int64_t val)
+{
+  std::string res = EncodeAbiUint (static_cast<uint64_t> (val));
+  if (val < 0)
+    std::fill (res.begin (), res.end () - 8, '\xFF');
+  return res;
+}
+
+std::string
+EncodeAbiAddress (const std::string_view addr)
+{
+  CHECK_EQ (addr.size (), ADDRESS_SIZE);
+  return std::string (WORD - ADDRESS_SIZE, '\0') + std::string (addr);
+}
+
+bool
+DecodeAbiBool (const std::string_view data, bool& out)
+{
+  std::string_view word;
+  if (!FirstWord (data, word))
+    return false;
+
+  for (size_t i = 0; i + 1 < WORD; ++i)
+    if (word[i] != '\0')
+      return false;
+
+  switch (word.back ())
+    {
+    case 0:
+      out = false;
+      return true;
+    case 1:
+      out = true;
+      return true;
+    default:
+      return false;
+    }
+}
+
+bool
+DecodeAbiAddress (const std::string_view data, std::string& out)
+{
+  std::string_view word;
+  if (!FirstWord (data, word))
+    return false;
+
+  for (size_t i = 0; i < WORD - ADDRESS_SIZE; ++i)
+    if (word[i] != '\0')
+      return false;
+
+  out = word.substr (WORD - ADDRESS_SIZE);
+  return true;
+}
+
+AbiEncoder::AbiEncoder (const std::string_view signature)
+  : selector(Selector (signature))
+{}
+
+std::string
+AbiEncoder::Selector (const std::string_view signature)
+{
+  return Keccak256 (signature).substr (0, 4);
+}
+
+AbiEncoder&
+AbiEncoder::AddWord (const std::string_view word)
+{
+  CHECK_EQ (word.size (), WORD);
+  args.emplace_back (false, std::string (word));
+  return *this;
+}
+
+AbiEncoder&
+AbiEncoder::AddString (const std::string_view str)
+{
+  args.emplace_back (true, EncodeStringData (str));
+  return *this;
+}
+
+AbiEncoder&
+AbiEncoder::AddStringArray (const std::vector<std::string>& arr)
+{
+  /* The array is encoded as its length, followed by the offsets of
+     the individual strings (relative to after the length) and then
+     their data.  */
+  std::string offsets;
+  std::string data;
+  for (const auto& str : arr)
+    {
+      offsets += EncodeAbiUint (WORD * arr.size () + data.size ());
+      data += EncodeStringData (str);
+    }
+
+  args.emplace_back (true, EncodeAbiUint (arr.size ()) + offsets + data);
+  return *this;
+}
+
+std::string
+AbiEncoder::Finish () const
+{
+  std::string head = selector;
+  std::string tail;
+  for (const auto& arg : args)
+    if (arg.first)
+      {
+        head += EncodeAbiUint (WORD * args.size () + tail.size ());
+        tail += arg.second;
+      }
+    else
+      head += arg.second;
+
+  return head + tail;
+}
+
+} // namespace xid
@@ -0,0 +1,111 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_EVMABI_HPP
+#define XID_EVMABI_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace xid
+{
+
+/**
+ * Encodes raw bytes as lower-case hex string with "0x" prefix, as used
+ * for data in the Ethereum JSON-RPC interface.
+ */
+std::string EncodeEvmHex (std::string_view data);
+
+/**
+ * Decodes a hex string with "0x" prefix into raw bytes.  Returns false
+ * if the string is invalid.
+ */
+bool DecodeEvmHex (std::string_view hex, std::string& out);
+
+/**
+ * Decodes a hex-encoded quantity (like a block number) as returned by the
+ * Ethereum JSON-RPC interface.  Returns false if the string is invalid
+ * or the value does not fit into 64 bits.
+ */
+bool DecodeEvmQuantity (std::string_view hex, uint64_t& out);
+
+/**
+ * Encodes an unsigned integer as 32-byte ABI word.
+ */
+std::string EncodeAbiUint (uint64_t val);
+
+/**
+ * Encodes a signed integer as 32-byte ABI word (in two's complement).
+ */
+std::string EncodeAbiInt (int64_t val);
+
+/**
+ * Encodes a raw 20-byte address as 32-byte ABI word.
+ */
+std::string EncodeAbiAddress (std::string_view addr);
+
+/**
+ * Decodes a bool from the first word of raw ABI-encoded return data.
+ * Returns false if the data is invalid.
+ */
+bool DecodeAbiBool (std::string_view data, bool& out);
+
+/**
+ * Decodes a raw 20-byte address from the first word of raw ABI-encoded
+ * return data.  Returns false if the data is invalid.
+ */
+bool DecodeAbiAddress (std::string_view data, std::string& out);
+
+/**
+ * Builds the calldata for a contract function call with the Solidity ABI.
+ * The arguments have to be added in order, and then the full data can be
+ * retrieved with Finish.  Only the types needed by xid are supported.
+ */
+class AbiEncoder
+{
+
+private:
+
+  /** The 4-byte function selector.  */
+  std::string selector;
+
+  /**
+   * The encoded arguments added so far.  The flag is true for dynamic types,
+   * whose data goes into the tail with an offset in the head.
+   */
+  std::vector<std::pair<bool, std::string>> args;
+
+public:
+
+  /**
+   * Starts building a call to the function with the given canonical
+   * signature (e.g. "ownerOf(uint256)").
+   */
+  explicit AbiEncoder (std::string_view signature);
+
+  /**
+   * Returns the function selector for a given canonical signature.
+   */
+  static std::string Selector (std::string_view signature);
+
+  /** Adds a static argument already encoded as 32-byte word.  */
+  AbiEncoder& AddWord (std::string_view word);
+
+  /** Adds a string argument.  */
+  AbiEncoder& AddString (std::string_view str);
+
+  /** Adds a string[] argument.  */
+  AbiEncoder& AddStringArray (const std::vector<std::string>& arr);
+
+  /** Returns the full calldata as raw bytes.  */
+  std::string Finish () const;
+
+};
+
+} // namespace xid
+
+#endif // XID_EVMABI_HPP
@@ -0,0 +1,154 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "evmabi.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+/**
+ * Decodes a hex string, which must be valid.
+ */
+std::string
+Hex (const std::string& hex)
+{
+  std::string res;
+  CHECK (DecodeEvmHex (hex, res)) << hex;
+  return res;
+}
+
+TEST (EvmHexTests, RoundTrip)
+{
+  std::string data;
+  ASSERT_TRUE (DecodeEvmHex ("0x00Ff10", data));
+  EXPECT_EQ (data, std::string ("\x00\xff\x10", 3));
+  EXPECT_EQ (EncodeEvmHex (data), "0x00ff10");
+
+  ASSERT_TRUE (DecodeEvmHex ("0x", data));
+  EXPECT_EQ (data, "");
+  EXPECT_EQ (EncodeEvmHex (""), "0x");
+}
+
+TEST (EvmHexTests, Invalid)
+{
+  std::string data;
+  EXPECT_FALSE (DecodeEvmHex ("", data));
+  EXPECT_FALSE (DecodeEvmHex ("00", data));
+  EXPECT_FALSE (DecodeEvmHex ("0x0", data));
+  EXPECT_FALSE (DecodeEvmHex ("0x0g", data));
+}
+
+TEST (EvmHexTests, Quantity)
+{
+  uint64_t val;
+  ASSERT_TRUE (DecodeEvmQuantity ("0x0", val));
+  EXPECT_EQ (val, 0);
+  ASSERT_TRUE (DecodeEvmQuantity ("0x89", val));
+  EXPECT_EQ (val, 137);
+  ASSERT_TRUE (DecodeEvmQuantity ("0xffffffffffffffff", val));
+  EXPECT_EQ (val, UINT64_MAX);
+
+  EXPECT_FALSE (DecodeEvmQuantity ("0x", val));
+  EXPECT_FALSE (DecodeEvmQuantity ("89", val));
+  EXPECT_FALSE (DecodeEvmQuantity ("0x1ffffffffffffffff", val));
+}
+
+TEST (AbiTests, Integers)
+{
+  EXPECT_EQ (EncodeAbiUint (0x1234), Hex ("0x" + std::string (60, '0')
+                                            + "1234"));
+  EXPECT_EQ (EncodeAbiInt (123), EncodeAbiUint (123));
+  EXPECT_EQ (EncodeAbiInt (-1), std::string (32, '\xff'));
+  EXPECT_EQ (EncodeAbiInt (-2), std::string (31, '\xff') + "\xfe");
+}
+
+TEST (AbiTests, Selectors)
+{
+  EXPECT_EQ (AbiEncoder::Selector ("ownerOf(uint256)"), Hex ("0x6352211e"));
+  EXPECT_EQ (AbiEncoder::Selector ("getApproved(uint256)"),
+             Hex ("0x081812fc"));
+  EXPECT_EQ (AbiEncoder::Selector ("isApprovedForAll(address,address)"),
+             Hex ("0xe985e9c5"));
+}
+
+TEST (AbiTests, StaticArguments)
+{
+  const std::string addr = Hex ("0x" + std::string (40, 'a'));
+  EXPECT_EQ (AbiEncoder ("isApprovedForAll(address,address)")
+                .AddWord (EncodeAbiAddress (addr))
+                .AddWord (EncodeAbiUint (5))
+                .Finish (),
+             Hex ("0xe985e9c5"
+                  "000000000000000000000000" + std::string (40, 'a')
+                  + std::string (63, '0') + "5"));
+}
+
+TEST (AbiTests, DynamicArguments)
+{
+  /* This is the string[] part of the example from the Solidity
+     ABI specification.  */
+  const std::string data = AbiEncoder ("f(uint256,string,string[])")
+      .AddWord (EncodeAbiUint (42))
+      .AddString ("p")
+      .AddStringArray ({"one", "two", "three"})
+      .Finish ();
+
+  const std::string expected = Hex (
+      "0x"
+      "000000000000000000000000000000000000000000000000000000000000002a"
+      "0000000000000000000000000000000000000000000000000000000000000060"
+      "00000000000000000000000000000000000000000000000000000000000000a0"
+      "0000000000000000000000000000000000000000000000000000000000000001"
+      "7000000000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "0000000000000000000000000000000000000000000000000000000000000060"
+      "00000000000000000000000000000000000000000000000000000000000000a0"
+      "00000000000000000000000000000000000000000000000000000000000000e0"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "6f6e650000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000003"
+      "74776f0000000000000000000000000000000000000000000000000000000000"
+      "0000000000000000000000000000000000000000000000000000000000000005"
+      "7468726565000000000000000000000000000000000000000000000000000000");
+
+  EXPECT_EQ (data.substr (0, 4),
+             AbiEncoder::Selector ("f(uint256,string,string[])"));
+  EXPECT_EQ (data.substr (4), expected);
+}
+
+TEST (AbiTests, DecodeBool)
+{
+  bool val;
+  ASSERT_TRUE (DecodeAbiBool (EncodeAbiUint (1), val));
+  EXPECT_TRUE (val);
+  ASSERT_TRUE (DecodeAbiBool (EncodeAbiUint (0), val));
+  EXPECT_FALSE (val);
+
+  EXPECT_FALSE (DecodeAbiBool (EncodeAbiUint (2), val));
+  EXPECT_FALSE (DecodeAbiBool (EncodeAbiUint (256), val));
+  EXPECT_FALSE (DecodeAbiBool ("", val));
+}
+
+TEST (AbiTests, DecodeAddress)
+{
+  const std::string addr = Hex ("0x" + std::string (40, 'a'));
+
+  std::string val;
+  ASSERT_TRUE (DecodeAbiAddress (EncodeAbiAddress (addr), val));
+  EXPECT_EQ (val, addr);
+
+  EXPECT_FALSE (DecodeAbiAddress (EncodeAbiInt (-1), val));
+  EXPECT_FALSE (DecodeAbiAddress (addr, val));
+}
+
+} // anonymous namespace
+} // namespace xid
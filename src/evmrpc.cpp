@@ -0,0 +1,121 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "evmrpc.hpp"
+
+#include "evmabi.hpp"
+
+#include "rpc-stubs/evmrpcclient.h"
+
+#include <json/json.h>
+#include <jsonrpccpp/client.h>
+#include <jsonrpccpp/client/connectors/httpclient.h>
+
+#include <glog/logging.h>
+
+#include <sstream>
+
+namespace xid
+{
+
+class HttpEvmRpc::Connection
+{
+
+private:
+
+  jsonrpc::HttpClient http;
+
+public:
+
+  EvmRpcClient rpc;
+
+  explicit Connection (const std::string& url)
+    : http(url), rpc(http, jsonrpc::JSONRPC_CLIENT_V2)
+  {}
+
+};
+
+HttpEvmRpc::HttpEvmRpc (const std::string& u)
+  : url(u)
+{}
+
+HttpEvmRpc::~HttpEvmRpc () = default;
+
+template <typename Fcn>
+  bool
+  HttpEvmRpc::WithConnection (const Fcn& fcn)
+{
+  std::unique_ptr<Connection> conn;
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    if (!idle.empty ())
+      {
+        conn = std::move (idle.back ());
+        idle.pop_back ();
+      }
+  }
+  if (conn == nullptr)
+    conn = std::make_unique<Connection> (url);
+
+  bool res;
+  try
+    {
+      res = fcn (conn->rpc);
+    }
+  catch (const jsonrpc::JsonRpcException& exc)
+    {
+      LOG (WARNING) << "EVM RPC call failed: " << exc.what ();
+      res = false;
+    }
+  catch (const Json::Exception& exc)
+    {
+      /* A response of unexpected type (e.g. null instead of a string)
+         may throw when it is converted.  */
+      LOG (WARNING) << "Invalid EVM RPC response: " << exc.what ();
+      res = false;
+    }
+
+  std::lock_guard<std::mutex> lock(mut);
+  idle.push_back (std::move (conn));
+
+  return res;
+}
+
+bool
+HttpEvmRpc::GetChainId (uint64_t& id)
+{
+  return WithConnection ([&id] (EvmRpcClient& rpc)
+    {
+      return DecodeEvmQuantity (rpc.eth_chainId (), id);
+    });
+}
+
+bool
+HttpEvmRpc::GetBlockNumber (uint64_t& num)
+{
+  return WithConnection ([&num] (EvmRpcClient& rpc)
+    {
+      return DecodeEvmQuantity (rpc.eth_blockNumber (), num);
+    });
+}
+
+bool
+HttpEvmRpc::Call (const std::string& to, const std::string& data,
+                  const uint64_t block, std::string& result)
+{
+  Json::Value tx(Json::objectValue);
+  tx["to"] = EncodeEvmHex (to);
+  tx["data"] = EncodeEvmHex (data);
+
+  /* Block numbers are passed as hex quantities without leading zeros.  */
+  std::ostringstream blockHex;
+  blockHex << "0x" << std::hex << block;
+
+  return WithConnection ([&] (EvmRpcClient& rpc)
+    {
+      return DecodeEvmHex (rpc.eth_call (tx, blockHex.str ()), result);
+    });
+}
+
+} // namespace xid
@@ -0,0 +1,62 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_EVMRPC_HPP
+#define XID_EVMRPC_HPP
+
+#include "delegation.hpp"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xid
+{
+
+/**
+ * EvmRpc implementation that talks to an EVM node through JSON-RPC
+ * over HTTP.  Since the underlying HTTP clients cannot be used from
+ * multiple threads at the same time, each call takes one from a pool
+ * of idle connections (or creates a new one).
+ */
+class HttpEvmRpc : public EvmRpc
+{
+
+private:
+
+  class Connection;
+
+  /** The endpoint URL.  */
+  const std::string url;
+
+  /** Lock for the idle connections.  */
+  std::mutex mut;
+
+  /** Connections that are not in use at the moment.  */
+  std::vector<std::unique_ptr<Connection>> idle;
+
+  /**
+   * Runs the given function with an idle connection, and returns the
+   * connection to the pool afterwards.  Returns false (and logs) if the
+   * call throws a JSON-RPC error.
+   */
+  template <typename Fcn>
+    bool WithConnection (const Fcn& fcn);
+
+public:
+
+  explicit HttpEvmRpc (const std::string& u);
+  ~HttpEvmRpc ();
+
+  bool GetChainId (uint64_t& id) override;
+  bool GetBlockNumber (uint64_t& num) override;
+  bool Call (const std::string& to, const std::string& data,
+             uint64_t block, std::string& result) override;
+
+};
+
+} // namespace xid
+
+#endif // XID_EVMRPC_HPP
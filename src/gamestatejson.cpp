@@ -1,12 +1,16 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "gamestatejson.hpp"
 
+#include "signeraddress.hpp"
+
 #include <glog/logging.h>
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <set>
 
 namespace xid
@@ -31,85 +35,479 @@ SignerArrayToJson (const SignerArray& arr)
 }
 
 /**
- * Retrieves the signers value of a name as JSON.
+ * Start of the query for (name, application, address) of signers, with
+ * the names and applications resolved from their dictionary tables.
+ * The address is followed by whether it is binary (for GetSignerAddress).
+ * WHERE and ORDER BY clauses can be appended, referring to the name
+ * as `n`.`value`.
+ *
+ * The CROSS JOIN makes SQLite go through the names dictionary as the
+ * outer loop, so that rows are returned in order of names using its
+ * index, without sorting the whole result.
+ */
+const std::string SELECT_SIGNERS = R"(
+    SELECT `n`.`value`, `a`.`value`,
+           `s`.`address`, typeof (`s`.`address`) = 'blob'
+      FROM `names` AS `n`
+        CROSS JOIN `signers` AS `s` ON `s`.`name_id` = `n`.`id`
+        LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`
+)";
+
+/**
+ * Start of the query for (name, key, address) of address associations,
+ * similar to SELECT_SIGNERS.
+ */
+const std::string SELECT_ADDRESSES = R"(
+    SELECT `n`.`value`, `k`.`value`, `d`.`address`
+      FROM `names` AS `n`
+        CROSS JOIN `addresses` AS `d` ON `d`.`name_id` = `n`.`id`
+        INNER JOIN `keys` AS `k` ON `k`.`id` = `d`.`key_id`
+)";
+
+/**
+ * Helper class that reads the states of names from the database.  It takes
+ * two statements, which must query (name, application, address) for
+ * signers and (name, key, address) for addresses (see SELECT_SIGNERS
+ * and SELECT_ADDRESSES), respectively.  Both must be ordered by name.
+ * The reader then merges them and returns the full state of each name
+ * in turn.
+ *
+ * This allows retrieving the states for many names (e.g. the full game
+ * state) with a single scan over each table, instead of having to run
+ * separate queries for each name.
+ */
+class NameStateReader
+{
+
+private:
+
+  /** The statement querying signers.  */
+  xaya::SQLiteDatabase::Statement& signers;
+
+  /** The statement querying addresses.  */
+  xaya::SQLiteDatabase::Statement& addresses;
+
+  /** Whether the signers statement has a current row.  */
+  bool hasSigner;
+
+  /** Whether the addresses statement has a current row.  */
+  bool hasAddress;
+
+  /**
+   * Reads all signer rows for the given name (starting at the current row)
+   * and returns the corresponding JSON value.
+   */
+  Json::Value
+  ReadSigners (const std::string& name)
+  {
+    SignerArray globalSigners;
+    std::map<std::string, SignerArray> appSigners;
+    for (; hasSigner && signers.Get<std::string> (0) == name;
+         hasSigner = signers.Step ())
+      {
+        SignerArray* arrayRef = nullptr;
+        if (signers.IsNull (1))
+          arrayRef = &globalSigners;
+        else
+          arrayRef = &appSigners[signers.Get<std::string> (1)];
+        CHECK (arrayRef != nullptr);
+
+        arrayRef->emplace (GetSignerAddress (signers, 2));
+      }
+
+    Json::Value res(Json::arrayValue);
+    if (!globalSigners.empty ())
+      {
+        Json::Value globalSignersJson(Json::objectValue);
+        globalSignersJson["addresses"] = SignerArrayToJson (globalSigners);
+        res.append (globalSignersJson);
+      }
+    for (const auto& entry : appSigners)
+      {
+        Json::Value curJson(Json::objectValue);
+        curJson["application"] = entry.first;
+        curJson["addresses"] = SignerArrayToJson (entry.second);
+        res.append (curJson);
+      }
+
+    return res;
+  }
+
+  /**
+   * Reads all address rows for the given name (starting at the current row)
+   * and returns the corresponding JSON value.
+   */
+  Json::Value
+  ReadAddresses (const std::string& name)
+  {
+    Json::Value res(Json::objectValue);
+    for (; hasAddress && addresses.Get<std::string> (0) == name;
+         hasAddress = addresses.Step ())
+      {
+        const auto key = addresses.Get<std::string> (1);
+        const auto addr = addresses.Get<std::string> (2);
+
+        CHECK (!res.isMember (key));
+        res[key] = addr;
+      }
+
+    return res;
+  }
+
+public:
+
+  explicit NameStateReader (xaya::SQLiteDatabase::Statement& s,
+                            xaya::SQLiteDatabase::Statement& a)
+    : signers(s), addresses(a)
+  {
+    hasSigner = signers.Step ();
+    hasAddress = addresses.Step ();
+  }
+
+  NameStateReader () = delete;
+  NameStateReader (const NameStateReader&) = delete;
+  void operator= (const NameStateReader&) = delete;
+
+  /**
+   * Returns true if there are more names to read.
+   */
+  bool
+  HasMore () const
+  {
+    return hasSigner || hasAddress;
+  }
+
+  /**
+   * Reads the state of the next name.  Returns false if there are no
+   * more names.
+   */
+  bool
+  Next (std::string& name, Json::Value& state)
+  {
+    if (hasSigner && hasAddress)
+      name = std::min (signers.Get<std::string> (0),
+                       addresses.Get<std::string> (0));
+    else if (hasSigner)
+      name = signers.Get<std::string> (0);
+    else if (hasAddress)
+      name = addresses.Get<std::string> (0);
+    else
+      return false;
+
+    state = Json::Value (Json::objectValue);
+    state["name"] = name;
+    state["signers"] = ReadSigners (name);
+    state["addresses"] = ReadAddresses (name);
+
+    return true;
+  }
+
+};
+
+/**
+ * Returns the state of a name that has no data in the database.
  */
 Json::Value
-GetNameSigners (const xaya::SQLiteDatabase& db, const std::string& name)
+EmptyNameState (const std::string& name)
 {
-  auto stmt = db.PrepareRo (R"(
-    SELECT `application`, `address`
-      FROM `signers`
-      WHERE `name` = ?1
+  Json::Value res(Json::objectValue);
+  res["name"] = name;
+  res["signers"] = Json::Value (Json::arrayValue);
+  res["addresses"] = Json::Value (Json::objectValue);
+
+  return res;
+}
+
+} // anonymous namespace
+
+Json::Value
+GetNameState (const xaya::SQLiteDatabase& db, const std::string& name)
+{
+  auto stmtSigners = db.PrepareRo (SELECT_SIGNERS + R"(
+      WHERE `n`.`value` = ?1
   )");
-  stmt.Bind (1, name);
+  stmtSigners.Bind (1, name);
 
-  SignerArray globalSigners;
-  std::map<std::string, SignerArray> signers;
-  while (stmt.Step ())
+  auto stmtAddresses = db.PrepareRo (SELECT_ADDRESSES + R"(
+      WHERE `n`.`value` = ?1
+  )");
+  stmtAddresses.Bind (1, name);
+
+  NameStateReader reader(stmtSigners, stmtAddresses);
+  std::string readName;
+  Json::Value res;
+  if (reader.Next (readName, res))
     {
-      SignerArray* arrayRef = nullptr;
-      if (stmt.IsNull (0))
-        arrayRef = &globalSigners;
-      else
-        arrayRef = &signers[stmt.Get<std::string> (0)];
-      CHECK (arrayRef != nullptr);
+      CHECK_EQ (readName, name);
+      CHECK (!reader.Next (readName, res));
+      return res;
+    }
+
+  return EmptyNameState (name);
+}
+
+bool
+ParseNameList (const Json::Value& val, std::vector<std::string>& names)
+{
+  if (!val.isArray () || val.size () > MAX_NAMES_PER_BATCH)
+    return false;
 
-      arrayRef->emplace (stmt.Get<std::string> (1));
+  names.clear ();
+  for (const auto& entry : val)
+    {
+      if (!entry.isString ())
+        return false;
+      names.push_back (entry.asString ());
     }
 
+  return true;
+}
+
+Json::Value
+GetNameStates (const xaya::SQLiteDatabase& db,
+               const std::vector<std::string>& names)
+{
+  CHECK_LE (names.size (), MAX_NAMES_PER_BATCH);
+
   Json::Value res(Json::arrayValue);
-  if (!globalSigners.empty ())
+  const std::set<std::string> unique(names.begin (), names.end ());
+  if (unique.empty ())
+    return res;
+
+  /* We query all names with one statement per table, using an IN clause
+     with a placeholder for each (distinct) name.  The batch size is limited
+     so that this stays below SQLite's limit on the number of variables.  */
+
+  std::string placeholders;
+  for (unsigned i = 1; i <= unique.size (); ++i)
+    {
+      if (i > 1)
+        placeholders += ", ";
+      placeholders += "?" + std::to_string (i);
+    }
+
+  auto stmtSigners = db.PrepareRo (SELECT_SIGNERS + R"(
+      WHERE `n`.`value` IN ()" + placeholders + R"()
+      ORDER BY `n`.`value`
+  )");
+  auto stmtAddresses = db.PrepareRo (SELECT_ADDRESSES + R"(
+      WHERE `n`.`value` IN ()" + placeholders + R"()
+      ORDER BY `n`.`value`
+  )");
+
+  int ind = 1;
+  for (const auto& n : unique)
     {
-      Json::Value globalSignersJson(Json::objectValue);
-      globalSignersJson["addresses"] = SignerArrayToJson (globalSigners);
-      res.append (globalSignersJson);
+      stmtSigners.Bind (ind, n);
+      stmtAddresses.Bind (ind, n);
+      ++ind;
     }
-  for (const auto& entry : signers)
+
+  std::map<std::string, Json::Value> states;
+  NameStateReader reader(stmtSigners, stmtAddresses);
+  std::string name;
+  Json::Value state;
+  while (reader.Next (name, state))
+    states.emplace (name, std::move (state));
+
+  for (const auto& n : names)
     {
-      Json::Value curJson(Json::objectValue);
-      curJson["application"] = entry.first;
-      curJson["addresses"] = SignerArrayToJson (entry.second);
-      res.append (curJson);
+      const auto mit = states.find (n);
+      if (mit == states.end ())
+        res.append (EmptyNameState (n));
+      else
+        res.append (mit->second);
     }
 
   return res;
 }
 
+namespace
+{
+
 /**
- * Retrieves all address associations for a name as JSON.
+ * Prefix of all cursors returned by ListNames.  It ensures that no cursor
+ * is empty (which means to start from the beginning), even for the empty
+ * string as last returned name.
  */
+constexpr char CURSOR_PREFIX = 'n';
+
+/**
+ * Encodes a name as cursor for ListNames.  The cursor is the hex
+ * representation of the last returned name after CURSOR_PREFIX, which
+ * is safe to use e.g. inside URL paths.
+ */
+std::string
+EncodeNameCursor (const std::string& name)
+{
+  static const char* const HEX_CHARS = "0123456789abcdef";
+
+  std::string res(1, CURSOR_PREFIX);
+  res.reserve (1 + 2 * name.size ());
+  for (const unsigned char c : name)
+    {
+      res.push_back (HEX_CHARS[c >> 4]);
+      res.push_back (HEX_CHARS[c & 0xF]);
+    }
+
+  return res;
+}
+
+/**
+ * Decodes a hex character to its value.  Returns -1 if it is invalid.
+ */
+int
+DecodeHexChar (const char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * Decodes a (non-empty) ListNames cursor back to the name.  Returns false
+ * if it is invalid.
+ */
+bool
+DecodeNameCursor (const std::string& cursor, std::string& name)
+{
+  if (cursor.empty () || cursor[0] != CURSOR_PREFIX
+        || cursor.size () % 2 != 1)
+    return false;
+
+  name.clear ();
+  name.reserve (cursor.size () / 2);
+  for (size_t i = 1; i < cursor.size (); i += 2)
+    {
+      const int hi = DecodeHexChar (cursor[i]);
+      const int lo = DecodeHexChar (cursor[i + 1]);
+      if (hi < 0 || lo < 0)
+        return false;
+      name.push_back (static_cast<char> ((hi << 4) | lo));
+    }
+
+  return true;
+}
+
+/**
+ * Prepares the statements for a NameStateReader that goes through all names
+ * in the database.
+ */
+void
+PrepareAllNames (const xaya::SQLiteDatabase& db,
+                 xaya::SQLiteDatabase::Statement& stmtSigners,
+                 xaya::SQLiteDatabase::Statement& stmtAddresses)
+{
+  stmtSigners = db.PrepareRo (SELECT_SIGNERS + R"(
+      ORDER BY `n`.`value`
+  )");
+  stmtAddresses = db.PrepareRo (SELECT_ADDRESSES + R"(
+      ORDER BY `n`.`value`
+  )");
+}
+
+} // anonymous namespace
+
+bool
+ListNames (const xaya::SQLiteDatabase& db, const std::string& cursor,
+           const unsigned count, Json::Value& res)
+{
+  CHECK_GT (count, 0);
+  CHECK_LE (count, MAX_NAMES_PER_PAGE);
+
+  /* We use keyset pagination on the name, i.e. select all rows with names
+     after the last one returned, in order of names.  This can use the index
+     of the names dictionary directly, and then the index on signers and
+     the primary key of addresses.  The reader steps
+     the cursors lazily, so only rows for the returned names are read.
+
+     An empty cursor corresponds to starting from the empty string.  But
+     since the empty string itself is a valid name, we use >= in this case
+     instead of >.  Encoded cursors are never empty, also not for the
+     empty name.  */
+
+  std::string after;
+  if (!cursor.empty () && !DecodeNameCursor (cursor, after))
+    return false;
+
+  const std::string cmp = cursor.empty () ? ">=" : ">";
+
+  auto stmtSigners = db.PrepareRo (SELECT_SIGNERS + R"(
+      WHERE `n`.`value` )" + cmp + R"( ?1
+      ORDER BY `n`.`value`
+  )");
+  stmtSigners.Bind (1, after);
+
+  auto stmtAddresses = db.PrepareRo (SELECT_ADDRESSES + R"(
+      WHERE `n`.`value` )" + cmp + R"( ?1
+      ORDER BY `n`.`value`
+  )");
+  stmtAddresses.Bind (1, after);
+
+  NameStateReader reader(stmtSigners, stmtAddresses);
+  Json::Value names(Json::arrayValue);
+  std::string name;
+  Json::Value state;
+  while (names.size () < count && reader.Next (name, state))
+    names.append (std::move (state));
+
+  res = Json::Value (Json::objectValue);
+  res["names"] = std::move (names);
+  if (reader.HasMore ())
+    res["next"] = EncodeNameCursor (name);
+  else
+    res["next"] = Json::Value ();
+
+  return true;
+}
+
 Json::Value
-GetNameAddresses (const xaya::SQLiteDatabase& db, const std::string& name)
+LookupSigner (const xaya::SQLiteDatabase& db, const std::string& address)
 {
+  /* NULL applications (global signers) are ordered first.  */
   auto stmt = db.PrepareRo (R"(
-    SELECT `key`, `address`
-      FROM `addresses`
-      WHERE `name` = ?1
+    SELECT DISTINCT `n`.`value` AS `name`, `a`.`value` AS `application`
+      FROM `signers` AS `s`
+        INNER JOIN `names` AS `n` ON `n`.`id` = `s`.`name_id`
+        LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`
+      WHERE `s`.`address` = ?1
+      ORDER BY `name`, `application`
   )");
-  stmt.Bind (1, name);
+  BindSignerAddress (stmt, 1, address);
 
-  Json::Value res(Json::objectValue);
+  Json::Value res(Json::arrayValue);
   while (stmt.Step ())
     {
-      const auto key = stmt.Get<std::string> (0);
-      const auto addr = stmt.Get<std::string> (1);
-
-      CHECK (!res.isMember (key));
-      res[key] = addr;
+      Json::Value entry(Json::objectValue);
+      entry["name"] = stmt.Get<std::string> (0);
+      if (!stmt.IsNull (1))
+        entry["application"] = stmt.Get<std::string> (1);
+      res.append (entry);
     }
 
   return res;
 }
 
-} // anonymous namespace
-
 Json::Value
-GetNameState (const xaya::SQLiteDatabase& db, const std::string& name)
+LookupAddress (const xaya::SQLiteDatabase& db, const std::string& key,
+               const std::string& address)
 {
-  Json::Value res(Json::objectValue);
-  res["name"] = name;
-  res["signers"] = GetNameSigners (db, name);
-  res["addresses"] = GetNameAddresses (db, name);
+  auto stmt = db.PrepareRo (R"(
+    SELECT `n`.`value`
+      FROM `keys` AS `k`
+        INNER JOIN `addresses` AS `d` ON `d`.`key_id` = `k`.`id`
+        INNER JOIN `names` AS `n` ON `n`.`id` = `d`.`name_id`
+      WHERE `k`.`value` = ?1 AND `d`.`address` = ?2
+      ORDER BY `n`.`value`
+  )");
+  stmt.Bind (1, key);
+  stmt.Bind (2, address);
+
+  Json::Value res(Json::arrayValue);
+  while (stmt.Step ())
+    res.append (stmt.Get<std::string> (0));
 
   return res;
 }
@@ -117,17 +515,17 @@ GetNameState (const xaya::SQLiteDatabase& db, const std::string& name)
 Json::Value
 GetFullState (const xaya::SQLiteDatabase& db)
 {
-  auto stmt = db.PrepareRo (R"(
-    SELECT DISTINCT `name` FROM `signers`
-    UNION SELECT DISTINCT `name` FROM `addresses`
-  )");
+  xaya::SQLiteDatabase::Statement stmtSigners, stmtAddresses;
+  PrepareAllNames (db, stmtSigners, stmtAddresses);
 
+  NameStateReader reader(stmtSigners, stmtAddresses);
   Json::Value names(Json::objectValue);
-  while (stmt.Step ())
+  std::string name;
+  Json::Value state;
+  while (reader.Next (name, state))
     {
-      const auto name = stmt.Get<std::string> (0);
       CHECK (!names.isMember (name));
-      names[name] = GetNameState (db, name);
+      names[name].swap (state);
     }
 
   Json::Value res(Json::objectValue);
@@ -136,4 +534,40 @@ GetFullState (const xaya::SQLiteDatabase& db)
   return res;
 }
 
+void
+WriteFullState (const xaya::SQLiteDatabase& db, std::ostream& out)
+{
+  xaya::SQLiteDatabase::Statement stmtSigners, stmtAddresses;
+  PrepareAllNames (db, stmtSigners, stmtAddresses);
+
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+  const std::unique_ptr<Json::StreamWriter> writer(wbuilder.newStreamWriter ());
+
+  /* Names are returned in the order of SQLite's BINARY collation, which
+     is the same as the order of keys in a Json::Value object.  Thus the
+     result is the same as serialising GetFullState.  */
+
+  out << R"({"names":{)";
+
+  NameStateReader reader(stmtSigners, stmtAddresses);
+  std::string name;
+  Json::Value state;
+  bool first = true;
+  while (reader.Next (name, state))
+    {
+      if (!first)
+        out << ',';
+      first = false;
+
+      /* Names may contain NUL characters, so they are passed with their
+         full length instead of as C string.  */
+      writer->write (Json::Value (name), &out);
+      out << ':';
+      writer->write (state, &out);
+    }
+
+  out << "}}";
+}
+
 } // namespace xid
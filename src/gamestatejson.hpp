@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -9,7 +9,9 @@
 
 #include <json/json.h>
 
+#include <ostream>
 #include <string>
+#include <vector>
 
 namespace xid
 {
@@ -21,13 +23,75 @@ namespace xid
 Json::Value GetNameState (const xaya::SQLiteDatabase& db,
                           const std::string& name);
 
+/** Maximum number of names that can be requested in one batch.  */
+constexpr unsigned MAX_NAMES_PER_BATCH = 500;
+
+/**
+ * Parses a JSON value as list of names for GetNameStates.  It must be an
+ * array of strings with at most MAX_NAMES_PER_BATCH entries.  Returns false
+ * if the value is invalid.
+ */
+bool ParseNameList (const Json::Value& val, std::vector<std::string>& names);
+
+/**
+ * Returns the states of multiple names as JSON array, in the order (and
+ * including any duplicates) of the given list.  All names are read with
+ * one query per table.
+ */
+Json::Value GetNameStates (const xaya::SQLiteDatabase& db,
+                           const std::vector<std::string>& names);
+
+/** Maximum number of names that can be requested in one ListNames call.  */
+constexpr unsigned MAX_NAMES_PER_PAGE = 1'000;
+
+/**
+ * Returns the states of up to count names (which must be between 1 and
+ * MAX_NAMES_PER_PAGE) in the order of names.  If cursor is empty, the
+ * first names are returned.  Otherwise, it must be a cursor returned by
+ * a previous call, and names after it are returned.
+ *
+ * The result is a JSON object with the name states in a "names" array,
+ * and the cursor for the next page in "next" (or null if there are
+ * no more names).
+ *
+ * If the cursor is invalid, false is returned.
+ */
+bool ListNames (const xaya::SQLiteDatabase& db, const std::string& cursor,
+                unsigned count, Json::Value& res);
+
+/**
+ * Returns all names and applications that the given address is a signer for,
+ * as JSON array ordered by name.  Each entry is an object with the "name",
+ * and the "application" unless the address is a global signer.
+ */
+Json::Value LookupSigner (const xaya::SQLiteDatabase& db,
+                          const std::string& address);
+
+/**
+ * Returns all names that have the given crypto address associated for the
+ * given key, as JSON array of strings ordered by name.
+ */
+Json::Value LookupAddress (const xaya::SQLiteDatabase& db,
+                           const std::string& key,
+                           const std::string& address);
+
 /**
- * Returns the entire game state.  This method is not meant to be very
- * efficient.  More specific methods (e.g. GetNameState) should be preferred
- * where possible in production environments.
+ * Returns the entire game state.  It is retrieved with a single ordered scan
+ * over each table, but the result can still be very large.  More specific
+ * methods (e.g. GetNameState) should be preferred where possible in
+ * production environments.
  */
 Json::Value GetFullState (const xaya::SQLiteDatabase& db);
 
+/**
+ * Writes the entire game state (as returned by GetFullState) as JSON text
+ * to the given stream.  The data is serialised name by name directly from
+ * the database cursors, so that only one name is held as Json::Value
+ * at a time.  Whether the total memory usage is bounded depends on the
+ * stream (e.g. a string stream still holds the entire text).
+ */
+void WriteFullState (const xaya::SQLiteDatabase& db, std::ostream& out);
+
 } // namespace xid
 
 #endif // XID_GAMESTATEJSON_HPP
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -13,6 +13,10 @@
 
 #include <json/json.h>
 
+#include <sstream>
+#include <string>
+#include <vector>
+
 namespace xid
 {
 
@@ -46,9 +50,9 @@ TEST_F (GetNameStateTests, Empty)
 TEST_F (GetNameStateTests, NameFiltering)
 {
   GetDb ().Execute (R"(
-    INSERT INTO `signers` (`name`, `application`, `address`)
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
       VALUES ("domob", NULL, "global");
-    INSERT INTO `addresses` (`name`, `key`, `address`)
+    INSERT INTO `test_addresses` (`name`, `key`, `address`)
       VALUES ("domob", "btc", "1domob");
   )");
 
@@ -62,7 +66,7 @@ TEST_F (GetNameStateTests, NameFiltering)
 TEST_F (GetNameStateTests, Signers)
 {
   GetDb ().Execute (R"(
-    INSERT INTO `signers` (`name`, `application`, `address`)
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
       VALUES ("domob", NULL, "global 1"),
              ("domob", NULL, "global 2"),
              ("domob", "", "empty"),
@@ -88,7 +92,7 @@ TEST_F (GetNameStateTests, Signers)
 TEST_F (GetNameStateTests, Addresses)
 {
   GetDb ().Execute (R"(
-    INSERT INTO `addresses` (`name`, `key`, `address`)
+    INSERT INTO `test_addresses` (`name`, `key`, `address`)
       VALUES ("domob", "btc", "1domob"),
              ("domob", "eth", "0xDomob"),
              ("domob", "", "empty")
@@ -105,6 +109,94 @@ TEST_F (GetNameStateTests, Addresses)
 
 /* ************************************************************************** */
 
+class GetNameStatesTests : public DBTestWithSchema
+{
+
+protected:
+
+  GetNameStatesTests ()
+  {
+    GetDb ().Execute (R"(
+      INSERT INTO `test_signers` (`name`, `application`, `address`)
+        VALUES ("domob", NULL, "domob 1"),
+               ("domob", "app", "domob 2"),
+               ("foo", NULL, "foo");
+      INSERT INTO `test_addresses` (`name`, `key`, `address`)
+        VALUES ("domob", "btc", "1domob"),
+               ("bar", "eth", "0x123456");
+    )");
+  }
+
+  /**
+   * Parses the given JSON list of names and returns their states.
+   */
+  Json::Value
+  GetNameStates (const std::string& namesJson)
+  {
+    std::vector<std::string> names;
+    CHECK (ParseNameList (ParseJson (namesJson), names));
+    return xid::GetNameStates (GetDb (), names);
+  }
+
+};
+
+TEST_F (GetNameStatesTests, ParseNameList)
+{
+  std::vector<std::string> names;
+  EXPECT_FALSE (ParseNameList (ParseJson ("{}"), names));
+  EXPECT_FALSE (ParseNameList (ParseJson ("\"foo\""), names));
+  EXPECT_FALSE (ParseNameList (ParseJson ("[\"foo\", 42]"), names));
+
+  Json::Value tooMany(Json::arrayValue);
+  for (unsigned i = 0; i <= MAX_NAMES_PER_BATCH; ++i)
+    tooMany.append ("name");
+  EXPECT_FALSE (ParseNameList (tooMany, names));
+
+  ASSERT_TRUE (ParseNameList (ParseJson ("[\"foo\", \"\", \"foo\"]"),
+                              names));
+  EXPECT_EQ (names, std::vector<std::string> ({"foo", "", "foo"}));
+}
+
+TEST_F (GetNameStatesTests, Empty)
+{
+  EXPECT_TRUE (JsonEquals (GetNameStates ("[]"), "[]"));
+}
+
+TEST_F (GetNameStatesTests, SameAsGetNameState)
+{
+  const std::vector<std::string> names
+      = {"foo", "unknown", "domob", "bar", "", "foo"};
+  Json::Value namesJson(Json::arrayValue);
+  for (const auto& n : names)
+    namesJson.append (n);
+
+  std::vector<std::string> parsed;
+  ASSERT_TRUE (ParseNameList (namesJson, parsed));
+  const auto res = xid::GetNameStates (GetDb (), parsed);
+
+  ASSERT_EQ (res.size (), names.size ());
+  for (unsigned i = 0; i < names.size (); ++i)
+    EXPECT_EQ (res[i], xid::GetNameState (GetDb (), names[i]));
+}
+
+TEST_F (GetNameStatesTests, MaximumBatch)
+{
+  Json::Value namesJson(Json::arrayValue);
+  for (unsigned i = 0; i < MAX_NAMES_PER_BATCH; ++i)
+    namesJson.append ("name " + std::to_string (i));
+  namesJson[0] = "domob";
+
+  std::vector<std::string> names;
+  ASSERT_TRUE (ParseNameList (namesJson, names));
+  const auto res = xid::GetNameStates (GetDb (), names);
+
+  ASSERT_EQ (res.size (), MAX_NAMES_PER_BATCH);
+  EXPECT_EQ (res[0], xid::GetNameState (GetDb (), "domob"));
+  EXPECT_EQ (res[1], xid::GetNameState (GetDb (), "name 1"));
+}
+
+/* ************************************************************************** */
+
 class GetFullStateTests : public DBTestWithSchema
 {
 
@@ -131,11 +223,11 @@ TEST_F (GetFullStateTests, Empty)
 TEST_F (GetFullStateTests, WithNames)
 {
   GetDb ().Execute (R"(
-    INSERT INTO `signers` (`name`, `application`, `address`)
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
       VALUES ("domob", NULL, "domob 1"),
              ("domob", NULL, "domob 2"),
              ("foo", NULL, "foo");
-    INSERT INTO `addresses` (`name`, `key`, `address`)
+    INSERT INTO `test_addresses` (`name`, `key`, `address`)
       VALUES ("domob", "btc", "1domob"),
              ("bar", "eth", "0x123456");
   )");
@@ -177,6 +269,313 @@ TEST_F (GetFullStateTests, WithNames)
   })"));
 }
 
+TEST_F (GetFullStateTests, InterleavedNames)
+{
+  /* Insert data for many names, where some have only signers, some only
+     addresses and some both, to verify the merging of the two tables.  */
+  auto stmtSigner = GetDb ().Prepare (R"(
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
+      VALUES (?1, ?2, ?3)
+  )");
+  auto stmtAddress = GetDb ().Prepare (R"(
+    INSERT INTO `test_addresses` (`name`, `key`, `address`)
+      VALUES (?1, ?2, ?3)
+  )");
+  for (unsigned i = 0; i < 100; ++i)
+    {
+      const std::string name = "name " + std::to_string (i);
+      if (i % 3 != 0)
+        {
+          stmtSigner.Reset ();
+          stmtSigner.Bind (1, name);
+          stmtSigner.BindNull (2);
+          stmtSigner.Bind<std::string> (3, "global");
+          stmtSigner.Execute ();
+
+          stmtSigner.Reset ();
+          stmtSigner.Bind<std::string> (2, "app");
+          stmtSigner.Bind (3, "app " + std::to_string (i));
+          stmtSigner.Execute ();
+        }
+      if (i % 2 != 0)
+        {
+          stmtAddress.Reset ();
+          stmtAddress.Bind (1, name);
+          stmtAddress.Bind<std::string> (2, "btc");
+          stmtAddress.Bind (3, "btc " + std::to_string (i));
+          stmtAddress.Execute ();
+        }
+    }
+
+  const auto state = GetFullState ()["names"];
+  EXPECT_EQ (state.size (), 83);
+  for (const auto& name : state.getMemberNames ())
+    EXPECT_EQ (state[name], xid::GetNameState (GetDb (), name));
+}
+
+/* ************************************************************************** */
+
+class ListNamesTests : public DBTestWithSchema
+{
+
+protected:
+
+  ListNamesTests ()
+  {
+    GetDb ().Execute (R"(
+      INSERT INTO `test_signers` (`name`, `application`, `address`)
+        VALUES ("", NULL, "empty"),
+               ("domob", NULL, "domob 1"),
+               ("domob", "app", "domob 2"),
+               ("foo", NULL, "foo");
+      INSERT INTO `test_addresses` (`name`, `key`, `address`)
+        VALUES ("domob", "btc", "1domob"),
+               ("bar", "eth", "0x123456"),
+               ("zzz", "btc", "1zzz");
+    )");
+  }
+
+  /**
+   * Calls ListNames and expects it to succeed, returning the result.
+   */
+  Json::Value
+  ListNames (const std::string& cursor, const unsigned count)
+  {
+    Json::Value res;
+    CHECK (xid::ListNames (GetDb (), cursor, count, res));
+    return res;
+  }
+
+  /**
+   * Goes through all pages with the given count, and returns all names
+   * and the number of pages.
+   */
+  std::vector<std::string>
+  AllPages (const unsigned count, unsigned& pages)
+  {
+    std::vector<std::string> names;
+    std::string cursor;
+    pages = 0;
+    while (true)
+      {
+        const auto res = ListNames (cursor, count);
+        ++pages;
+        CHECK_LE (pages, 100) << "Pagination does not terminate";
+        EXPECT_LE (res["names"].size (), count);
+        for (const auto& n : Names (res))
+          names.push_back (n);
+        if (res["next"].isNull ())
+          break;
+        cursor = res["next"].asString ();
+        EXPECT_FALSE (cursor.empty ());
+      }
+
+    return names;
+  }
+
+  /**
+   * Extracts the list of names from a ListNames result.
+   */
+  static std::vector<std::string>
+  Names (const Json::Value& res)
+  {
+    std::vector<std::string> names;
+    for (const auto& entry : res["names"])
+      names.push_back (entry["name"].asString ());
+    return names;
+  }
+
+};
+
+TEST_F (ListNamesTests, AllInOnePage)
+{
+  const auto res = ListNames ("", 10);
+  EXPECT_EQ (Names (res), std::vector<std::string> (
+      {"", "bar", "domob", "foo", "zzz"}));
+  EXPECT_TRUE (res["next"].isNull ());
+
+  for (const auto& entry : res["names"])
+    EXPECT_EQ (entry, xid::GetNameState (GetDb (), entry["name"].asString ()));
+}
+
+TEST_F (ListNamesTests, ExactlyFullPage)
+{
+  const auto res = ListNames ("", 5);
+  EXPECT_EQ (res["names"].size (), 5);
+  EXPECT_TRUE (res["next"].isNull ());
+}
+
+TEST_F (ListNamesTests, Pagination)
+{
+  unsigned pages;
+  EXPECT_EQ (AllPages (2, pages), std::vector<std::string> (
+      {"", "bar", "domob", "foo", "zzz"}));
+  EXPECT_EQ (pages, 3);
+}
+
+TEST_F (ListNamesTests, SingleNamePages)
+{
+  /* The first page ends on the empty name here, whose cursor must not be
+     confused with the empty start cursor.  */
+  const auto first = ListNames ("", 1);
+  EXPECT_EQ (Names (first), std::vector<std::string> ({""}));
+  EXPECT_EQ (first["next"], "n");
+
+  unsigned pages;
+  EXPECT_EQ (AllPages (1, pages), std::vector<std::string> (
+      {"", "bar", "domob", "foo", "zzz"}));
+  EXPECT_EQ (pages, 5);
+}
+
+TEST_F (ListNamesTests, StableAcrossChanges)
+{
+  const auto first = ListNames ("", 2);
+  EXPECT_EQ (Names (first), std::vector<std::string> ({"", "bar"}));
+
+  /* Names inserted before the cursor are not returned, and those after
+     it are picked up.  */
+  GetDb ().Execute (R"(
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
+      VALUES ("abc", NULL, "abc"),
+             ("def", NULL, "def");
+  )");
+
+  const auto second = ListNames (first["next"].asString (), 10);
+  EXPECT_EQ (Names (second), std::vector<std::string> (
+      {"def", "domob", "foo", "zzz"}));
+}
+
+TEST_F (ListNamesTests, InvalidCursor)
+{
+  Json::Value res;
+  EXPECT_FALSE (xid::ListNames (GetDb (), "a", 1, res));
+  EXPECT_FALSE (xid::ListNames (GetDb (), "xx", 1, res));
+  EXPECT_FALSE (xid::ListNames (GetDb (), "AB", 1, res));
+  EXPECT_FALSE (xid::ListNames (GetDb (), "ab", 1, res));
+  EXPECT_FALSE (xid::ListNames (GetDb (), "nab1", 1, res));
+  EXPECT_FALSE (xid::ListNames (GetDb (), "xab", 1, res));
+  EXPECT_FALSE (xid::ListNames (GetDb (), "nAB", 1, res));
+
+  EXPECT_TRUE (xid::ListNames (GetDb (), "n", 1, res));
+  EXPECT_EQ (Names (res), std::vector<std::string> ({"bar"}));
+  EXPECT_TRUE (xid::ListNames (GetDb (), "n62", 1, res));
+  EXPECT_EQ (Names (res), std::vector<std::string> ({"bar"}));
+}
+
+/* ************************************************************************** */
+
+class LookupTests : public DBTestWithSchema
+{
+
+protected:
+
+  LookupTests ()
+  {
+    GetDb ().Execute (R"(
+      INSERT INTO `test_signers` (`name`, `application`, `address`)
+        VALUES ("foo", "app", "shared"),
+               ("domob", "other", "shared"),
+               ("domob", NULL, "shared"),
+               ("domob", "app", "shared"),
+               ("domob", "", "shared"),
+               ("domob", NULL, "domob");
+      INSERT INTO `test_addresses` (`name`, `key`, `address`)
+        VALUES ("foo", "btc", "1shared"),
+               ("domob", "btc", "1shared"),
+               ("domob", "eth", "0xdomob"),
+               ("bar", "eth", "1shared");
+    )");
+  }
+
+};
+
+TEST_F (LookupTests, Signer)
+{
+  EXPECT_TRUE (JsonEquals (xid::LookupSigner (GetDb (), "shared"), R"([
+    {"name": "domob"},
+    {"name": "domob", "application": ""},
+    {"name": "domob", "application": "app"},
+    {"name": "domob", "application": "other"},
+    {"name": "foo", "application": "app"}
+  ])"));
+  EXPECT_TRUE (JsonEquals (xid::LookupSigner (GetDb (), "domob"), R"([
+    {"name": "domob"}
+  ])"));
+  EXPECT_TRUE (JsonEquals (xid::LookupSigner (GetDb (), "invalid"), "[]"));
+}
+
+TEST_F (LookupTests, Address)
+{
+  EXPECT_TRUE (JsonEquals (xid::LookupAddress (GetDb (), "btc", "1shared"),
+                           R"(["domob", "foo"])"));
+  EXPECT_TRUE (JsonEquals (xid::LookupAddress (GetDb (), "eth", "0xdomob"),
+                           R"(["domob"])"));
+  EXPECT_TRUE (JsonEquals (xid::LookupAddress (GetDb (), "eth", "0x"),
+                           "[]"));
+  EXPECT_TRUE (JsonEquals (xid::LookupAddress (GetDb (), "ltc", "1shared"),
+                           "[]"));
+}
+
+/* ************************************************************************** */
+
+class WriteFullStateTests : public DBTestWithSchema
+{
+
+protected:
+
+  /**
+   * Writes the full state with WriteFullState and returns the JSON text.
+   */
+  std::string
+  WriteFullState ()
+  {
+    std::ostringstream out;
+    xid::WriteFullState (GetDb (), out);
+    return out.str ();
+  }
+
+};
+
+TEST_F (WriteFullStateTests, Empty)
+{
+  EXPECT_EQ (WriteFullState (), R"({"names":{}})");
+}
+
+TEST_F (WriteFullStateTests, SameAsGetFullState)
+{
+  GetDb ().Execute (R"(
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
+      VALUES ("domob", NULL, "domob 1"),
+             ("domob", "app", "domob 2"),
+             ("foo", NULL, "foo"),
+             ('abc " def', NULL, "quoted"),
+             ('back\slash', "", "backslash");
+    INSERT INTO `test_addresses` (`name`, `key`, `address`)
+      VALUES ("domob", "btc", "1domob"),
+             ("bar", "eth", "0x123456"),
+             ("", "", "empty");
+  )");
+
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+  const auto expected
+      = Json::writeString (wbuilder, xid::GetFullState (GetDb ()));
+
+  EXPECT_EQ (WriteFullState (), expected);
+}
+
+TEST_F (WriteFullStateTests, NameWithNul)
+{
+  GetDb ().Execute (R"(
+    INSERT INTO `test_signers` (`name`, `application`, `address`)
+      VALUES (CAST (x'610062' AS TEXT), NULL, "addr");
+  )");
+
+  EXPECT_EQ (WriteFullState (),
+             R"({"names":{"a\u0000b":{"addresses":{},"name":"a\u0000b",)"
+             R"("signers":[{"addresses":["addr"]}]}}})");
+}
+
 /* ************************************************************************** */
 
 } // namespace xid
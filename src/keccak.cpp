@@ -0,0 +1,140 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "keccak.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace xid
+{
+
+namespace
+{
+
+/** Rate of Keccak-256 in bytes.  */
+constexpr size_t RATE = 136;
+
+/** Round constants of Keccak-f[1600].  */
+constexpr std::array<uint64_t, 24> ROUND_CONSTANTS = {
+  0x0000000000000001, 0x0000000000008082, 0x800000000000808A,
+  0x8000000080008000, 0x000000000000808B, 0x0000000080000001,
+  0x8000000080008081, 0x8000000000008009, 0x000000000000008A,
+  0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+  0x000000008000808B, 0x800000000000008B, 0x8000000000008089,
+  0x8000000000008003, 0x8000000000008002, 0x8000000000000080,
+  0x000000000000800A, 0x800000008000000A, 0x8000000080008081,
+  0x8000000000008080, 0x0000000080000001, 0x8000000080008008,
+};
+
+/** Rotation offsets for the rho step, in the order of the pi permutation.  */
+constexpr std::array<unsigned, 24> ROTATIONS = {
+  1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+  27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+/** Lane indices visited by the combined rho and pi steps.  */
+constexpr std::array<unsigned, 24> PI_LANES = {
+  10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+  15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+using State = std::array<uint64_t, 25>;
+
+inline uint64_t
+Rotl (const uint64_t x, const unsigned n)
+{
+  return (x << n) | (x >> (64 - n));
+}
+
+/**
+ * Applies the Keccak-f[1600] permutation to the state.
+ */
+void
+KeccakF (State& s)
+{
+  for (const uint64_t rc : ROUND_CONSTANTS)
+    {
+      /* Theta.  */
+      std::array<uint64_t, 5> c;
+      for (unsigned x = 0; x < 5; ++x)
+        c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+      for (unsigned x = 0; x < 5; ++x)
+        {
+          const uint64_t d = c[(x + 4) % 5] ^ Rotl (c[(x + 1) % 5], 1);
+          for (unsigned y = 0; y < 25; y += 5)
+            s[y + x] ^= d;
+        }
+
+      /* Rho and pi.  */
+      uint64_t cur = s[1];
+      for (unsigned i = 0; i < 24; ++i)
+        {
+          const unsigned j = PI_LANES[i];
+          const uint64_t tmp = s[j];
+          s[j] = Rotl (cur, ROTATIONS[i]);
+          cur = tmp;
+        }
+
+      /* Chi.  */
+      for (unsigned y = 0; y < 25; y += 5)
+        {
+          std::array<uint64_t, 5> row;
+          for (unsigned x = 0; x < 5; ++x)
+            row[x] = s[y + x];
+          for (unsigned x = 0; x < 5; ++x)
+            s[y + x] = row[x] ^ (~row[(x + 1) % 5] & row[(x + 2) % 5]);
+        }
+
+      /* Iota.  */
+      s[0] ^= rc;
+    }
+}
+
+/**
+ * XORs a full block of input into the state (lanes are little endian).
+ */
+void
+AbsorbBlock (State& s, const unsigned char* block)
+{
+  for (unsigned i = 0; i < RATE / 8; ++i)
+    {
+      uint64_t lane = 0;
+      for (unsigned b = 0; b < 8; ++b)
+        lane |= static_cast<uint64_t> (block[8 * i + b]) << (8 * b);
+      s[i] ^= lane;
+    }
+}
+
+} // anonymous namespace
+
+std::string
+Keccak256 (const std::string_view data)
+{
+  State s = {};
+
+  const auto* ptr = reinterpret_cast<const unsigned char*> (data.data ());
+  size_t len = data.size ();
+  for (; len >= RATE; ptr += RATE, len -= RATE)
+    {
+      AbsorbBlock (s, ptr);
+      KeccakF (s);
+    }
+
+  std::array<unsigned char, RATE> last = {};
+  std::copy (ptr, ptr + len, last.begin ());
+  last[len] ^= 0x01;
+  last[RATE - 1] ^= 0x80;
+  AbsorbBlock (s, last.data ());
+  KeccakF (s);
+
+  std::string res(32, '\0');
+  for (unsigned i = 0; i < res.size (); ++i)
+    res[i] = static_cast<char> ((s[i / 8] >> (8 * (i % 8))) & 0xFF);
+
+  return res;
+}
+
+} // namespace xid
@@ -0,0 +1,23 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_KECCAK_HPP
+#define XID_KECCAK_HPP
+
+#include <string>
+#include <string_view>
+
+namespace xid
+{
+
+/**
+ * Computes the Keccak-256 hash of the given data, as used by Ethereum
+ * (i.e. with the original Keccak padding rather than that of the final
+ * SHA-3 standard).  The result is returned as 32 raw bytes.
+ */
+std::string Keccak256 (std::string_view data);
+
+} // namespace xid
+
+#endif // XID_KECCAK_HPP
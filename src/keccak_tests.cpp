@@ -0,0 +1,43 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "keccak.hpp"
+
+#include "evmabi.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+std::string
+HashHex (const std::string& data)
+{
+  return EncodeEvmHex (Keccak256 (data));
+}
+
+TEST (KeccakTests, ShortInputs)
+{
+  EXPECT_EQ (HashHex (""),
+      "0xc5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470");
+  EXPECT_EQ (HashHex ("abc"),
+      "0x4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45");
+}
+
+TEST (KeccakTests, BlockBoundaries)
+{
+  EXPECT_EQ (HashHex (std::string (135, 'a')),
+      "0x34367dc248bbd832f4e3e69dfaac2f92638bd0bbd18f2912ba4ef454919cf446");
+  EXPECT_EQ (HashHex (std::string (136, 'a')),
+      "0xa6c4d403279fe3e0af03729caada8374b5ca54d8065329a3ebcaeb4b60aa386e");
+  EXPECT_EQ (HashHex (std::string (200, 'a')),
+      "0x96ea54061def936c4be90b518992fdc6f12f535068a256229aca54267b4d084d");
+}
+
+} // anonymous namespace
+} // namespace xid
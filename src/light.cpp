@@ -1,4 +1,4 @@
-// Copyright (C) 2020-2021 The Xaya developers
+// Copyright (C) 2020-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -6,7 +6,9 @@
 
 #include "rpc-stubs/lightserverstub.h"
 
+#include "gamestatejson.hpp"
 #include "nonstaterpc.hpp"
+#include "rpcerrors.hpp"
 
 #include <xayagame/rest.hpp>
 
@@ -20,6 +22,8 @@
 
 #include <condition_variable>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace xid
 {
@@ -27,6 +31,20 @@ namespace xid
 namespace
 {
 
+/**
+ * Maximum length of the URL-encoded list of names sent in one /names/
+ * REST request.  Larger batches are split up, so that the request stays
+ * well within the limits of typical HTTP servers (e.g. libmicrohttpd
+ * handles the request line within 32 KiB of memory per connection).
+ */
+constexpr size_t MAX_NAMES_URL_LENGTH = 8'000;
+
+/**
+ * Number of times a batch of names is requested again if its parts
+ * were answered from different blocks.
+ */
+constexpr unsigned MAX_NAMES_BATCH_RETRIES = 3;
+
 /**
  * Simple utility class corresponding to a "running main loop" that
  * can be stopped and waited on to be stopped.
@@ -97,6 +115,20 @@ private:
   /** REST client for requests.  */
   xaya::RestClient client;
 
+  /**
+   * Performs a REST request for the given path and returns the JSON result.
+   * Throws a JSON-RPC error if the request fails.
+   */
+  Json::Value RestJsonRequest (xaya::RestClient::Request& req,
+                               const std::string& path);
+
+  /**
+   * Requests the states of the given names, splitting them up into multiple
+   * /names/ requests so that none gets too long.  All parts must be answered
+   * from the same block, otherwise null is returned.
+   */
+  Json::Value RequestNameStates (const std::vector<std::string>& names);
+
 public:
 
   explicit LightServer (const std::string& endpoint,
@@ -116,6 +148,7 @@ public:
   void stop () override;
   Json::Value getnullstate () override;
   Json::Value getnamestate (const std::string& name) override;
+  Json::Value getnamestates (const Json::Value& names) override;
 
   Json::Value
   getauthmessage (const std::string& application,
@@ -147,15 +180,7 @@ LightServer::getnullstate ()
   LOG (INFO) << "RPC method called: getnullstate";
 
   xaya::RestClient::Request req(client);
-  if (!req.Send ("/state"))
-    throw jsonrpc::JsonRpcException (jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR,
-                                     req.GetError ());
-
-  if (req.GetType () != "application/json")
-    throw jsonrpc::JsonRpcException (jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR,
-                                     "expected JSON response");
-
-  return req.GetJson ();
+  return RestJsonRequest (req, "/state");
 }
 
 Json::Value
@@ -164,7 +189,14 @@ LightServer::getnamestate (const std::string& name)
   LOG (INFO) << "RPC method called: getnamestate " << name;
 
   xaya::RestClient::Request req(client);
-  if (!req.Send ("/name/" + req.UrlEncode (name)))
+  return RestJsonRequest (req, "/name/" + req.UrlEncode (name));
+}
+
+Json::Value
+LightServer::RestJsonRequest (xaya::RestClient::Request& req,
+                              const std::string& path)
+{
+  if (!req.Send (path))
     throw jsonrpc::JsonRpcException (jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR,
                                      req.GetError ());
 
@@ -175,6 +207,92 @@ LightServer::getnamestate (const std::string& name)
   return req.GetJson ();
 }
 
+Json::Value
+LightServer::RequestNameStates (const std::vector<std::string>& names)
+{
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+
+  /* The names are sent as JSON array in the URL path.  URL encoding works
+     on each byte separately, so the encoded array is just the encoded
+     entries joined by an encoded comma and within encoded brackets.  */
+  xaya::RestClient::Request encoder(client);
+  const std::string comma = encoder.UrlEncode (",");
+  const std::string open = encoder.UrlEncode ("[");
+  const std::string close = encoder.UrlEncode ("]");
+
+  Json::Value res;
+  size_t i = 0;
+  do
+    {
+      /* Each part contains at least one name, even if that alone is
+         longer than the limit.  */
+      std::string path = "/names/" + open;
+      const size_t start = i;
+      for (; i < names.size (); ++i)
+        {
+          std::string entry
+              = encoder.UrlEncode (Json::writeString (wbuilder, names[i]));
+          if (i > start)
+            {
+              if (path.size () + comma.size () + entry.size () + close.size ()
+                    > MAX_NAMES_URL_LENGTH)
+                break;
+              path += comma;
+            }
+          path += entry;
+        }
+      path += close;
+
+      xaya::RestClient::Request req(client);
+      Json::Value part = RestJsonRequest (req, path);
+      if (!part.isObject () || !part["data"].isArray ())
+        throw jsonrpc::JsonRpcException (
+            jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR,
+            "invalid /names/ response");
+
+      if (res.isNull ())
+        {
+          res = std::move (part);
+          continue;
+        }
+
+      if (part["blockhash"] != res["blockhash"])
+        return Json::Value ();
+      for (auto& entry : part["data"])
+        res["data"].append (std::move (entry));
+    }
+  while (i < names.size ());
+
+  return res;
+}
+
+Json::Value
+LightServer::getnamestates (const Json::Value& names)
+{
+  LOG (INFO) << "RPC method called: getnamestates " << names;
+
+  std::vector<std::string> nameList;
+  if (!ParseNameList (names, nameList))
+    ThrowJsonError (ErrorCode::INVALID_ARGUMENT,
+                    "names must be an array of at most "
+                      + std::to_string (MAX_NAMES_PER_BATCH) + " strings");
+
+  /* Usually the batch fits into a single REST request.  Otherwise it is
+     split up, and the parts may be answered from different blocks.  In that
+     (rare) case, we try again so that the result is consistent.  */
+  for (unsigned trial = 0; trial <= MAX_NAMES_BATCH_RETRIES; ++trial)
+    {
+      Json::Value res = RequestNameStates (nameList);
+      if (!res.isNull ())
+        return res;
+      LOG (WARNING) << "Block changed during getnamestates, retrying";
+    }
+
+  throw jsonrpc::JsonRpcException (jsonrpc::Errors::ERROR_RPC_INTERNAL_ERROR,
+                                   "state changed while requesting names");
+}
+
 } // anonymous namespace
 
 class LightInstance::Impl
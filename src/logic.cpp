@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -12,13 +12,56 @@
 
 #include <glog/logging.h>
 
+#include <set>
+#include <string>
+
 namespace xid
 {
 
+void
+XidGame::SetMoveDecodeThreads (const unsigned n)
+{
+  if (n == 0)
+    decodePool.reset ();
+  else
+    decodePool = std::make_unique<WorkerPool> (n);
+}
+
+namespace
+{
+
+/**
+ * Returns the sync state of the game (as string in the game-state JSON)
+ * after processing the given block notification.  Blocks that are sent to
+ * catch up carry the request token, while others are attached or detached
+ * as part of the normal up-to-date operation.
+ */
+std::string
+GetSyncState (const Json::Value& blockData)
+{
+  return blockData.isMember ("reqtoken") ? "catching-up" : "up-to-date";
+}
+
+} // anonymous namespace
+
 void
 XidGame::SetupSchema (xaya::SQLiteDatabase& db)
 {
   SetupDatabaseSchema (db);
+  database = &db;
+
+  /* SQLiteGame calls this whenever it opens a new connection, so this is
+     where statements prepared for the previous one are dropped.  The
+     connection may also be for a fresh database, in which case the cached
+     dictionary IDs are no longer valid either.  */
+  moveStatements.Clear ();
+  dictionaries.Clear ();
+
+  /* The database is opened when the game is started (or cleared and
+     reopened), before any block is processed.  Building the index here
+     makes it available right away, instead of only after the next block.  */
+  if (signerIndex != nullptr)
+    signerIndex->Rebuild (db);
 }
 
 void
@@ -79,8 +122,77 @@ XidGame::InitialiseState (xaya::SQLiteDatabase& db)
 void
 XidGame::UpdateState (xaya::SQLiteDatabase& db, const Json::Value& blockData)
 {
-  MoveProcessor proc(db);
+  MoveProcessor proc(db, moveStatements, dictionaries);
+  if (decodePool != nullptr)
+    proc.SetDecodePool (*decodePool);
   proc.ProcessAll (blockData["moves"]);
+
+  /* Session tokens and cached verifyauth results of names whose signers
+     changed are invalidated.  This is done before the new state is committed,
+     and verifyauth reads the generation of a name before taking its state
+     snapshot.  Since snapshots cannot be taken while a block is being
+     processed, a token or cached result can thus never carry a generation
+     newer than the state it was checked against.  */
+  const auto& changes = proc.GetSignerChanges ();
+  for (const auto& name : changes)
+    generations.Bump (name);
+
+  /* The signer index can be read at any time, so the generations are bumped
+     again after updating it.  Results computed from the index (or compared
+     against it) with a generation read after the first bump but before
+     the update are thus outdated as well.  */
+  if (signerIndex != nullptr)
+    {
+      const auto& blk = blockData["block"];
+      signerIndex->Update (db, changes, blk["hash"].asString (),
+                           blk["height"].asUInt64 (),
+                           GetSyncState (blockData));
+      for (const auto& name : changes)
+        generations.Bump (name);
+    }
+}
+
+xaya::GameStateData
+XidGame::ProcessBackwardsInternal (const xaya::GameStateData& newState,
+                                   const Json::Value& blockData,
+                                   const xaya::UndoData& undo)
+{
+  /* When a block is undone, the signers of all names with moves in it may
+     change back.  We do not decode the moves here again, and just
+     bump the generations of all of them.  Like for UpdateState, this is
+     done before and again after updating the signer index.  */
+  std::set<std::string> names;
+  for (const auto& mv : blockData["moves"])
+    {
+      const auto& name = mv["name"];
+      if (name.isString ())
+        names.insert (name.asString ());
+    }
+  for (const auto& name : names)
+    generations.Bump (name);
+
+  /* Undoing the block may remove entries from the dictionary tables,
+     so that the cached IDs are no longer valid.  */
+  dictionaries.Clear ();
+
+  auto res = SQLiteGame::ProcessBackwardsInternal (newState, blockData, undo);
+
+  /* The undo data has been applied to the database now (within the
+     transaction of the detach), so the signers of the touched names are
+     reloaded from it into the index, which is then at the parent block.  */
+  if (signerIndex != nullptr)
+    {
+      CHECK (database != nullptr);
+      const auto& blk = blockData["block"];
+      CHECK_GT (blk["height"].asUInt64 (), 0);
+      signerIndex->Update (*database, names, blk["parent"].asString (),
+                           blk["height"].asUInt64 () - 1,
+                           GetSyncState (blockData));
+      for (const auto& name : names)
+        generations.Bump (name);
+    }
+
+  return res;
 }
 
 Json::Value
@@ -89,20 +201,226 @@ XidGame::GetStateAsJson (const xaya::SQLiteDatabase& db)
   return GetFullState (db);
 }
 
+const MessageVerifier*
+XidGame::GetLocalVerifier ()
+{
+  std::call_once (localVerifierInit, [this] ()
+    {
+      const xaya::Chain chain = GetChain ();
+      switch (chain)
+        {
+        case xaya::Chain::MAIN:
+          localVerifier = std::make_unique<MessageVerifier> (
+              MessageVerifier::VERSION_MAIN);
+          break;
+
+        case xaya::Chain::TEST:
+        case xaya::Chain::REGTEST:
+          localVerifier = std::make_unique<MessageVerifier> (
+              MessageVerifier::VERSION_TEST);
+          break;
+
+        default:
+          LOG (INFO)
+              << "Local signature verification is not supported on chain "
+              << xaya::ChainToString (chain) << ", using RPC";
+          break;
+        }
+    });
+
+  return localVerifier.get ();
+}
+
+std::string
+XidGame::VerifyMessageUncached (const std::string& msg, const std::string& sgn)
+{
+  const MessageVerifier* local = nullptr;
+  if (sigVerification != SignatureVerification::RPC)
+    local = GetLocalVerifier ();
+
+  if (local == nullptr)
+    return xaya::VerifyMessage (GetXayaRpc (), msg, sgn);
+
+  const std::string addr = local->RecoverAddress (msg, sgn);
+  if (sigVerification != SignatureVerification::CROSS_CHECK)
+    return addr;
+
+  const std::string rpcAddr = xaya::VerifyMessage (GetXayaRpc (), msg, sgn);
+  if (rpcAddr != addr)
+    LOG (ERROR)
+        << "Local signature verification mismatch:\n"
+        << "  message: " << msg << "\n"
+        << "  signature: " << sgn << "\n"
+        << "  local: " << addr << "\n"
+        << "  RPC: " << rpcAddr;
+
+  return rpcAddr;
+}
+
+void
+XidGame::EnableSessions (const int64_t lifetime)
+{
+  CHECK_GT (lifetime, 0);
+  sessions = std::make_unique<SessionManager> (generations);
+  sessionLifetime = lifetime;
+}
+
+void
+XidGame::SetSignerIndexMode (const SignerIndexMode mode)
+{
+  signerIndexMode = mode;
+  if (mode == SignerIndexMode::DISABLED)
+    signerIndex.reset ();
+  else
+    signerIndex = std::make_unique<SignerIndex> ();
+}
+
+void
+XidGame::SetSignatureCacheSize (const size_t n)
+{
+  if (n == 0)
+    signatureCache.reset ();
+  else
+    signatureCache = std::make_unique<SignatureCache> (n);
+}
+
+void
+XidGame::SetAuthCacheSize (const size_t n)
+{
+  if (n == 0)
+    authCache.reset ();
+  else
+    authCache = std::make_unique<AuthCache> (generations, n);
+}
+
 std::string
 XidGame::VerifyMessage (const std::string& msg, const std::string& sgn)
 {
-  return xaya::VerifyMessage (GetXayaRpc (), msg, sgn);
+  std::string addr;
+  if (signatureCache != nullptr && signatureCache->Lookup (msg, sgn, addr))
+    return addr;
+
+  addr = VerifyMessageUncached (msg, sgn);
+
+  if (signatureCache != nullptr)
+    signatureCache->Insert (msg, sgn, addr);
+
+  return addr;
 }
 
 Json::Value
 XidGame::GetCustomStateData (xaya::Game& game, const JsonStateFromDatabase& cb)
 {
-  return SQLiteGame::GetCustomStateData (game, "data",
+  /* The index snapshot is loaded before the database snapshot is taken.
+     If it is still the current one afterwards, no block has been processed
+     or undone in between, so that its signers match the database state.  */
+  std::shared_ptr<const SignerIndex::Snapshot> indexed;
+  if (signerIndex != nullptr)
+    indexed = signerIndex->GetSnapshot ();
+
+  const Json::Value res = SQLiteGame::GetCustomStateData (game, "data",
     [this, cb] (const xaya::SQLiteDatabase& db)
       {
         return cb (db);
       });
+
+  /* Block processing does not know about changes of the sync state that
+     happen without a block (e.g. when the game becomes up-to-date at
+     startup or after catching up).  Also the index built when opening the
+     database does not know its block yet.  We fill that in from here, so
+     that the index can be used without waiting for the next block.  */
+  if (indexed != nullptr && res.isMember ("blockhash"))
+    {
+      const std::string hash = res["blockhash"].asString ();
+      const std::string state = res["state"].asString ();
+      const bool sameBlock = indexed->GetBlockHash ().empty ()
+                                || indexed->GetBlockHash () == hash;
+      if (sameBlock
+            && (indexed->GetBlockHash () != hash
+                  || indexed->GetState () != state))
+        signerIndex->UpdateBlock (indexed, hash, res["height"].asUInt64 (),
+                                  state);
+    }
+
+  return res;
+}
+
+Json::Value
+XidGame::GetIndexedStateData (const JsonStateFromSignerIndex& cb) const
+{
+  if (signerIndexMode != SignerIndexMode::ENABLED)
+    return Json::Value ();
+
+  /* The block and sync state are published together with the signers, so
+     everything is taken from the same snapshot without any locking.  While
+     the game is not up-to-date (or the block is not known yet), the caller
+     falls back to the database.  */
+  const auto snapshot = signerIndex->GetSnapshot ();
+  if (snapshot == nullptr || snapshot->GetBlockHash ().empty ()
+        || snapshot->GetState () != "up-to-date")
+    return Json::Value ();
+
+  Json::Value res(Json::objectValue);
+  res["gameid"] = GetGameId ();
+  res["chain"] = xaya::ChainToString (GetChain ());
+  res["state"] = snapshot->GetState ();
+  res["blockhash"] = snapshot->GetBlockHash ();
+  res["height"] = static_cast<Json::UInt64> (snapshot->GetHeight ());
+  res["data"] = cb (*snapshot);
+
+  return res;
+}
+
+void
+XidGame::WriteCurrentState (xaya::Game& game, std::ostream& out,
+                            const bool withGameState)
+{
+  /* The game state is written first, directly from within the callback
+     (while the snapshot is held).  The other fields (like the block hash)
+     are only known afterwards, and appended to the object at the end.  */
+
+  out << '{';
+  if (withGameState)
+    out << R"("gamestate":)";
+
+  bool written = false;
+  const Json::Value res = SQLiteGame::GetCustomStateData (game, "gamestate",
+    [&out, withGameState, &written] (const xaya::SQLiteDatabase& db)
+      {
+        if (withGameState)
+          {
+            WriteFullState (db, out);
+            written = true;
+          }
+        return Json::Value ();
+      });
+  CHECK (res.isObject ());
+
+  if (withGameState && !written)
+    out << "null";
+
+  Json::StreamWriterBuilder wbuilder;
+  wbuilder["indentation"] = "";
+  const std::unique_ptr<Json::StreamWriter> writer(wbuilder.newStreamWriter ());
+
+  bool first = !withGameState;
+  for (auto it = res.begin (); it != res.end (); ++it)
+    {
+      CHECK (it.key ().isString ());
+      const auto key = it.key ().asString ();
+      if (key == "gamestate")
+        continue;
+
+      if (!first)
+        out << ',';
+      first = false;
+
+      writer->write (Json::Value (key), &out);
+      out << ':';
+      writer->write (*it, &out);
+    }
+
+  out << '}';
 }
 
 } // namespace xid
@@ -1,10 +1,21 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #ifndef XID_LOGIC_HPP
 #define XID_LOGIC_HPP
 
+#include "authcache.hpp"
+#include "delegation.hpp"
+#include "dictionary.hpp"
+#include "messageverifier.hpp"
+#include "namegenerations.hpp"
+#include "sessions.hpp"
+#include "signaturecache.hpp"
+#include "signerindex.hpp"
+#include "statementregistry.hpp"
+#include "workerpool.hpp"
+
 #include <xayagame/game.hpp>
 #include <xayagame/sqlitegame.hpp>
 #include <xayagame/sqlitestorage.hpp>
@@ -13,18 +24,149 @@
 
 #include <json/json.h>
 
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
 #include <string>
+#include <utility>
 
 namespace xid
 {
 
+/**
+ * How signed messages are verified in XidGame::VerifyMessage.
+ */
+enum class SignatureVerification
+{
+
+  /**
+   * The signer is recovered locally (with libsecp256k1) on chains that
+   * support it, and through RPC otherwise (e.g. on EVM chains).
+   */
+  LOCAL,
+
+  /** Signatures are always verified through the Xaya RPC interface.  */
+  RPC,
+
+  /**
+   * Signatures are verified both locally (where supported) and through RPC,
+   * and mismatches are logged.  The RPC result is returned in this case.
+   */
+  CROSS_CHECK,
+
+};
+
+/**
+ * Whether and how the in-memory SignerIndex is used for verifyauth.
+ */
+enum class SignerIndexMode
+{
+
+  /** No index is kept, and signers are always checked in the database.  */
+  DISABLED,
+
+  /**
+   * Signers are checked with the index where it is available, without
+   * taking a database snapshot.
+   */
+  ENABLED,
+
+  /**
+   * Signers are checked both in the database and with the index, and
+   * mismatches are logged.  The database result is returned in this case.
+   */
+  CROSS_CHECK,
+
+};
+
 /**
  * The game logic implementation for the xid game-state processor.
  */
 class XidGame : public xaya::SQLiteGame
 {
 
+private:
+
+  /**
+   * Prepared statements used by the MoveProcessor for updating the state.
+   * They are kept across blocks, and released in SetupSchema when
+   * SQLiteGame opens a new database connection.
+   */
+  StatementRegistry moveStatements;
+
+  /**
+   * The dictionaries used by the MoveProcessor.  Their caches are kept
+   * across blocks, and cleared when a block is undone.
+   */
+  Dictionaries dictionaries;
+
+  /** If set, the worker pool used to decode moves in parallel.  */
+  std::unique_ptr<WorkerPool> decodePool;
+
+  /** If set, the cache for results of VerifyMessage.  */
+  std::unique_ptr<SignatureCache> signatureCache;
+
+  /** How signatures are verified.  */
+  SignatureVerification sigVerification = SignatureVerification::LOCAL;
+
+  /** Used to construct the local verifier once the chain is known.  */
+  std::once_flag localVerifierInit;
+
+  /**
+   * The local message verifier for the current chain, if the chain
+   * supports it.  This is constructed on first use.
+   */
+  std::unique_ptr<MessageVerifier> localVerifier;
+
+  /**
+   * Generations of names, bumped whenever their signers may change.  They
+   * are used to invalidate session tokens and cached verifyauth results.
+   */
+  NameGenerations generations;
+
+  /** If set, the cache for full verifyauth results.  */
+  std::unique_ptr<AuthCache> authCache;
+
+  /** If enabled, the manager for session tokens.  */
+  std::unique_ptr<SessionManager> sessions;
+
+  /** Lifetime of issued session tokens in seconds.  */
+  int64_t sessionLifetime = 0;
+
+  /**
+   * If set, the verifier for credentials with the delegation-contract
+   * protocol.
+   */
+  std::unique_ptr<DelegationVerifier> delegation;
+
+  /** How the signer index is used.  */
+  SignerIndexMode signerIndexMode = SignerIndexMode::DISABLED;
+
+  /** If enabled, the in-memory index of signers.  */
+  std::unique_ptr<SignerIndex> signerIndex;
+
+  /**
+   * The main database connection, as passed to SetupSchema when it was
+   * (last) opened.  It is used to update the signer index when a block
+   * is undone.
+   */
+  xaya::SQLiteDatabase* database = nullptr;
+
+  /**
+   * Returns the local message verifier for the current chain, or null
+   * if local verification is not supported for it.
+   */
+  const MessageVerifier* GetLocalVerifier ();
+
+  /**
+   * Verifies a message according to the configured mode, without
+   * looking at the cache.
+   */
+  std::string VerifyMessageUncached (const std::string& msg,
+                                     const std::string& sgn);
+
 protected:
 
   void SetupSchema (xaya::SQLiteDatabase& db) override;
@@ -38,20 +180,146 @@ protected:
 
   Json::Value GetStateAsJson (const xaya::SQLiteDatabase& db) override;
 
+  xaya::GameStateData ProcessBackwardsInternal (
+      const xaya::GameStateData& newState, const Json::Value& blockData,
+      const xaya::UndoData& undo) override;
+
 public:
 
   /** Type for a callback that retrieves JSON data from the database.  */
   using JsonStateFromDatabase
       = std::function<Json::Value (const xaya::SQLiteDatabase& db)>;
 
+  /** Type for a callback that retrieves JSON data from the signer index.  */
+  using JsonStateFromSignerIndex
+      = std::function<Json::Value (const SignerIndex::Snapshot& index)>;
+
   XidGame () = default;
 
   XidGame (const XidGame&) = delete;
   void operator= (const XidGame&) = delete;
 
   /**
-   * Exposes xaya::VerifyMessage with the configured RPC connection.  This is
-   * used by the verifyauth RPC call.
+   * Enables decoding of the moves in each block in parallel on the given
+   * number of worker threads.  If n is zero, moves are decoded sequentially
+   * on the block-processing thread.
+   */
+  void SetMoveDecodeThreads (unsigned n);
+
+  /**
+   * Enables caching of up to n results of VerifyMessage.  If n is zero,
+   * every call is passed on to Xaya Core.
+   */
+  void SetSignatureCacheSize (size_t n);
+
+  /**
+   * Sets how signed messages are verified.  This must be called before
+   * the first verification.
+   */
+  void
+  SetSignatureVerification (const SignatureVerification mode)
+  {
+    sigVerification = mode;
+  }
+
+  /**
+   * Enables caching of up to n full verifyauth results.  If n is zero,
+   * all credentials are verified again on every call.
+   */
+  void SetAuthCacheSize (size_t n);
+
+  /**
+   * Returns the cache for verifyauth results, or null if it is disabled.
+   */
+  AuthCache*
+  GetAuthCache ()
+  {
+    return authCache.get ();
+  }
+
+  /**
+   * Returns the generations of names.
+   */
+  const NameGenerations&
+  GetNameGenerations () const
+  {
+    return generations;
+  }
+
+  /**
+   * Enables issuing of session tokens in verifyauth, which are valid
+   * for the given number of seconds.
+   */
+  void EnableSessions (int64_t lifetime);
+
+  /**
+   * Returns the session manager, or null if sessions are not enabled.
+   */
+  SessionManager*
+  GetSessions ()
+  {
+    return sessions.get ();
+  }
+
+  /**
+   * Returns the lifetime of session tokens in seconds.
+   */
+  int64_t
+  GetSessionLifetime () const
+  {
+    return sessionLifetime;
+  }
+
+  /**
+   * Enables verification of credentials with the delegation-contract
+   * protocol using the given verifier.
+   */
+  void
+  SetDelegationVerifier (std::unique_ptr<DelegationVerifier> v)
+  {
+    delegation = std::move (v);
+  }
+
+  /**
+   * Returns the verifier for delegation-contract credentials, or null
+   * if they are not supported.
+   */
+  DelegationVerifier*
+  GetDelegationVerifier ()
+  {
+    return delegation.get ();
+  }
+
+  /**
+   * Enables the in-memory signer index with the given mode.  This must be
+   * called before the game is started.
+   */
+  void SetSignerIndexMode (SignerIndexMode mode);
+
+  /**
+   * Returns the mode in which the signer index is used.
+   */
+  SignerIndexMode
+  GetSignerIndexMode () const
+  {
+    return signerIndexMode;
+  }
+
+  /**
+   * Returns the signer index, or null if it is disabled.
+   */
+  const SignerIndex*
+  GetSignerIndex () const
+  {
+    return signerIndex.get ();
+  }
+
+  /**
+   * Recovers the address that signed a message (or returns "invalid"),
+   * like xaya::VerifyMessage with the configured RPC connection.  Depending
+   * on the configuration, this is done locally instead of through RPC.
+   * If enabled, results are cached.  This is used by the verifyauth
+   * RPC call.
    */
   std::string VerifyMessage (const std::string& msg, const std::string& sgn);
 
@@ -63,6 +331,27 @@ public:
   Json::Value GetCustomStateData (xaya::Game& game,
                                   const JsonStateFromDatabase& cb);
 
+  /**
+   * Returns custom game-state data like GetCustomStateData, but computed
+   * from the signer index instead of a database snapshot.  The block hash,
+   * height and state are those published with the index snapshot.  This
+   * never waits for block processing.  Returns null if the index is not
+   * enabled (in ENABLED mode), not available at the moment or the game was
+   * not up-to-date when it was published, in which case the caller should
+   * fall back to GetCustomStateData.
+   */
+  Json::Value GetIndexedStateData (const JsonStateFromSignerIndex& cb) const;
+
+  /**
+   * Writes the current state as JSON text (the same data as returned by
+   * Game::GetCurrentJsonState) to the given stream.  The game state itself
+   * is serialised directly from the database, without building it up
+   * as Json::Value first.  If withGameState is false, the "gamestate" field
+   * is left out (which yields the same data as Game::GetNullJsonState).
+   */
+  void WriteCurrentState (xaya::Game& game, std::ostream& out,
+                          bool withGameState);
+
 };
 
 } // namespace xid
@@ -1,9 +1,11 @@
-// Copyright (C) 2020-2025 The Xaya developers
+// Copyright (C) 2020-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "config.h"
 
+#include "evmabi.hpp"
+#include "evmrpc.hpp"
 #include "logic.hpp"
 #include "rest.hpp"
 #include "xidrpcserver.hpp"
@@ -24,6 +26,7 @@
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <string>
 
 namespace
 {
@@ -43,6 +46,8 @@ DEFINE_bool (game_rpc_listen_locally, true,
 
 DEFINE_int32 (rest_port, 0,
               "if non-zero, the port at which the REST interface should run");
+DEFINE_bool (rest_full_state, false,
+             "whether the REST interface should expose the full game state");
 
 DEFINE_int32 (enable_pruning, -1,
               "if non-negative (including zero), old undo data will be pruned"
@@ -52,6 +57,43 @@ DEFINE_string (datadir, "",
                "base data directory for state data"
                " (will be extended by 'id' the chain)");
 
+DEFINE_int32 (move_decode_threads, 0,
+              "if positive, the number of worker threads used to decode"
+              " the moves of each block in parallel");
+
+DEFINE_int32 (signature_cache_size, 10'000,
+              "maximum number of signature verification results to cache"
+              " (zero to disable the cache)");
+
+DEFINE_int32 (auth_cache_size, 0,
+              "maximum number of verifyauth results to cache"
+              " (zero to disable the cache)");
+
+DEFINE_string (signature_verification, "local",
+               "how to verify signatures: 'local' (recover the signer locally"
+               " where supported), 'rpc' (always call verifymessage) or"
+               " 'crosscheck' (do both and log mismatches)");
+
+DEFINE_string (signer_index, "off",
+               "whether to keep signers in memory for verifyauth: 'off',"
+               " 'on' or 'crosscheck' (check both the index and database"
+               " and log mismatches)");
+
+DEFINE_int32 (verify_threads, 4,
+              "number of worker threads used to verify signatures in"
+              " verifyauthbatch (zero to verify them on the RPC thread)");
+
+DEFINE_int64 (session_lifetime, 0,
+              "if positive, verifyauth issues session tokens for valid"
+              " credentials that are valid for this many seconds");
+
+DEFINE_string (delegation_rpc_url, "",
+               "if set, the EVM JSON-RPC endpoint used to verify credentials"
+               " with the delegation-contract protocol");
+DEFINE_string (delegation_contract, "",
+               "address of the delegation contract on the EVM chain"
+               " (required with --delegation_rpc_url)");
+
 DEFINE_bool (unsafe_rpc, true,
              "whether or not to allow 'unsafe' RPC methods like stop");
 DEFINE_bool (allow_wallet, false,
@@ -71,6 +113,9 @@ private:
   /** The REST API port.  */
   int restPort = 0;
 
+  /** Whether to enable the full-state endpoint in the REST API.  */
+  bool restFullState = false;
+
 public:
 
   explicit XidInstanceFactory (xid::XidGame& r)
@@ -78,9 +123,10 @@ public:
   {}
 
   void
-  EnableRest (const int p)
+  EnableRest (const int p, const bool fullState)
   {
     restPort = p;
+    restFullState = fullState;
   }
 
   std::unique_ptr<xaya::RpcServerInterface>
@@ -92,6 +138,7 @@ public:
 
     if (FLAGS_unsafe_rpc)
       rpc->Get ().EnableUnsafeMethods ();
+    rpc->Get ().SetVerifyThreads (FLAGS_verify_threads);
 
     return rpc;
   }
@@ -102,7 +149,12 @@ public:
     std::vector<std::unique_ptr<xaya::GameComponent>> res;
 
     if (restPort != 0)
-      res.push_back (std::make_unique<xid::RestApi> (game, rules, restPort));
+      {
+        auto rest = std::make_unique<xid::RestApi> (game, rules, restPort);
+        if (restFullState)
+          rest->EnableFullState ();
+        res.push_back (std::move (rest));
+      }
 
     return res;
   }
@@ -131,6 +183,77 @@ main (int argc, char** argv)
       std::cerr << "Error: --datadir must be specified" << std::endl;
       return EXIT_FAILURE;
     }
+  if (FLAGS_move_decode_threads < 0)
+    {
+      std::cerr << "Error: --move_decode_threads must not be negative"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  if (FLAGS_verify_threads < 0)
+    {
+      std::cerr << "Error: --verify_threads must not be negative"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  if (FLAGS_signature_cache_size < 0)
+    {
+      std::cerr << "Error: --signature_cache_size must not be negative"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  if (FLAGS_auth_cache_size < 0)
+    {
+      std::cerr << "Error: --auth_cache_size must not be negative"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  if (FLAGS_session_lifetime < 0)
+    {
+      std::cerr << "Error: --session_lifetime must not be negative"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  std::string delegationContract;
+  if (!FLAGS_delegation_rpc_url.empty ())
+    {
+      if (!xid::DecodeEvmHex (FLAGS_delegation_contract, delegationContract)
+            || delegationContract.size () != 20)
+        {
+          std::cerr << "Error: --delegation_contract must be a valid address"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+    }
+
+  xid::SignatureVerification sigVerification;
+  if (FLAGS_signature_verification == "local")
+    sigVerification = xid::SignatureVerification::LOCAL;
+  else if (FLAGS_signature_verification == "rpc")
+    sigVerification = xid::SignatureVerification::RPC;
+  else if (FLAGS_signature_verification == "crosscheck")
+    sigVerification = xid::SignatureVerification::CROSS_CHECK;
+  else
+    {
+      std::cerr << "Error: invalid --signature_verification value: "
+                << FLAGS_signature_verification << std::endl;
+      return EXIT_FAILURE;
+    }
+
+  xid::SignerIndexMode signerIndexMode;
+  if (FLAGS_signer_index == "off")
+    signerIndexMode = xid::SignerIndexMode::DISABLED;
+  else if (FLAGS_signer_index == "on")
+    signerIndexMode = xid::SignerIndexMode::ENABLED;
+  else if (FLAGS_signer_index == "crosscheck")
+    signerIndexMode = xid::SignerIndexMode::CROSS_CHECK;
+  else
+    {
+      std::cerr << "Error: invalid --signer_index value: "
+                << FLAGS_signer_index << std::endl;
+      return EXIT_FAILURE;
+    }
 
   xaya::GameDaemonConfiguration config;
   config.XayaRpcUrl = FLAGS_xaya_rpc_url;
@@ -152,9 +275,20 @@ main (int argc, char** argv)
   config.MinXayaVersion = 1'00'00'00;
 
   xid::XidGame rules;
+  rules.SetMoveDecodeThreads (FLAGS_move_decode_threads);
+  rules.SetSignatureCacheSize (FLAGS_signature_cache_size);
+  rules.SetAuthCacheSize (FLAGS_auth_cache_size);
+  rules.SetSignatureVerification (sigVerification);
+  rules.SetSignerIndexMode (signerIndexMode);
+  if (FLAGS_session_lifetime > 0)
+    rules.EnableSessions (FLAGS_session_lifetime);
+  if (!FLAGS_delegation_rpc_url.empty ())
+    rules.SetDelegationVerifier (std::make_unique<xid::DelegationVerifier> (
+        std::make_unique<xid::HttpEvmRpc> (FLAGS_delegation_rpc_url),
+        delegationContract));
   XidInstanceFactory instanceFact(rules);
   if (FLAGS_rest_port != 0)
-    instanceFact.EnableRest (FLAGS_rest_port);
+    instanceFact.EnableRest (FLAGS_rest_port, FLAGS_rest_full_state);
   config.InstanceFactory = &instanceFact;
 
   const int rc = xaya::SQLiteMain (config, "id", rules);
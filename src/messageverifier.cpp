@@ -0,0 +1,168 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "messageverifier.hpp"
+
+#include "base58.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <openssl/evp.h>
+
+#include <secp256k1_recovery.h>
+
+#include <glog/logging.h>
+
+#include <array>
+#include <vector>
+
+namespace xid
+{
+
+namespace
+{
+
+/** Result for invalid signatures.  */
+const std::string INVALID = "invalid";
+
+/** Size of a compact (recoverable) signature in bytes.  */
+constexpr size_t COMPACT_SIG_SIZE = 65;
+
+/**
+ * Computes a hash of the given data with the given OpenSSL digest.
+ */
+template <size_t N>
+  std::array<unsigned char, N>
+  Digest (const unsigned char* data, const size_t len, const EVP_MD* md)
+{
+  std::array<unsigned char, N> res;
+  unsigned outLen;
+  CHECK_EQ (EVP_Digest (data, len, res.data (), &outLen, md, nullptr), 1);
+  CHECK_EQ (outLen, N);
+  return res;
+}
+
+/**
+ * Computes the double SHA-256 of the given data.
+ */
+std::array<unsigned char, 32>
+DoubleSha256 (const unsigned char* data, const size_t len)
+{
+  const auto first = Digest<32> (data, len, EVP_sha256 ());
+  return Digest<32> (first.data (), first.size (), EVP_sha256 ());
+}
+
+/**
+ * Appends a string with Bitcoin's compact-size length prefix.
+ */
+void
+AppendSerialised (const std::string& str, std::vector<unsigned char>& out)
+{
+  const uint64_t len = str.size ();
+  if (len < 253)
+    out.push_back (len);
+  else if (len <= 0xFFFF)
+    {
+      out.push_back (253);
+      for (unsigned i = 0; i < 2; ++i)
+        out.push_back ((len >> (8 * i)) & 0xFF);
+    }
+  else if (len <= 0xFFFFFFFF)
+    {
+      out.push_back (254);
+      for (unsigned i = 0; i < 4; ++i)
+        out.push_back ((len >> (8 * i)) & 0xFF);
+    }
+  else
+    {
+      out.push_back (255);
+      for (unsigned i = 0; i < 8; ++i)
+        out.push_back ((len >> (8 * i)) & 0xFF);
+    }
+
+  out.insert (out.end (), str.begin (), str.end ());
+}
+
+/**
+ * Computes the hash that is signed for a given message.
+ */
+std::array<unsigned char, 32>
+MessageHash (const std::string& magic, const std::string& msg)
+{
+  std::vector<unsigned char> data;
+  data.reserve (magic.size () + msg.size () + 10);
+  AppendSerialised (magic, data);
+  AppendSerialised (msg, data);
+
+  return DoubleSha256 (data.data (), data.size ());
+}
+
+} // anonymous namespace
+
+const std::string MessageVerifier::MESSAGE_MAGIC = "Xaya Signed Message:\n";
+
+MessageVerifier::MessageVerifier (const unsigned char version)
+  : MessageVerifier(version, MESSAGE_MAGIC)
+{}
+
+MessageVerifier::MessageVerifier (const unsigned char version,
+                                  const std::string& m)
+  : addressVersion(version), magic(m)
+{
+  ctx = secp256k1_context_create (SECP256K1_CONTEXT_VERIFY);
+  CHECK (ctx != nullptr);
+}
+
+MessageVerifier::~MessageVerifier ()
+{
+  secp256k1_context_destroy (ctx);
+}
+
+std::string
+MessageVerifier::RecoverAddress (const std::string& msg,
+                                 const std::string& sgn) const
+{
+  std::string sgnBytes;
+  if (!xaya::DecodeBase64 (sgn, sgnBytes))
+    return INVALID;
+  if (sgnBytes.size () != COMPACT_SIG_SIZE)
+    return INVALID;
+
+  /* The header byte is 27 + recid, plus 4 if the public key is compressed.
+     Like Xaya Core, we do not check the range of the header byte and just
+     extract those two pieces of data from it.  */
+  const auto* sgnData
+      = reinterpret_cast<const unsigned char*> (sgnBytes.data ());
+  const unsigned header = static_cast<unsigned> (sgnData[0]) - 27;
+  const int recid = header & 3;
+  const bool compressed = (header & 4) != 0;
+
+  secp256k1_ecdsa_recoverable_signature sig;
+  if (!secp256k1_ecdsa_recoverable_signature_parse_compact (ctx, &sig,
+                                                            sgnData + 1,
+                                                            recid))
+    return INVALID;
+
+  const auto hash = MessageHash (magic, msg);
+  secp256k1_pubkey pubkey;
+  if (!secp256k1_ecdsa_recover (ctx, &pubkey, &sig, hash.data ()))
+    return INVALID;
+
+  std::array<unsigned char, 65> serialised;
+  size_t serialisedLen = serialised.size ();
+  CHECK (secp256k1_ec_pubkey_serialize (
+      ctx, serialised.data (), &serialisedLen, &pubkey,
+      compressed ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED));
+
+  const auto sha = Digest<32> (serialised.data (), serialisedLen,
+                               EVP_sha256 ());
+  const auto keyHash = Digest<20> (sha.data (), sha.size (), EVP_ripemd160 ());
+
+  std::string addrData(1, static_cast<char> (addressVersion));
+  addrData.append (keyHash.begin (), keyHash.end ());
+
+  return EncodeBase58Check (addrData);
+}
+
+} // namespace xid
@@ -0,0 +1,80 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_MESSAGEVERIFIER_HPP
+#define XID_MESSAGEVERIFIER_HPP
+
+#include <secp256k1.h>
+
+#include <string>
+
+namespace xid
+{
+
+/**
+ * Verifier for signed messages as produced by Xaya Core's signmessage.
+ * It recovers the signing address locally using libsecp256k1 public-key
+ * recovery, with the same result as the verifymessage RPC method of
+ * Xaya Core (with an empty address argument).
+ *
+ * This only works for the Bitcoin-style chains (Xaya Core), and not for
+ * EVM chains served through Xaya X.
+ *
+ * Instances are thread-safe after construction.
+ */
+class MessageVerifier
+{
+
+private:
+
+  /** The libsecp256k1 context used for recovery.  */
+  secp256k1_context* ctx;
+
+  /** Version byte for P2PKH addresses on the chain.  */
+  const unsigned char addressVersion;
+
+  /** Magic string prepended to messages before hashing them.  */
+  const std::string magic;
+
+public:
+
+  /** The message magic used by Xaya Core.  */
+  static const std::string MESSAGE_MAGIC;
+
+  /** Address version byte for mainnet.  */
+  static constexpr unsigned char VERSION_MAIN = 28;
+  /** Address version byte for testnet and regtest.  */
+  static constexpr unsigned char VERSION_TEST = 88;
+
+  /**
+   * Constructs a verifier that returns addresses with the given
+   * version byte.
+   */
+  explicit MessageVerifier (unsigned char version);
+
+  /**
+   * Constructs a verifier with a custom message magic instead of Xaya
+   * Core's.  This allows checking against signatures of other chains with
+   * the same scheme (e.g. test vectors of Bitcoin Core).
+   */
+  explicit MessageVerifier (unsigned char version, const std::string& m);
+
+  ~MessageVerifier ();
+
+  MessageVerifier (const MessageVerifier&) = delete;
+  void operator= (const MessageVerifier&) = delete;
+
+  /**
+   * Recovers the address that signed a given message.  The signature
+   * is passed base64-encoded.  If the signature is invalid, the string
+   * "invalid" is returned (which is what xaya::VerifyMessage does as well).
+   */
+  std::string RecoverAddress (const std::string& msg,
+                              const std::string& sgn) const;
+
+};
+
+} // namespace xid
+
+#endif // XID_MESSAGEVERIFIER_HPP
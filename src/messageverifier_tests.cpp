@@ -0,0 +1,209 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "messageverifier.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+/**
+ * Test vector for message verification.  The signatures were produced by
+ * a separate implementation of Xaya Core's signmessage scheme (with
+ * deterministic RFC 6979 nonces) for some fixed private keys, both for
+ * compressed and uncompressed public keys.  That implementation reproduces
+ * Bitcoin Core's own signmessage test vector (see BitcoinCoreVector).
+ * On a real node, addresses can also be checked against Xaya Core with
+ * --signature_verification=crosscheck, which compares the locally
+ * recovered addresses to verifymessage.
+ */
+struct TestVector
+{
+
+  /** The signed message.  */
+  std::string msg;
+
+  /** The signature as base64.  */
+  std::string sgn;
+
+  /** Address version byte to use.  */
+  unsigned char version;
+
+  /** The address returned by verifymessage.  */
+  std::string address;
+
+};
+
+const TestVector VECTORS[] =
+  {
+    {"",
+     "IP/xDMrxFqM/STwyHR2kbXtlDcYlFVnLP92zcTNNYCjseRVlVu94TsGTQb6YGsu/y/XSXINveZRqS2tf97mX6qk=",
+     28, "CT9A8CEgF7qJ3T6QuXSFQN31kEexxxa2oX"},
+    {"foo",
+     "IPRDrA72WALoPdgepTmgBJBtUQHYVerJxSc7scIBfU8AVV7hb0jizL4wHWlA8+tDar++OTCfgoHZRpyttPjFLOg=",
+     88, "cbRMCi7xqwds7TTcNhRNVtNDWW7ZeuZzGL"},
+    {"Kräfti ✓",
+     "G788bXlg+6h8iMacIiPIXGaVLzV7HDDX0O3tOrPBeLLeJX1M2INyReGMD+BLDzQTQdB3KIQfuF95ZIOPybgbGxo=",
+     28, "CVkG98k8C31SpW9P1oU3Ljg5Lsk7s84zJF"},
+    {std::string (300, 'x'),
+     "IBuU+gSnHr+BBEF0XJTFbG/LHRTW/gB+TxhoU+pgjw11UJgQ29VL4iXeL0Obc+sG4tU7D7ocoaNEoEOw14yUvPQ=",
+     88, "cbRMCi7xqwds7TTcNhRNVtNDWW7ZeuZzGL"},
+    {"Xid login\nName: domob\nApplication: app\n",
+     "H0wzFr+uAGik3txUy6AfEEFrKHgdKEm2He4ikWn6SZ7TdldgyYjfIbcQoCcpk0R+J7CMEOvstfEySpT4H7U57ys=",
+     28, "CT9A8CEgF7qJ3T6QuXSFQN31kEexxxa2oX"},
+    {"",
+     "Gzrlbqq6Kw5+8rBoj2RoIb0Joa4qahwXISLA13ImAUa7NfB/5NgB/b6rsQEgG1u8UQJMDqq3NheWaWgjHkjlBM4=",
+     88, "ckKkvryNjqyazeGUXCotM5dmeT8T6NJdy9"},
+    {"foo",
+     "ILuPHrPElS1B6czaITV20boae6BQELFVnWvZeF4cUgNxd9OD+OilOMb8gnFEOU7TaNo5ZRfLxeYApuwljRnJ5g0=",
+     28, "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"},
+    {"Kräfti ✓",
+     "IMJ1Egk+OdgTHFV/uuE0TRxxoNxpmK7XkQtRl03uYT7IF8gEkwuWV6dlAG+o1VClirETmLmMUnZOCPBI5HINKWs=",
+     88, "cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn"},
+    {std::string (300, 'x'),
+     "Gyf/Rtf6FlFxMob4btsLVZko4NUv9Si3AB/U1dv0oYDCX6ZgNqt/pQG0oYgDeL5yLmvraoeIM4gfRPpcs0h1b8E=",
+     28, "Cc3ZrM6692B1vduH42pmFZJZtBfrUCrUen"},
+    {"Xid login\nName: domob\nApplication: app\n",
+     "Hw1tYggjqFT+pWPdNw6LVJMr5OsTgLr7iLmnSf6o+q3VST4Jf6yKXkJuQJnOl8Io0xtdISF3Q8OxGttX0tlhXiY=",
+     88, "cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn"},
+    {"",
+     "H6vbyfuMWVGNDu2aFr3R6H7BtYGKxkBjzDg8A3k4vk3zE947NvleOlkYwy2V6VwjDt86+91NY7ag+76xr27sj/o=",
+     28, "CfDd4VNiiAqsJiV3kctyBPCyFQrDgCt28z"},
+    {"foo",
+     "HJFFis1reN3qzPG86MW0JhKL9SDYorWYiNlBbL4i8GuTLYEZLcANabGgbfTGWxja0pn4H173tRIS+MRZhNAenv4=",
+     88, "cTe1CPrktcxJvsxadvzpfNfjhTGDA4zUH2"},
+    {"Kräfti ✓",
+     "IIIJMI6jwG2GyGRE/jgh59RSEPiYnVruQzOtT/m7Y2XoIv96SFXzSD27halLtFWhyd0v6CLHn9bPkduZOpkmuJA=",
+     28, "CfDd4VNiiAqsJiV3kctyBPCyFQrDgCt28z"},
+    {std::string (300, 'x'),
+     "Hw/RoFrN7sCdZiRLcXf/h267Ldqluep9/95U+XJw/+G8HbKomdrJE/eP9WjcmbBE1B8nVqwHTTXYb32hthj+fxs=",
+     88, "coVp91G1JzeSNirFDnt6GuYB1gJpMX4fn3"},
+    {"Xid login\nName: domob\nApplication: app\n",
+     "G525KvZbLnz0CnRca0Lt4jXP6Vit/9rioDYwmjHPcOx0fW8Zo7jcrlLpKWPeujAAAa0BjEwGYiTZGmOqc0IqEc8=",
+     28, "CKMp7syUHo9jrsbPAm1hZrLXwBocWUuCJS"},
+    {"",
+     "HxIs2Vuyl0EoeY4A5Zp+fHUBmxde6OksQD1tOUNHjQKiRoRaIVCgULO44PuDRLvZk7z+elbtbcDFXwstsXCUQ8g=",
+     88, "cezFV7CT75bRtbyY1gN1QAX3c4ExV1r6FS"},
+    {"foo",
+     "H4FhTtIEgplm+GJfLmlha6FDWXAqASfBVmAXLm7+EoJoEjRnArM1cdzvcFONJ+JoGpFnmpBKYifUIa2Z2t1TCvU=",
+     28, "CWi4QbKAWFnrpbcLYWNtJeBqqnnMv3ZhkJ"},
+    {"Kräfti ✓",
+     "HCos0e5mrHJASzRYsw9ucwaXTk4t0OMEvhOhpgtnylNISaj9FVUc9E8My4B65oBWNaBfAGwo3EZtJWo1SIKh36o=",
+     88, "cjiSrCJAZu5iBCcNhkBukH8FT9iGei61sM"},
+    {std::string (300, 'x'),
+     "IOK4+oZl8RUAcqvATtXMBwukrMIJmeMs18oIz6lb0vqCBE5Su534f7k2KjizGaPMcsrXV5v38Wn9aWPuiEKb3l8=",
+     28, "CWi4QbKAWFnrpbcLYWNtJeBqqnnMv3ZhkJ"},
+    {"Xid login\nName: domob\nApplication: app\n",
+     "IIEHvILsRHTLuykVxzfHCkcS4qFMhAGGUghEIepX2zl7TmpSPBdkD/teKW0i3bin8qIAxZ8Zucq/1MuEbbrqatE=",
+     88, "cezFV7CT75bRtbyY1gN1QAX3c4ExV1r6FS"},
+  };
+
+TEST (MessageVerifierTests, TestVectors)
+{
+  const MessageVerifier main(MessageVerifier::VERSION_MAIN);
+  const MessageVerifier test(MessageVerifier::VERSION_TEST);
+
+  for (const auto& v : VECTORS)
+    {
+      const auto& verifier = (v.version == MessageVerifier::VERSION_MAIN
+                                ? main : test);
+      EXPECT_EQ (verifier.RecoverAddress (v.msg, v.sgn), v.address)
+          << "Message: " << v.msg;
+    }
+}
+
+TEST (MessageVerifierTests, BitcoinCoreVector)
+{
+  /* Signature produced by signmessagewithprivkey of Bitcoin Core (from its
+     functional test rpc_signmessage.py), for the private key
+     cUeKHd5orzT3mz8P9pxyREHfsWtVfgsfDjiZZBcjUBAaGk1BTj7N.  Xaya Core uses
+     the same code, just with its own message magic and address versions.  */
+  const MessageVerifier bitcoin(111, "Bitcoin Signed Message:\n");
+  EXPECT_EQ (bitcoin.RecoverAddress (
+      "This is just a test message",
+      "INbVnW4e6PeRmsv2Qgu8NuopvrVjkcxob+sX8OcZG0SALhWybUjzMLPdAsXI46YZGb0KQTRii+wWIQzRpG/U+S0="),
+      "mpLQjfK79b7CCV4VMJWEWAj5Mpx8Up5zxB");
+
+  /* The same key and message with Xaya's magic.  Signing is deterministic
+     (RFC 6979), and the signer used to produce this reproduces the Bitcoin
+     Core signature above exactly.  Thus this is what Xaya Core's
+     signmessagewithprivkey returns on regtest.  */
+  const MessageVerifier xaya(MessageVerifier::VERSION_TEST);
+  EXPECT_EQ (xaya.RecoverAddress (
+      "This is just a test message",
+      "H16OYOEyKo8Sz3UWB6Qc8kNn3omIw+a6yCtufZGG27d2em1k0Mw8a6L7Im8d/Nnpehv0xwjsAUkecRE0VlUg6/8="),
+      "cZZY6ATUpST3PWrVnequMHTytE2S7uZGYL");
+}
+
+TEST (MessageVerifierTests, WrongMessage)
+{
+  const MessageVerifier verifier(MessageVerifier::VERSION_MAIN);
+  const auto& v = VECTORS[1];
+
+  /* A signature for another message is valid, but recovers a different
+     (random) public key.  */
+  const std::string addr = verifier.RecoverAddress (v.msg + " ", v.sgn);
+  EXPECT_NE (addr, "invalid");
+  EXPECT_NE (addr, v.address);
+}
+
+TEST (MessageVerifierTests, HeaderByte)
+{
+  const MessageVerifier verifier(MessageVerifier::VERSION_MAIN);
+  const auto& v = VECTORS[0];
+
+  std::string sgnBytes;
+  ASSERT_TRUE (xaya::DecodeBase64 (v.sgn, sgnBytes));
+
+  /* Flipping the compressed flag yields the address for the other
+     serialisation of the same public key.  */
+  sgnBytes[0] ^= 4;
+  EXPECT_NE (verifier.RecoverAddress (v.msg, xaya::EncodeBase64 (sgnBytes)),
+             v.address);
+
+  /* Xaya Core only looks at the lowest three bits of the header byte
+     (minus 27), so out-of-range values are not rejected.  */
+  sgnBytes[0] ^= 4;
+  sgnBytes[0] += 8;
+  EXPECT_EQ (verifier.RecoverAddress (v.msg, xaya::EncodeBase64 (sgnBytes)),
+             v.address);
+}
+
+TEST (MessageVerifierTests, InvalidSignatures)
+{
+  const MessageVerifier verifier(MessageVerifier::VERSION_MAIN);
+  const auto& v = VECTORS[0];
+
+  std::string valid;
+  ASSERT_TRUE (xaya::DecodeBase64 (v.sgn, valid));
+  ASSERT_EQ (valid.size (), 65);
+
+  EXPECT_EQ (verifier.RecoverAddress (v.msg, "invalid base64"), "invalid");
+  EXPECT_EQ (verifier.RecoverAddress (v.msg, ""), "invalid");
+  EXPECT_EQ (verifier.RecoverAddress (
+      v.msg, xaya::EncodeBase64 (valid.substr (0, 64))), "invalid");
+  EXPECT_EQ (verifier.RecoverAddress (
+      v.msg, xaya::EncodeBase64 (valid + "x")), "invalid");
+
+  /* r and s must be in range and non-zero.  */
+  std::string sgn = valid;
+  sgn.replace (1, 32, std::string (32, '\xFF'));
+  EXPECT_EQ (verifier.RecoverAddress (v.msg, xaya::EncodeBase64 (sgn)),
+             "invalid");
+
+  sgn = valid;
+  sgn.replace (33, 32, std::string (32, '\0'));
+  EXPECT_EQ (verifier.RecoverAddress (v.msg, xaya::EncodeBase64 (sgn)),
+             "invalid");
+}
+
+} // anonymous namespace
+} // namespace xid
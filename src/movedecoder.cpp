@@ -0,0 +1,136 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "movedecoder.hpp"
+
+#include <glog/logging.h>
+
+namespace xid
+{
+
+namespace
+{
+
+/**
+ * Converts a JSON array of signer addresses to a SignerList.  Entries that
+ * are not strings are ignored (with a warning).
+ */
+SignerList
+DecodeSignerList (const std::string& name, const Json::Value& signerArr)
+{
+  CHECK (signerArr.isArray ());
+
+  SignerList res;
+  res.reserve (signerArr.size ());
+  for (const auto& addr : signerArr)
+    {
+      if (!addr.isString ())
+        {
+          LOG (WARNING)
+              << "Signer value in update for " << name
+              << " is not a string: " << addr;
+          continue;
+        }
+
+      res.push_back (addr.asString ());
+    }
+
+  return res;
+}
+
+/**
+ * Decodes an update to the signers in the move with the given
+ * describing object, if it is not null.
+ */
+void
+DecodeSignerUpdate (const Json::Value& obj, DecodedMove& mv)
+{
+  if (!obj.isObject ())
+    return;
+
+  const auto& global = obj["g"];
+  if (global.isArray ())
+    mv.globalSigners = DecodeSignerList (mv.name, global);
+
+  const auto& apps = obj["a"];
+  if (apps.isObject ())
+    for (auto it = apps.begin (); it != apps.end (); ++it)
+      {
+        CHECK (it.key ().isString ());
+        std::string application = it.key ().asString ();
+
+        if (!it->isArray ())
+          {
+            LOG (WARNING)
+                << "Signer update for " << mv.name
+                << " and application " << application
+                << " is not an array";
+            continue;
+          }
+
+        mv.appSigners.emplace_back (std::move (application),
+                                    DecodeSignerList (mv.name, *it));
+      }
+}
+
+/**
+ * Decodes an update to the crypto addresses.
+ */
+void
+DecodeAddressUpdate (const Json::Value& obj, DecodedMove& mv)
+{
+  if (!obj.isObject ())
+    return;
+
+  for (auto it = obj.begin (); it != obj.end (); ++it)
+    {
+      CHECK (it.key ().isString ());
+      std::string key = it.key ().asString ();
+
+      if (it->isNull ())
+        {
+          mv.addresses.emplace_back (std::move (key), std::nullopt);
+          continue;
+        }
+      if (it->isString ())
+        {
+          mv.addresses.emplace_back (std::move (key), it->asString ());
+          continue;
+        }
+
+      LOG (WARNING)
+          << "Invalid address association for " << mv.name << " and " << key
+          << ": " << *it;
+    }
+}
+
+} // anonymous namespace
+
+DecodedMove
+DecodeMove (const Json::Value& obj)
+{
+  CHECK (obj.isObject ());
+  VLOG (1) << "Decoding move:\n" << obj;
+
+  DecodedMove res;
+
+  const auto& nmVal = obj["name"];
+  CHECK (nmVal.isString ());
+  res.name = nmVal.asString ();
+
+  CHECK (obj.isMember ("move"));
+  const auto& mv = obj["move"];
+  if (!mv.isObject ())
+    {
+      LOG (WARNING) << "Move by " << res.name << " is not an object:\n" << mv;
+      return res;
+    }
+
+  DecodeSignerUpdate (mv["s"], res);
+  DecodeAddressUpdate (mv["ca"], res);
+
+  return res;
+}
+
+} // namespace xid
@@ -0,0 +1,59 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_MOVEDECODER_HPP
+#define XID_MOVEDECODER_HPP
+
+#include <json/json.h>
+
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace xid
+{
+
+/** A list of signer addresses.  */
+using SignerList = std::vector<std::string>;
+
+/**
+ * The data of one entry in the moves array of a block, decoded and validated
+ * into typed form.  Invalid parts of the move (which are ignored as per
+ * the move format) are already left out.
+ */
+struct DecodedMove
+{
+
+  /** The name that sent the move.  */
+  std::string name;
+
+  /** The new global signers, if the move updates them.  */
+  std::optional<SignerList> globalSigners;
+
+  /** Updated signer lists for applications, in the order of the move.  */
+  std::vector<std::pair<std::string, SignerList>> appSigners;
+
+  /**
+   * Updated address associations in the order of the move.  If the value
+   * is not set, the association is removed.
+   */
+  std::vector<std::pair<std::string, std::optional<std::string>>> addresses;
+
+};
+
+/**
+ * Decodes one entry of the moves array (given as JSON object).  This function
+ * is pure, i.e. it does not access the game state in any way, and can thus
+ * be run independently from (and concurrently to) database updates.
+ *
+ * If the data is invalid in a way that Xaya Core would never send, this
+ * CHECK-fails.  Invalid move data from users is just ignored (with a warning
+ * logged) and leads to a move without updates.
+ */
+DecodedMove DecodeMove (const Json::Value& obj);
+
+} // namespace xid
+
+#endif // XID_MOVEDECODER_HPP
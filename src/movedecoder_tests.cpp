@@ -0,0 +1,119 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "movedecoder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <json/json.h>
+
+#include <sstream>
+
+namespace xid
+{
+namespace
+{
+
+/**
+ * Parses the given string as JSON and decodes it as move.
+ */
+DecodedMove
+Decode (const std::string& str)
+{
+  std::istringstream in(str);
+  Json::Value val;
+  in >> val;
+
+  return DecodeMove (val);
+}
+
+TEST (MoveDecoderTests, InvalidDataFromXayaCore)
+{
+  for (const auto& str : {"5", "[]", "{}",
+                          R"({"name": 5, "move": {}})",
+                          R"({"name": "abc"})"})
+    {
+      LOG (INFO) << "Testing invalid move string: " << str;
+      EXPECT_DEATH (Decode (str), "Check failed");
+    }
+}
+
+TEST (MoveDecoderTests, NoUpdates)
+{
+  for (const auto& mvStr : {"5", "false", "\"foo\"", "{}",
+                            R"({"x": 42, "s": [], "ca": 5})"})
+    {
+      LOG (INFO) << "Testing move data: " << mvStr;
+
+      std::ostringstream fullMove;
+      fullMove << R"({"name": "test", "move": )" << mvStr << "}";
+
+      const auto mv = Decode (fullMove.str ());
+      EXPECT_EQ (mv.name, "test");
+      EXPECT_FALSE (mv.globalSigners);
+      EXPECT_TRUE (mv.appSigners.empty ());
+      EXPECT_TRUE (mv.addresses.empty ());
+    }
+}
+
+TEST (MoveDecoderTests, Signers)
+{
+  const auto mv = Decode (R"({
+    "name": "domob",
+    "move":
+      {
+        "s":
+          {
+            "g": ["global 1", 42, "global 2"],
+            "a":
+              {
+                "foo": "not an array",
+                "": [],
+                "app": ["app", {}]
+              }
+          }
+      }
+  })");
+
+  EXPECT_EQ (mv.name, "domob");
+  ASSERT_TRUE (mv.globalSigners);
+  EXPECT_EQ (*mv.globalSigners, SignerList ({"global 1", "global 2"}));
+  ASSERT_EQ (mv.appSigners.size (), 2);
+  EXPECT_EQ (mv.appSigners[0].first, "");
+  EXPECT_EQ (mv.appSigners[0].second, SignerList ());
+  EXPECT_EQ (mv.appSigners[1].first, "app");
+  EXPECT_EQ (mv.appSigners[1].second, SignerList ({"app"}));
+  EXPECT_TRUE (mv.addresses.empty ());
+}
+
+TEST (MoveDecoderTests, Addresses)
+{
+  const auto mv = Decode (R"({
+    "name": "domob",
+    "move":
+      {
+        "ca":
+          {
+            "btc": "1domob",
+            "chi": null,
+            "eth": 42,
+            "ltc": []
+          }
+      }
+  })");
+
+  EXPECT_EQ (mv.name, "domob");
+  EXPECT_FALSE (mv.globalSigners);
+  EXPECT_TRUE (mv.appSigners.empty ());
+  ASSERT_EQ (mv.addresses.size (), 2);
+  EXPECT_EQ (mv.addresses[0].first, "btc");
+  EXPECT_EQ (mv.addresses[0].second, "1domob");
+  EXPECT_EQ (mv.addresses[1].first, "chi");
+  EXPECT_FALSE (mv.addresses[1].second);
+}
+
+} // anonymous namespace
+} // namespace xid
@@ -1,11 +1,17 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "moveprocessor.hpp"
 
+#include "signeraddress.hpp"
+
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <set>
+#include <sstream>
+
 namespace xid
 {
 
@@ -13,189 +19,252 @@ namespace
 {
 
 /**
- * Sets the list of signers for a particular application (or global signers
- * if nullptr is passed) to the given JSON array.
+ * Minimum number of moves that are decoded as one chunk on the worker pool.
+ * Below that, the overhead of the thread handoff is not worth it.
+ */
+constexpr size_t MIN_DECODE_CHUNK = 32;
+
+/**
+ * Binds the application ID of a signer list (or zero for global signers)
+ * to a statement parameter.
  */
 void
-SetSignerList (xaya::SQLiteDatabase& db, const std::string& name,
-               const std::string* application,
-               const Json::Value& signerArr)
+BindApplication (xaya::SQLiteDatabase::Statement& stmt, const int ind,
+                 const std::optional<int64_t>& appId)
 {
-  if (application == nullptr)
-    VLOG (1) << "Setting global signers for " << name << " to: " << signerArr;
-  else
-    VLOG (1)
-        << "Setting signers for " << name
-        << " and application " << *application << " to: " << signerArr;
-
-  CHECK (signerArr.isArray ());
-
-  xaya::SQLiteDatabase::Statement stmt;
-  if (application == nullptr)
-    stmt = db.Prepare (R"(
-      DELETE FROM `signers`
-        WHERE `name` = ?1 AND `application` IS NULL
-    )");
-  else
-    {
-      stmt = db.Prepare (R"(
-        DELETE FROM `signers`
-          WHERE `name` = ?1 AND `application` = ?2
-      )");
-      stmt.Bind (2, *application);
-    }
-  stmt.Bind (1, name);
-  stmt.Execute ();
+  stmt.Bind<int64_t> (ind, appId ? *appId : 0);
+}
 
-  stmt = db.Prepare (R"(
-    INSERT INTO `signers`
-      (`name`, `application`, `address`)
-      VALUES (?1, ?2, ?3)
-  )");
-  stmt.Bind (1, name);
-  if (application == nullptr)
-    stmt.BindNull (2);
-  else
-    stmt.Bind (2, *application);
+} // anonymous namespace
 
-  for (const auto& addr : signerArr)
-    {
-      if (!addr.isString ())
-        {
-          LOG (WARNING)
-              << "Signer value in update for " << name
-              << " is not a string: " << addr;
-          continue;
-        }
+void
+MoveProcessor::Fold (DecodedMove&& mv)
+{
+  /* Only create an entry for the name if there are actually any updates.  */
+  if (!mv.globalSigners && mv.appSigners.empty () && mv.addresses.empty ())
+    return;
 
-      stmt.Bind (3, addr.asString ());
-      stmt.Execute ();
+  auto& upd = updates[std::move (mv.name)];
 
-      /* We reuse the prepared statement for all signer inserts, since they
-         are just the same operation repeated.  We can even keep the bindings
-         for name and application, and just override address in the next
-         iteration of the loop.  */
-      stmt.Reset ();
-    }
+  if (mv.globalSigners)
+    upd.globalSigners = std::move (mv.globalSigners);
+  for (auto& entry : mv.appSigners)
+    upd.appSigners[entry.first] = std::move (entry.second);
+  for (auto& entry : mv.addresses)
+    upd.addresses[entry.first] = std::move (entry.second);
 }
 
-} // anonymous namespace
+bool
+MoveProcessor::GetId (Dictionary& dict, const std::string& str,
+                      const bool create, int64_t& id)
+{
+  if (create)
+    {
+      id = dict.Intern (db, stmts, str);
+      return true;
+    }
+
+  return dict.Lookup (db, stmts, str, id);
+}
 
 void
-MoveProcessor::HandleSignerUpdate (const std::string& name,
-                                   const Json::Value& obj)
+MoveProcessor::SetSignerList (const std::string& name,
+                              const std::string* application,
+                              const SignerList& signers)
 {
-  if (!obj.isObject ())
+  if (VLOG_IS_ON (1))
+    {
+      std::ostringstream out;
+      for (const auto& addr : signers)
+        out << " " << addr;
+
+      if (application == nullptr)
+        VLOG (1)
+            << "Setting global signers for " << name << " to:" << out.str ();
+      else
+        VLOG (1)
+            << "Setting signers for " << name
+            << " and application " << *application << " to:" << out.str ();
+    }
+
+  /* Instead of removing all existing signers and inserting the new list,
+     we only delete addresses that are no longer there and insert those
+     that are new.  Typically only a single key is changed, and this keeps
+     the writes (and thus undo data) minimal.  */
+
+  const std::set<std::string> newSigners(signers.begin (), signers.end ());
+
+  /* If the name or application are not yet in the dictionaries, there
+     cannot be any existing signers.  In that case, we only add them to
+     the dictionaries if there are new signers.  */
+  const bool create = !newSigners.empty ();
+  int64_t nameId;
+  if (!GetId (dicts.names, name, create, nameId))
     return;
+  std::optional<int64_t> appId;
+  if (application != nullptr)
+    {
+      int64_t id;
+      if (!GetId (dicts.applications, *application, create, id))
+        return;
+      appId = id;
+    }
+
+  auto& stmtSel = stmts.Get (db, R"(
+    SELECT `address`, typeof (`address`) = 'blob'
+      FROM `signers`
+      WHERE `name_id` = ?1 AND `application_id` = ?2
+  )");
+  stmtSel.Bind (1, nameId);
+  BindApplication (stmtSel, 2, appId);
+
+  std::set<std::string> existing;
+  while (stmtSel.Step ())
+    existing.insert (GetSignerAddress (stmtSel, 0));
 
-  const auto& global = obj["g"];
-  if (global.isArray ())
-    SetSignerList (db, name, nullptr, global);
+  auto& stmtDel = stmts.Get (db, R"(
+    DELETE FROM `signers`
+      WHERE `name_id` = ?1 AND `application_id` = ?2 AND `address` = ?3
+  )");
+  stmtDel.Bind (1, nameId);
+  BindApplication (stmtDel, 2, appId);
+  for (const auto& addr : existing)
+    if (newSigners.count (addr) == 0)
+      {
+        BindSignerAddress (stmtDel, 3, addr);
+        stmtDel.Execute ();
+        stmtDel.Reset ();
+      }
 
-  const auto& apps = obj["a"];
-  if (apps.isObject ())
-    for (auto it = apps.begin (); it != apps.end (); ++it)
+  auto& stmtIns = stmts.Get (db, R"(
+    INSERT INTO `signers`
+      (`name_id`, `application_id`, `address`)
+      VALUES (?1, ?2, ?3)
+  )");
+  stmtIns.Bind (1, nameId);
+  BindApplication (stmtIns, 2, appId);
+  for (const auto& addr : newSigners)
+    if (existing.count (addr) == 0)
       {
-        CHECK (it.key ().isString ());
-        const std::string application = it.key ().asString ();
-
-        if (!it->isArray ())
-          {
-            LOG (WARNING)
-                << "Signer update for " << name
-                << " and application " << application
-                << " is not an array";
-            continue;
-          }
-
-        SetSignerList (db, name, &application, *it);
+        /* We reuse the prepared statement for all signer inserts, since they
+           are just the same operation repeated.  We can even keep the
+           bindings for name and application, and just override address in
+           the next iteration of the loop.  */
+        BindSignerAddress (stmtIns, 3, addr);
+        stmtIns.Execute ();
+        stmtIns.Reset ();
       }
 }
 
 void
-MoveProcessor::HandleAddressUpdate (const std::string& name,
-                                    const Json::Value& obj)
+MoveProcessor::SetAddress (const std::string& name, const std::string& key,
+                           const std::optional<std::string>& addr)
 {
-  if (!obj.isObject ())
-    return;
+  /* Like for signers, the name and key are only added to the dictionaries
+     if we actually set an address.  */
+  int64_t nameId, keyId;
+  if (!GetId (dicts.names, name, addr.has_value (), nameId)
+        || !GetId (dicts.keys, key, addr.has_value (), keyId))
+    {
+      CHECK (!addr);
+      VLOG (1)
+          << "No address association to delete for " << name << " and " << key;
+      return;
+    }
 
-  auto stmtDel = db.Prepare (R"(
-    DELETE FROM `addresses`
-      WHERE `name` = ?1 AND `key` = ?2
-  )");
-  stmtDel.Bind (1, name);
+  if (!addr)
+    {
+      auto& stmt = stmts.Get (db, R"(
+        DELETE FROM `addresses`
+          WHERE `name_id` = ?1 AND `key_id` = ?2
+      )");
+      stmt.Bind (1, nameId);
+      stmt.Bind (2, keyId);
+      stmt.Execute ();
+      VLOG (1)
+          << "Deleted address association for " << name << " and " << key;
+      return;
+    }
 
-  auto stmtIns = db.Prepare (R"(
+  auto& stmt = stmts.Get (db, R"(
     INSERT OR REPLACE INTO `addresses`
-      (`name`, `key`, `address`)
+      (`name_id`, `key_id`, `address`)
       VALUES (?1, ?2, ?3)
   )");
-  stmtIns.Bind (1, name);
+  stmt.Bind (1, nameId);
+  stmt.Bind (2, keyId);
+  stmt.Bind (3, *addr);
+  stmt.Execute ();
+  VLOG (1) << "New address for " << name << " and " << key << ": " << *addr;
+}
 
-  for (auto it = obj.begin (); it != obj.end (); ++it)
+void
+MoveProcessor::ApplyUpdates ()
+{
+  for (const auto& entry : updates)
     {
-      CHECK (it.key ().isString ());
-      const auto key = it.key ().asString ();
+      const auto& name = entry.first;
+      const auto& upd = entry.second;
 
-      const auto val = *it;
-      if (val.isNull ())
-        {
-          stmtDel.Reset ();
-          stmtDel.Bind (2, key);
-          stmtDel.Execute ();
-          VLOG (1)
-              << "Deleted address association for " << name << " and " << key;
-          continue;
-        }
-      if (val.isString ())
-        {
-          const auto addr = val.asString ();
-          stmtIns.Reset ();
-          stmtIns.Bind (2, key);
-          stmtIns.Bind (3, addr);
-          stmtIns.Execute ();
-          VLOG (1)
-              << "New address for " << name << " and " << key
-              << ": " << addr;
-          continue;
-        }
-
-      LOG (WARNING)
-          << "Invalid address association for " << name << " and " << key
-          << ": " << val;
+      if (upd.globalSigners || !upd.appSigners.empty ())
+        signerChanges.insert (name);
+
+      if (upd.globalSigners)
+        SetSignerList (name, nullptr, *upd.globalSigners);
+      for (const auto& app : upd.appSigners)
+        SetSignerList (name, &app.first, app.second);
+
+      for (const auto& addr : upd.addresses)
+        SetAddress (name, addr.first, addr.second);
     }
+
+  updates.clear ();
 }
 
 void
-MoveProcessor::ProcessOne (const Json::Value& obj)
+MoveProcessor::ProcessAll (const Json::Value& arr)
 {
-  CHECK (obj.isObject ());
-  VLOG (1) << "Processing move:\n" << obj;
+  LOG (INFO) << "Processing " << arr.size () << " moves";
+  CHECK (arr.isArray ());
 
-  const auto& nmVal = obj["name"];
-  CHECK (nmVal.isString ());
-  const std::string name = nmVal.asString ();
+  const size_t n = arr.size ();
+  std::vector<DecodedMove> moves(n);
 
-  CHECK (obj.isMember ("move"));
-  const auto& mv = obj["move"];
-  if (!mv.isObject ())
+  size_t numChunks = 1;
+  if (decodePool != nullptr)
     {
-      LOG (WARNING) << "Move by " << name << " is not an object:\n" << mv;
-      return;
+      numChunks = 4 * decodePool->GetNumThreads ();
+      numChunks = std::min (numChunks, n / MIN_DECODE_CHUNK);
+      numChunks = std::max<size_t> (numChunks, 1);
     }
 
-  HandleSignerUpdate (name, mv["s"]);
-  HandleAddressUpdate (name, mv["ca"]);
+  if (numChunks == 1)
+    for (size_t i = 0; i < n; ++i)
+      moves[i] = DecodeMove (arr[static_cast<Json::ArrayIndex> (i)]);
+  else
+    {
+      VLOG (1) << "Decoding moves in " << numChunks << " chunks";
+      decodePool->ParallelFor (numChunks, [&] (const size_t chunk)
+        {
+          const size_t begin = chunk * n / numChunks;
+          const size_t end = (chunk + 1) * n / numChunks;
+          for (size_t i = begin; i < end; ++i)
+            moves[i] = DecodeMove (arr[static_cast<Json::ArrayIndex> (i)]);
+        });
+    }
+
+  ApplyAll (std::move (moves));
 }
 
 void
-MoveProcessor::ProcessAll (const Json::Value& arr)
+MoveProcessor::ApplyAll (std::vector<DecodedMove>&& moves)
 {
-  LOG (INFO) << "Processing " << arr.size () << " moves";
+  CHECK (updates.empty ());
+  for (auto& mv : moves)
+    Fold (std::move (mv));
 
-  CHECK (arr.isArray ());
-  for (const auto& entry : arr)
-    ProcessOne (entry);
+  VLOG (1) << "Writing updates for " << updates.size () << " names";
+  ApplyUpdates ();
 }
 
 } // namespace xid
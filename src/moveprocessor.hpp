@@ -1,59 +1,158 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #ifndef XID_MOVEPROCESSOR_HPP
 #define XID_MOVEPROCESSOR_HPP
 
+#include "dictionary.hpp"
+#include "movedecoder.hpp"
+#include "statementregistry.hpp"
+#include "workerpool.hpp"
+
 #include <xayagame/sqlitestorage.hpp>
 
 #include <json/json.h>
 
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+
 namespace xid
 {
 
 /**
  * Helper class for processing player moves and updating the game state in the
  * database accordingly.
+ *
+ * Processing is done in two phases:  First, all moves of a block are
+ * decoded into typed DecodedMove instances (which does not access the
+ * database).  Then those are folded together into the net update they
+ * cause for each name (with later moves overriding earlier ones), and only
+ * that net result is written to the database.
  */
 class MoveProcessor
 {
 
 private:
 
+  /**
+   * The net update of all moves in the current block for a single name.
+   */
+  struct NameUpdate
+  {
+
+    /** The new global signers, if they have been updated.  */
+    std::optional<SignerList> globalSigners;
+
+    /** The new signer lists for all applications that have been updated.  */
+    std::map<std::string, SignerList> appSigners;
+
+    /**
+     * New address associations for all keys that have been updated.  If the
+     * value is not set, then the association is removed.
+     */
+    std::map<std::string, std::optional<std::string>> addresses;
+
+  };
+
   /** The underlying database connection that is used for updates.  */
   xaya::SQLiteDatabase& db;
 
+  /** Registry from which prepared statements for the updates are taken.  */
+  StatementRegistry& stmts;
+
+  /** The dictionaries for names, applications and keys.  */
+  Dictionaries& dicts;
+
+  /**
+   * If set, a worker pool on which moves are decoded in parallel.  The
+   * result is the same as with sequential decoding, since only the
+   * (pure) decoding is done in parallel, and the decoded moves are
+   * then still applied in their original order.
+   */
+  WorkerPool* decodePool = nullptr;
+
+  /** The pending updates for each name touched in the current block.  */
+  std::map<std::string, NameUpdate> updates;
+
+  /** Names whose signers have been updated by the applied moves.  */
+  std::set<std::string> signerChanges;
+
   /**
-   * Processes one entry in the moves array (given as JSON object).
+   * Folds the updates made by one decoded move into the pending ones.
    */
-  void ProcessOne (const Json::Value& obj);
+  void Fold (DecodedMove&& mv);
 
   /**
-   * Tries to process an update to the signers in the move with the given
-   * describing object, if it is not null.
+   * Writes all pending updates to the database.
    */
-  void HandleSignerUpdate (const std::string& name, const Json::Value& obj);
+  void ApplyUpdates ();
 
   /**
-   * Tries to process an update to the crypto addresses.
+   * Returns the ID of a string in the given dictionary.  If create is true,
+   * it is added if necessary.  Otherwise, false is returned if it is not
+   * in the dictionary yet.
    */
-  void HandleAddressUpdate (const std::string& name, const Json::Value& obj);
+  bool GetId (Dictionary& dict, const std::string& str, bool create,
+              int64_t& id);
+
+  /**
+   * Sets the list of signers for a particular application (or global signers
+   * if nullptr is passed) in the database.
+   */
+  void SetSignerList (const std::string& name, const std::string* application,
+                      const SignerList& signers);
+
+  /**
+   * Sets or removes the address association for a given name and key
+   * in the database.
+   */
+  void SetAddress (const std::string& name, const std::string& key,
+                   const std::optional<std::string>& addr);
 
 public:
 
-  explicit MoveProcessor (xaya::SQLiteDatabase& d)
-    : db(d)
+  explicit MoveProcessor (xaya::SQLiteDatabase& d, StatementRegistry& s,
+                          Dictionaries& dict)
+    : db(d), stmts(s), dicts(dict)
   {}
 
   MoveProcessor (const MoveProcessor&) = delete;
   void operator= (const MoveProcessor&) = delete;
 
+  /**
+   * Sets a worker pool that should be used to decode moves in parallel.
+   */
+  void
+  SetDecodePool (WorkerPool& p)
+  {
+    decodePool = &p;
+  }
+
   /**
    * Processes all moves from the given JSON array.
    */
   void ProcessAll (const Json::Value& arr);
 
+  /**
+   * Applies the given moves of a block, which have been decoded already.
+   */
+  void ApplyAll (std::vector<DecodedMove>&& moves);
+
+  /**
+   * Returns the names whose signers have been updated (possibly to the
+   * same value as before) by all moves applied so far.
+   */
+  const std::set<std::string>&
+  GetSignerChanges () const
+  {
+    return signerChanges;
+  }
+
 };
 
 } // namespace xid
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -6,7 +6,9 @@
 
 #include "dbtest.hpp"
 #include "gamestatejson.hpp"
+#include "schema.hpp"
 #include "testutils.hpp"
+#include "workerpool.hpp"
 
 #include <gtest/gtest.h>
 
@@ -14,6 +16,12 @@
 
 #include <json/json.h>
 
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
 namespace xid
 {
 namespace
@@ -26,6 +34,12 @@ class MoveProcessorTests : public DBTestWithSchema
 
 protected:
 
+  /** Registry of prepared statements used for the move processor.  */
+  StatementRegistry stmts;
+
+  /** Dictionaries used for the move processor.  */
+  Dictionaries dicts;
+
   /**
    * Runs the given string (parsed as JSON) through the move processor.
    */
@@ -35,7 +49,7 @@ protected:
     Json::Value val;
     in >> val;
 
-    MoveProcessor proc(GetDb ());
+    MoveProcessor proc(GetDb (), stmts, dicts);
     proc.ProcessAll (val);
   }
 
@@ -82,6 +96,233 @@ TEST_F (MoveProcessorTests, AllMoveDataAccepted)
     }
 }
 
+TEST_F (MoveProcessorTests, StatementsPreparedOnce)
+{
+  const std::string move = R"({
+    "name": "domob",
+    "move":
+      {
+        "s": {"g": ["global"], "a": {"app": ["addr"]}},
+        "ca": {"btc": "1domob", "eth": null}
+      }
+  })";
+
+  Process ("[" + move + "]");
+  const unsigned prepared = stmts.GetNumPrepared ();
+  EXPECT_GT (prepared, 0);
+
+  std::ostringstream manyMoves;
+  manyMoves << "[" << move;
+  for (unsigned i = 0; i < 100; ++i)
+    manyMoves << ", " << move;
+  manyMoves << "]";
+
+  Process (manyMoves.str ());
+  EXPECT_EQ (stmts.GetNumPrepared (), prepared);
+}
+
+TEST_F (MoveProcessorTests, StatementsForNewConnection)
+{
+  Process (R"([{"name": "domob", "move": {"s": {"g": ["addr"]}}}])");
+
+  xaya::SQLiteDatabase other("other",
+                             SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE
+                               | SQLITE_OPEN_MEMORY);
+  SetupDatabaseSchema (other);
+
+  Json::Value moves(Json::arrayValue);
+  Json::Value mv(Json::objectValue);
+  mv["name"] = "foo";
+  mv["move"]["s"]["g"].append ("addr");
+  moves.append (mv);
+
+  EXPECT_DEATH (MoveProcessor (other, stmts, dicts).ProcessAll (moves),
+                "without Clear");
+
+  stmts.Clear ();
+  dicts.Clear ();
+  MoveProcessor (other, stmts, dicts).ProcessAll (moves);
+  EXPECT_EQ (GetFullState (other)["names"].getMemberNames (),
+             std::vector<std::string> ({"foo"}));
+}
+
+TEST_F (MoveProcessorTests, SignerChanges)
+{
+  std::istringstream in(R"([
+    {"name": "global", "move": {"s": {"g": []}}},
+    {"name": "app", "move": {"s": {"a": {"app": ["addr"]}}}},
+    {"name": "address", "move": {"ca": {"btc": "1domob"}}},
+    {"name": "invalid", "move": {"s": {"g": "not an array"}}},
+    {"name": "global", "move": {"s": {"g": ["again"]}}}
+  ])");
+  Json::Value moves;
+  in >> moves;
+
+  MoveProcessor proc(GetDb (), stmts, dicts);
+  proc.ProcessAll (moves);
+  EXPECT_EQ (proc.GetSignerChanges (),
+             std::set<std::string> ({"app", "global"}));
+}
+
+/* ************************************************************************** */
+
+class ParallelDecodeTests : public MoveProcessorTests
+{
+
+private:
+
+  /** Random generator for the test data (with fixed seed).  */
+  std::mt19937 rnd;
+
+  /**
+   * Returns a random string, taken from a small set of possible values
+   * with the given prefix (so that there are collisions).
+   */
+  std::string
+  RandomString (const std::string& prefix, const unsigned num)
+  {
+    std::ostringstream out;
+    out << prefix << " " << (rnd () % num);
+    return out.str ();
+  }
+
+  /**
+   * Returns a random JSON value that is invalid as any part of a move
+   * (e.g. used to test skipping of invalid entries).
+   */
+  Json::Value
+  RandomInvalid ()
+  {
+    switch (rnd () % 3)
+      {
+      case 0:
+        return 42;
+      case 1:
+        return Json::Value (Json::objectValue);
+      default:
+        return true;
+      }
+  }
+
+  /**
+   * Returns a random JSON array of signer addresses.
+   */
+  Json::Value
+  RandomSigners ()
+  {
+    Json::Value res(Json::arrayValue);
+    const unsigned n = rnd () % 4;
+    for (unsigned i = 0; i < n; ++i)
+      {
+        if (rnd () % 10 == 0)
+          res.append (RandomInvalid ());
+        else
+          res.append (RandomString ("addr", 10));
+      }
+    return res;
+  }
+
+  /**
+   * Returns a random move entry (including name and move data).
+   */
+  Json::Value
+  RandomMove ()
+  {
+    Json::Value res(Json::objectValue);
+    res["name"] = RandomString ("name", 20);
+
+    if (rnd () % 20 == 0)
+      {
+        res["move"] = RandomInvalid ();
+        return res;
+      }
+
+    Json::Value mv(Json::objectValue);
+
+    if (rnd () % 2 == 0)
+      {
+        Json::Value s(Json::objectValue);
+        if (rnd () % 2 == 0)
+          s["g"] = rnd () % 10 == 0 ? RandomInvalid () : RandomSigners ();
+
+        Json::Value apps(Json::objectValue);
+        const unsigned n = rnd () % 3;
+        for (unsigned i = 0; i < n; ++i)
+          apps[RandomString ("app", 5)]
+              = rnd () % 10 == 0 ? RandomInvalid () : RandomSigners ();
+        s["a"] = apps;
+
+        mv["s"] = s;
+      }
+
+    if (rnd () % 2 == 0)
+      {
+        Json::Value ca(Json::objectValue);
+        const unsigned n = rnd () % 4;
+        for (unsigned i = 0; i < n; ++i)
+          {
+            const auto key = RandomString ("key", 5);
+            switch (rnd () % 4)
+              {
+              case 0:
+                ca[key] = Json::Value ();
+                break;
+              case 1:
+                ca[key] = RandomInvalid ();
+                break;
+              default:
+                ca[key] = RandomString ("crypto", 10);
+                break;
+              }
+          }
+        mv["ca"] = ca;
+      }
+
+    res["move"] = mv;
+    return res;
+  }
+
+protected:
+
+  /**
+   * Returns a random block of moves with the given size.
+   */
+  Json::Value
+  RandomBlock (const unsigned n)
+  {
+    Json::Value res(Json::arrayValue);
+    for (unsigned i = 0; i < n; ++i)
+      res.append (RandomMove ());
+    return res;
+  }
+
+};
+
+TEST_F (ParallelDecodeTests, SameAsSequential)
+{
+  xaya::SQLiteDatabase parallelDb("parallel",
+                                  SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE
+                                    | SQLITE_OPEN_MEMORY);
+  SetupDatabaseSchema (parallelDb);
+  StatementRegistry parallelStmts;
+  Dictionaries parallelDicts;
+  WorkerPool pool(4);
+
+  for (const unsigned n : {0, 1, 10, 100, 500, 1'000, 200, 1'000})
+    {
+      const auto block = RandomBlock (n);
+
+      MoveProcessor sequential(GetDb (), stmts, dicts);
+      sequential.ProcessAll (block);
+
+      MoveProcessor parallel(parallelDb, parallelStmts, parallelDicts);
+      parallel.SetDecodePool (pool);
+      parallel.ProcessAll (block);
+
+      ASSERT_EQ (GetFullState (parallelDb), GetFullState (GetDb ()));
+    }
+}
+
 /* ************************************************************************** */
 
 class UpdateSignerTests : public MoveProcessorTests
@@ -98,7 +339,7 @@ protected:
              const std::string& address)
   {
     auto stmt = GetDb ().Prepare (R"(
-      INSERT INTO `signers`
+      INSERT INTO `test_signers`
         (`name`, `application`, `address`)
         VALUES (?1, ?2, ?3)
     )");
@@ -113,6 +354,32 @@ protected:
     stmt.Execute ();
   }
 
+  /**
+   * Returns the total number of rows changed in the database so far.
+   * This is used to verify that unchanged entries are not touched
+   * by updates.
+   */
+  int64_t
+  GetTotalChanges ()
+  {
+    auto stmt = GetDb ().Prepare ("SELECT total_changes ()");
+    CHECK (stmt.Step ());
+    return stmt.Get<int64_t> (0);
+  }
+
+  /**
+   * Returns the total number of rows in the signers table.
+   */
+  unsigned
+  CountSignerRows ()
+  {
+    auto stmt = GetDb ().Prepare (R"(
+      SELECT COUNT (*) FROM `signers`
+    )");
+    CHECK (stmt.Step ());
+    return stmt.Get<int64_t> (0);
+  }
+
 };
 
 TEST_F (UpdateSignerTests, BasicUpdate)
@@ -307,6 +574,193 @@ TEST_F (UpdateSignerTests, InvalidStuffIgnored)
   )");
 }
 
+TEST_F (UpdateSignerTests, UnchangedEntriesKept)
+{
+  AddSigner ("domob", "global", "global 1");
+  AddSigner ("domob", "global", "global 2");
+  AddSigner ("domob", "app", "app 1");
+  AddSigner ("domob", "app", "app 2");
+
+  const auto changesBefore = GetTotalChanges ();
+
+  Process (R"([
+    {
+      "name": "domob",
+      "move":
+        {
+          "s":
+            {
+              "g": ["global 1", "global 3"],
+              "a": {"app": ["app 3", "app 2"]}
+            }
+        }
+    }
+  ])");
+
+  ExpectNameState ("domob", "signers", R"(
+    [
+      {"addresses": ["global 1", "global 3"]},
+      {
+        "application": "app",
+        "addresses": ["app 2", "app 3"]
+      }
+    ]
+  )");
+  /* One address each has been removed and added for global and app
+     signers.  The unchanged entries were not touched.  */
+  EXPECT_EQ (GetTotalChanges () - changesBefore, 4);
+  EXPECT_EQ (CountSignerRows (), 4);
+}
+
+TEST_F (UpdateSignerTests, BinaryAddresses)
+{
+  Process (R"([
+    {
+      "name": "domob",
+      "move":
+        {
+          "s":
+            {
+              "g": ["CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C", "other"],
+              "a": {"app": ["cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn"]}
+            }
+        }
+    }
+  ])");
+
+  auto stmt = GetDb ().Prepare (R"(
+    SELECT COUNT (*) FROM `signers` WHERE typeof (`address`) = 'blob'
+  )");
+  ASSERT_TRUE (stmt.Step ());
+  EXPECT_EQ (stmt.Get<int64_t> (0), 2);
+
+  ExpectNameState ("domob", "signers", R"(
+    [
+      {"addresses": ["CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C", "other"]},
+      {
+        "application": "app",
+        "addresses": ["cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn"]
+      }
+    ]
+  )");
+
+  Process (R"([
+    {
+      "name": "domob",
+      "move":
+        {
+          "s":
+            {
+              "g": ["other"],
+              "a": {"app": ["CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"]}
+            }
+        }
+    }
+  ])");
+
+  ExpectNameState ("domob", "signers", R"(
+    [
+      {"addresses": ["other"]},
+      {
+        "application": "app",
+        "addresses": ["CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"]
+      }
+    ]
+  )");
+  EXPECT_EQ (CountSignerRows (), 2);
+}
+
+TEST_F (UpdateSignerTests, DuplicateAddresses)
+{
+  Process (R"([
+    {
+      "name": "domob",
+      "move":
+        {
+          "s":
+            {
+              "g": ["addr", "addr"],
+              "a": {"app": ["addr", "other", "addr"]}
+            }
+        }
+    }
+  ])");
+
+  ExpectNameState ("domob", "signers", R"(
+    [
+      {"addresses": ["addr"]},
+      {
+        "application": "app",
+        "addresses": ["addr", "other"]
+      }
+    ]
+  )");
+  EXPECT_EQ (CountSignerRows (), 3);
+}
+
+TEST_F (UpdateSignerTests, MultipleMovesInBlock)
+{
+  AddSigner ("domob", "global", "old global");
+  AddSigner ("domob", "app", "old app");
+  AddSigner ("domob", "other", "old other");
+
+  Process (R"([
+    {
+      "name": "domob",
+      "move":
+        {
+          "s":
+            {
+              "g": ["first global"],
+              "a": {"app": ["first app"], "other": []}
+            }
+        }
+    },
+    {
+      "name": "foo",
+      "move": {"s": {"g": ["foo"]}}
+    },
+    {
+      "name": "domob",
+      "move":
+        {
+          "s":
+            {
+              "g": ["second global", 42],
+              "a": {"other": ["second other"], "new": "not an array"}
+            }
+        }
+    },
+    {
+      "name": "domob",
+      "move": {"s": {"a": {"new": ["third new"]}}}
+    }
+  ])");
+
+  ExpectNameState ("domob", "signers", R"(
+    [
+      {"addresses": ["second global"]},
+      {
+        "application": "app",
+        "addresses": ["first app"]
+      },
+      {
+        "application": "new",
+        "addresses": ["third new"]
+      },
+      {
+        "application": "other",
+        "addresses": ["second other"]
+      }
+    ]
+  )");
+  ExpectNameState ("foo", "signers", R"(
+    [
+      {"addresses": ["foo"]}
+    ]
+  )");
+}
+
 /* ************************************************************************** */
 
 class UpdateAddressesTests : public MoveProcessorTests
@@ -322,7 +776,7 @@ protected:
               const std::string& address)
   {
     auto stmt = GetDb ().Prepare (R"(
-      INSERT INTO `addresses`
+      INSERT INTO `test_addresses`
         (`name`, `key`, `address`)
         VALUES (?1, ?2, ?3)
     )");
@@ -443,6 +897,49 @@ TEST_F (UpdateAddressesTests, InvalidStuffIgnored)
   )");
 }
 
+TEST_F (UpdateAddressesTests, MultipleMovesInBlock)
+{
+  AddAddress ("domob", "btc", "1domob");
+  AddAddress ("domob", "chi", "C123456");
+
+  Process (R"([
+    {
+      "name": "domob",
+      "move":
+        {
+          "ca":
+            {
+              "btc": null,
+              "chi": "Cfirst",
+              "eth": "0xFirst",
+              "ltc": "Lfirst"
+            }
+        }
+    },
+    {
+      "name": "domob",
+      "move":
+        {
+          "ca":
+            {
+              "btc": "3domob",
+              "chi": null,
+              "eth": 42,
+              "ltc": "Lsecond"
+            }
+        }
+    }
+  ])");
+
+  ExpectNameState ("domob", "addresses", R"(
+    {
+      "btc": "3domob",
+      "eth": "0xFirst",
+      "ltc": "Lsecond"
+    }
+  )");
+}
+
 /* ************************************************************************** */
 
 } // anonymous namespace
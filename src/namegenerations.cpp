@@ -0,0 +1,38 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "namegenerations.hpp"
+
+#include <functional>
+
+namespace xid
+{
+
+NameGenerations::NameGenerations ()
+  : counters(new std::atomic<uint64_t>[NUM_BUCKETS])
+{
+  for (size_t i = 0; i < NUM_BUCKETS; ++i)
+    counters[i] = 0;
+}
+
+std::atomic<uint64_t>&
+NameGenerations::GetCounter (const std::string& name) const
+{
+  const size_t bucket = std::hash<std::string> () (name) % NUM_BUCKETS;
+  return counters[bucket];
+}
+
+uint64_t
+NameGenerations::Get (const std::string& name) const
+{
+  return GetCounter (name).load ();
+}
+
+void
+NameGenerations::Bump (const std::string& name)
+{
+  ++GetCounter (name);
+}
+
+} // namespace xid
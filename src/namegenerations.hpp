@@ -0,0 +1,69 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_NAMEGENERATIONS_HPP
+#define XID_NAMEGENERATIONS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace xid
+{
+
+/**
+ * In-memory "generation" counters for names, which are bumped whenever the
+ * signers of a name may have changed (including on undo).  Data derived from
+ * the signers of a name (like session tokens or cached verifyauth results)
+ * can record the generation it was computed at, and is outdated as soon as
+ * the generation changes.
+ *
+ * To avoid keeping state for every name, the counters are kept in a fixed
+ * number of buckets indexed by a hash of the name.  A change to one name thus
+ * also invalidates data for other names in the same bucket, which is safe.
+ *
+ * All methods are thread-safe and lock-free.
+ */
+class NameGenerations
+{
+
+private:
+
+  /** Number of buckets for the generation counters.  */
+  static constexpr size_t NUM_BUCKETS = 1 << 16;
+
+  /** The generation counters.  */
+  std::unique_ptr<std::atomic<uint64_t>[]> counters;
+
+  /**
+   * Returns the counter for the given name.
+   */
+  std::atomic<uint64_t>& GetCounter (const std::string& name) const;
+
+public:
+
+  NameGenerations ();
+
+  NameGenerations (const NameGenerations&) = delete;
+  void operator= (const NameGenerations&) = delete;
+
+  /**
+   * Returns the current generation of a name.  To make sure that derived
+   * data does not outlive a signer change, this has to be read before
+   * taking the state snapshot from which the data is computed.
+   */
+  uint64_t Get (const std::string& name) const;
+
+  /**
+   * Marks the signers of the given name as (potentially) changed.
+   */
+  void Bump (const std::string& name);
+
+};
+
+} // namespace xid
+
+#endif // XID_NAMEGENERATIONS_HPP
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -6,17 +6,386 @@
 
 #include "gamestatejson.hpp"
 
-#include <microhttpd.h>
+#include <glog/logging.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
 
 namespace xid
 {
 
+namespace
+{
+
+/**
+ * Parses the remainder of a /listnames/ request, which is of the form
+ * COUNT or COUNT/CURSOR.  Returns false if it is invalid.
+ */
+bool
+ParseListNamesRequest (const std::string& remainder,
+                       unsigned& count, std::string& cursor)
+{
+  const size_t slash = remainder.find ('/');
+  const std::string countStr = remainder.substr (0, slash);
+  if (slash == std::string::npos)
+    cursor.clear ();
+  else
+    cursor = remainder.substr (slash + 1);
+
+  if (countStr.empty () || countStr.size () > 4
+        || countStr.find_first_not_of ("0123456789") != std::string::npos)
+    return false;
+
+  count = std::stoul (countStr);
+  return count > 0 && count <= MAX_NAMES_PER_PAGE;
+}
+
+/** Size of the chunks in which the full state is streamed.  */
+constexpr size_t STREAM_CHUNK_SIZE = 64 << 10;
+
+/**
+ * Maximum number of chunks that are buffered between the thread writing the
+ * full state and the client reading it.  When the client is slower, the
+ * writer waits for it, so that memory usage is bounded.
+ */
+constexpr size_t STREAM_MAX_CHUNKS = 16;
+
+/**
+ * Stream buffer that passes the data written to it on in chunks, to be read
+ * by another thread.  Writing blocks while enough data is buffered already.
+ * If the reader cancels the stream, writing fails.
+ */
+class ChunkPipe : public std::streambuf
+{
+
+private:
+
+  /** The chunk currently being written (the put area).  */
+  std::vector<char> current;
+
+  /** Lock for the shared state below.  */
+  std::mutex mut;
+
+  /** Condition variable notified when the shared state changes.  */
+  std::condition_variable cv;
+
+  /** Chunks that are ready for reading.  */
+  std::deque<std::string> chunks;
+
+  /** Number of bytes of the first chunk that have been read already.  */
+  size_t readOffset = 0;
+
+  /** Set when the writer is done.  */
+  bool finished = false;
+
+  /** Whether the writer produced all data successfully.  */
+  bool success = false;
+
+  /** Set when the reader is gone and no more data should be written.  */
+  bool cancelled = false;
+
+  /**
+   * Passes the data in the put area on to the reader, waiting for space
+   * if necessary.  Returns false if the stream has been cancelled.
+   */
+  bool
+  PushChunk ()
+  {
+    const size_t len = pptr () - pbase ();
+    setp (current.data (), current.data () + current.size ());
+
+    std::unique_lock<std::mutex> lock(mut);
+    if (len > 0)
+      {
+        cv.wait (lock, [this] ()
+          {
+            return cancelled || chunks.size () < STREAM_MAX_CHUNKS;
+          });
+        if (!cancelled)
+          chunks.emplace_back (current.data (), len);
+        cv.notify_all ();
+      }
+
+    return !cancelled;
+  }
+
+protected:
+
+  int_type
+  overflow (const int_type c) override
+  {
+    if (!PushChunk ())
+      return traits_type::eof ();
+
+    if (!traits_type::eq_int_type (c, traits_type::eof ()))
+      {
+        *pptr () = traits_type::to_char_type (c);
+        pbump (1);
+      }
+
+    return traits_type::not_eof (c);
+  }
+
+  int
+  sync () override
+  {
+    return PushChunk () ? 0 : -1;
+  }
+
+public:
+
+  ChunkPipe ()
+    : current(STREAM_CHUNK_SIZE)
+  {
+    setp (current.data (), current.data () + current.size ());
+  }
+
+  /**
+   * Marks the stream as finished.  This must be called by the writer
+   * after flushing all data.
+   */
+  void
+  Finish (const bool ok)
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    finished = true;
+    success = ok;
+    cv.notify_all ();
+  }
+
+  /**
+   * Cancels the stream from the reader side.
+   */
+  void
+  Cancel ()
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    cancelled = true;
+    cv.notify_all ();
+  }
+
+  /**
+   * Reads up to max bytes into the buffer, waiting until data is available.
+   * Returns the number of bytes read, or an MHD content-reader end marker
+   * when the stream is finished.
+   */
+  ssize_t
+  Read (char* buf, const size_t max)
+  {
+    std::unique_lock<std::mutex> lock(mut);
+    cv.wait (lock, [this] ()
+      {
+        return finished || !chunks.empty ();
+      });
+
+    if (chunks.empty ())
+      return success ? MHD_CONTENT_READER_END_OF_STREAM
+                     : MHD_CONTENT_READER_END_WITH_ERROR;
+
+    const std::string& front = chunks.front ();
+    const size_t len = std::min (max, front.size () - readOffset);
+    std::copy_n (front.data () + readOffset, len, buf);
+    readOffset += len;
+
+    if (readOffset == front.size ())
+      {
+        chunks.pop_front ();
+        readOffset = 0;
+        cv.notify_all ();
+      }
+
+    return len;
+  }
+
+};
+
+} // anonymous namespace
+
+/**
+ * The response to a /fullstate request.  The state is written by a separate
+ * thread through a ChunkPipe, from which MHD reads it while sending.  The
+ * database snapshot is held until the writer is done (or the client
+ * goes away).
+ */
+class RestApi::FullStateStream
+{
+
+private:
+
+  /** The pipe through which the data is passed.  */
+  ChunkPipe pipe;
+
+  /** The thread writing the state.  */
+  std::thread writer;
+
+public:
+
+  explicit FullStateStream (xaya::Game& game, XidGame& logic)
+  {
+    writer = std::thread ([this, &game, &logic] ()
+      {
+        std::ostream out(&pipe);
+        out.exceptions (std::ios::badbit);
+
+        try
+          {
+            logic.WriteCurrentState (game, out, true);
+            out.flush ();
+            pipe.Finish (true);
+          }
+        catch (const std::ios::failure& exc)
+          {
+            LOG (WARNING) << "Full-state response aborted: " << exc.what ();
+            pipe.Finish (false);
+          }
+      });
+  }
+
+  ~FullStateStream ()
+  {
+    pipe.Cancel ();
+    writer.join ();
+  }
+
+  FullStateStream (const FullStateStream&) = delete;
+  void operator= (const FullStateStream&) = delete;
+
+  static ssize_t
+  ReadCallback (void* cls, const uint64_t pos, char* buf, const size_t max)
+  {
+    return static_cast<FullStateStream*> (cls)->pipe.Read (buf, max);
+  }
+
+  static void
+  FreeCallback (void* cls)
+  {
+    delete static_cast<FullStateStream*> (cls);
+  }
+
+};
+
+RestApi::~RestApi ()
+{
+  if (daemon != nullptr)
+    Stop ();
+}
+
+void
+RestApi::Start ()
+{
+  CHECK (daemon == nullptr) << "RestApi is already running";
+
+  /* Each connection has its own thread, since the /fullstate response
+     blocks while waiting for data to be written.  */
+  daemon = MHD_start_daemon (
+      MHD_USE_THREAD_PER_CONNECTION | MHD_USE_INTERNAL_POLLING_THREAD,
+      port, nullptr, nullptr, &RequestCallback, this,
+      MHD_OPTION_END);
+  CHECK (daemon != nullptr) << "Failed to start REST server on port " << port;
+  LOG (INFO) << "Started REST server on port " << port;
+}
+
+void
+RestApi::Stop ()
+{
+  CHECK (daemon != nullptr) << "RestApi is not running";
+  MHD_stop_daemon (daemon);
+  daemon = nullptr;
+  LOG (INFO) << "Stopped REST server";
+}
+
+unsigned
+RestApi::BuildResponse (const std::string& url, struct MHD_Response*& resp)
+{
+  if (fullState && url == "/fullstate")
+    {
+      /* The full state is serialised as text directly from the database
+         cursors, without building up a Json::Value for it first.  It is
+         streamed to the client in chunks while doing so.  */
+      resp = MHD_create_response_from_callback (
+          MHD_SIZE_UNKNOWN, STREAM_CHUNK_SIZE,
+          &FullStateStream::ReadCallback, new FullStateStream (game, logic),
+          &FullStateStream::FreeCallback);
+      CHECK (resp != nullptr);
+      MHD_add_response_header (resp, MHD_HTTP_HEADER_CONTENT_TYPE,
+                               "application/json");
+      return MHD_HTTP_OK;
+    }
+
+  unsigned code;
+  std::string type, payload;
+  try
+    {
+      const SuccessResult res = Process (url);
+      code = MHD_HTTP_OK;
+      type = res.GetType ();
+      payload = res.GetPayload ();
+    }
+  catch (const HttpError& exc)
+    {
+      code = exc.GetStatusCode ();
+      type = "text/plain";
+      payload = exc.what ();
+    }
+
+  resp = MHD_create_response_from_buffer (payload.size (),
+                                          const_cast<char*> (payload.data ()),
+                                          MHD_RESPMEM_MUST_COPY);
+  CHECK (resp != nullptr);
+  MHD_add_response_header (resp, MHD_HTTP_HEADER_CONTENT_TYPE, type.c_str ());
+
+  return code;
+}
+
+MHD_Result
+RestApi::RequestCallback (void* data, struct MHD_Connection* conn,
+                          const char* url, const char* method,
+                          const char* version,
+                          const char* upload, size_t* uploadSize,
+                          void** connData)
+{
+  auto* self = static_cast<RestApi*> (data);
+
+  struct MHD_Response* resp;
+  unsigned code;
+  if (std::string (method) != "GET")
+    {
+      const std::string msg = "only GET requests are supported";
+      resp = MHD_create_response_from_buffer (msg.size (),
+                                              const_cast<char*> (msg.data ()),
+                                              MHD_RESPMEM_MUST_COPY);
+      CHECK (resp != nullptr);
+      code = MHD_HTTP_METHOD_NOT_ALLOWED;
+    }
+  else
+    code = self->BuildResponse (url, resp);
+
+  const MHD_Result ret = MHD_queue_response (conn, code, resp);
+  MHD_destroy_response (resp);
+
+  return ret;
+}
+
 RestApi::SuccessResult
 RestApi::Process (const std::string& url)
 {
+  if (url == "/state")
+    {
+      /* The server state is written through the same code as the full state
+         (just without the game state), so that both are consistent.  */
+      std::ostringstream out;
+      logic.WriteCurrentState (game, out, false);
+      return SuccessResult ("application/json", out.str ());
+    }
+
   SuccessResult res;
-  if (HandleState (url, game, res))
-    return res;
   if (HandleHealthz (url, game, res))
     return res;
 
@@ -31,6 +400,79 @@ RestApi::Process (const std::string& url)
       return SuccessResult (res);
     }
 
+  if (MatchEndpoint (url, "/names/", remainder))
+    {
+      /* The names are passed as JSON array in the (URL-encoded) path.  */
+      std::istringstream in(remainder);
+      Json::CharReaderBuilder rbuilder;
+      Json::Value namesJson;
+      std::string parseErrs;
+      if (!Json::parseFromStream (rbuilder, in, &namesJson, &parseErrs))
+        throw HttpError (MHD_HTTP_BAD_REQUEST, "invalid JSON for names");
+
+      std::vector<std::string> names;
+      if (!ParseNameList (namesJson, names))
+        throw HttpError (MHD_HTTP_BAD_REQUEST, "invalid list of names");
+
+      const Json::Value res = logic.GetCustomStateData (game,
+        [&names] (const xaya::SQLiteDatabase& db)
+          {
+            return GetNameStates (db, names);
+          });
+      return SuccessResult (res);
+    }
+
+  if (MatchEndpoint (url, "/lookupsigner/", remainder))
+    {
+      const Json::Value res = logic.GetCustomStateData (game,
+        [&remainder] (const xaya::SQLiteDatabase& db)
+          {
+            return LookupSigner (db, remainder);
+          });
+      return SuccessResult (res);
+    }
+
+  if (MatchEndpoint (url, "/lookupaddress/", remainder))
+    {
+      /* The remainder is KEY/ADDRESS.  Keys are short identifiers like
+         "btc", so they are assumed not to contain a slash (while the
+         address might).  */
+      const size_t slash = remainder.find ('/');
+      if (slash == std::string::npos)
+        throw HttpError (MHD_HTTP_BAD_REQUEST, "invalid lookupaddress request");
+      const std::string key = remainder.substr (0, slash);
+      const std::string address = remainder.substr (slash + 1);
+
+      const Json::Value res = logic.GetCustomStateData (game,
+        [&key, &address] (const xaya::SQLiteDatabase& db)
+          {
+            return LookupAddress (db, key, address);
+          });
+      return SuccessResult (res);
+    }
+
+  if (MatchEndpoint (url, "/listnames/", remainder))
+    {
+      unsigned count;
+      std::string cursor;
+      if (!ParseListNamesRequest (remainder, count, cursor))
+        throw HttpError (MHD_HTTP_BAD_REQUEST, "invalid listnames request");
+
+      bool ok = false;
+      const Json::Value res = logic.GetCustomStateData (game,
+        [count, &cursor, &ok] (const xaya::SQLiteDatabase& db)
+          {
+            Json::Value page;
+            ok = ListNames (db, cursor, count, page);
+            return page;
+          });
+
+      if (!ok)
+        throw HttpError (MHD_HTTP_BAD_REQUEST, "invalid cursor");
+
+      return SuccessResult (res);
+    }
+
   throw HttpError (MHD_HTTP_NOT_FOUND, "invalid API endpoint");
 }
 
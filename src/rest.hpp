@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -10,23 +10,56 @@
 #include <xayagame/game.hpp>
 #include <xayagame/rest.hpp>
 
+#include <microhttpd.h>
+
 namespace xid
 {
 
 /**
  * HTTP server providing a REST API for reading xid data.
+ *
+ * The endpoints themselves are implemented in Process, like for other
+ * xaya::RestApi servers.  The HTTP daemon is run by this class directly,
+ * though, so that the /fullstate response can be streamed to the client
+ * while it is serialised (rather than buffered in full).
  */
 class RestApi : public xaya::RestApi
 {
 
 private:
 
+  class FullStateStream;
+
   /** The underlying Game instance that manages everything.  */
   xaya::Game& game;
 
   /** The game logic implementation.  */
   XidGame& logic;
 
+  /** The port to listen on.  */
+  const int port;
+
+  /** The running HTTP daemon, if any.  */
+  struct MHD_Daemon* daemon = nullptr;
+
+  /** Whether or not the full game state can be queried.  */
+  bool fullState = false;
+
+  /**
+   * Builds the response for a given request URL.  Returns the HTTP status
+   * code that should be sent with it.
+   */
+  unsigned BuildResponse (const std::string& url, struct MHD_Response*& resp);
+
+  /**
+   * Request handler function for the MHD daemon.
+   */
+  static MHD_Result RequestCallback (void* data, struct MHD_Connection* conn,
+                                     const char* url, const char* method,
+                                     const char* version,
+                                     const char* upload, size_t* uploadSize,
+                                     void** connData);
+
 protected:
 
   SuccessResult Process (const std::string& url) override;
@@ -34,9 +67,24 @@ protected:
 public:
 
   explicit RestApi (xaya::Game& g, XidGame& l, const int p)
-    : xaya::RestApi(p), game(g), logic(l)
+    : xaya::RestApi(p), game(g), logic(l), port(p)
   {}
 
+  ~RestApi ();
+
+  void Start () override;
+  void Stop () override;
+
+  /**
+   * Enables the /fullstate endpoint, which returns the entire game state.
+   * This can be a lot of data, so it is not exposed by default.
+   */
+  void
+  EnableFullState ()
+  {
+    fullState = true;
+  }
+
 };
 
 } // namespace xid
@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2022 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -28,6 +28,8 @@ enum class ErrorCode
   WALLET_LOCKED = -3,
   /* This method is considered unsafe and not enabled in the server.  */
   UNSAFE_METHOD = -4,
+  /* Session tokens are not enabled in the server.  */
+  SESSIONS_NOT_ENABLED = -5,
 
   /* The provided data (name, application, extra) is invalid while constructing
      an auth message (not validating a password).  */
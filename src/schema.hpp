@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -10,12 +10,31 @@
 namespace xid
 {
 
+/**
+ * The current schema version, i.e. the number of schema migrations
+ * that SetupDatabaseSchema applies.
+ */
+extern const unsigned SCHEMA_VERSION;
+
 /**
  * Sets up the database schema (if it is not already present) on the given
- * SQLite connection.
+ * SQLite connection.  This also applies all schema migrations that have
+ * not yet been applied to the database.
  */
 void SetupDatabaseSchema (xaya::SQLiteDatabase& db);
 
+/**
+ * Sets up the database schema, but applies migrations only up to the
+ * given version.  This is used to test individual migrations.
+ */
+void SetupDatabaseSchema (xaya::SQLiteDatabase& db, unsigned targetVersion);
+
+/**
+ * Returns the schema version (number of applied migrations) of the
+ * given database.
+ */
+unsigned GetSchemaVersion (const xaya::SQLiteDatabase& db);
+
 } // namespace xid
 
 #endif // XID_SCHEMA_HPP
@@ -1,9 +1,25 @@
--- Copyright (C) 2019 The Xaya developers
+-- Copyright (C) 2019-2026 The Xaya developers
 -- Distributed under the MIT software license, see the accompanying
 -- file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 -- =============================================================================
 
+-- Changes to the schema that cannot be expressed as idempotent statements
+-- here (or that should be applied exactly once to existing databases)
+-- are done as migrations by SetupDatabaseSchema.  This table holds the
+-- number of migrations that have been applied to the database.  It has
+-- at most a single row; if there is none, no migrations have been applied.
+CREATE TABLE IF NOT EXISTS `schema_version` (
+  `version` INTEGER NOT NULL
+);
+
+-- The tables below are in their original layout, as created by the first
+-- versions of xid.  The migrations change that layout (e.g. to replace
+-- the strings in them by IDs and add indices), and are also applied to
+-- newly created databases.
+
+-- =============================================================================
+
 -- The mapping between Xaya names that have been registered for Xid and
 -- the signer keys that are allowed for them.  Each Xaya name can have
 -- multiple valid signer keys, which is represented by multiple rows
@@ -23,12 +39,6 @@ CREATE TABLE IF NOT EXISTS `signers` (
 
 );
 
--- We need to look up signer keys by name.  That is the main request for the
--- Xid application itself.  We could also add indices that cover individual
--- addresses.  But since the number of addresses and applications for one
--- name is likely very small, such an index is not really necessary.
-CREATE INDEX IF NOT EXISTS `signers_name` ON `signers` (`name`);
-
 -- =============================================================================
 
 -- Data about associated crypto addresses with names.
@@ -1,9 +1,13 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "schema.hpp"
 
+#include "signeraddress.hpp"
+
+#include <glog/logging.h>
+
 namespace xid
 {
 namespace
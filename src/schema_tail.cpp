@@ -1,11 +1,265 @@
 )";
 
+/**
+ * Converts the signers table to the layout of migration 3.  The addresses
+ * have to be decoded in C++, so this cannot be done in SQL.
+ */
+void
+ConvertSignerAddresses (xaya::SQLiteDatabase& db)
+{
+  /* The statements are finalised before the old table is dropped.  */
+  {
+    auto stmtSel = db.Prepare (R"(
+      SELECT `name_id`, IFNULL (`application_id`, 0), `address`
+        FROM `signers`
+    )");
+    auto stmtIns = db.Prepare (R"(
+      INSERT OR IGNORE INTO `signers_new`
+        (`name_id`, `application_id`, `address`)
+        VALUES (?1, ?2, ?3)
+    )");
+
+    while (stmtSel.Step ())
+      {
+        stmtIns.Reset ();
+        stmtIns.Bind (1, stmtSel.Get<int64_t> (0));
+        stmtIns.Bind (2, stmtSel.Get<int64_t> (1));
+        BindSignerAddress (stmtIns, 3, stmtSel.Get<std::string> (2));
+        stmtIns.Execute ();
+      }
+  }
+
+  db.Execute (R"(
+    DROP TABLE `signers`;
+    ALTER TABLE `signers_new` RENAME TO `signers`;
+    CREATE INDEX `signers_address` ON `signers` (`address`);
+  )");
+}
+
+/**
+ * A schema migration.  It executes the given SQL statements, and then
+ * (if set) calls a function for data conversions that are not possible
+ * in SQL alone.
+ */
+struct Migration
+{
+  const char* sql;
+  void (*convert) (xaya::SQLiteDatabase& db);
+
+  /**
+   * Set if the migration changes the layout of tables in a way that
+   * undo data (SQLite changesets) recorded before it cannot be applied
+   * correctly anymore.
+   */
+  bool invalidatesUndo;
+};
+
+/**
+ * The table in which libxayagame's SQLiteStorage keeps undo data
+ * for the blocks that have been processed.
+ */
+constexpr const char UNDO_TABLE[] = "xayagame_undo";
+
+/**
+ * Removes all existing undo data, if there is any.  This is done after
+ * migrations that invalidate it.  The changesets in it refer to the old
+ * table layout, and applying them would either do nothing or corrupt the
+ * state.  Without them, a reorg back beyond the migration fails instead
+ * (like for a pruned block), and the game state has to be resynced.
+ */
+void
+RemoveUndoData (xaya::SQLiteDatabase& db)
+{
+  {
+    auto stmt = db.PrepareRo (R"(
+      SELECT COUNT (*)
+        FROM `sqlite_master`
+        WHERE `type` = 'table' AND `name` = ?1
+    )");
+    stmt.Bind (1, std::string (UNDO_TABLE));
+    CHECK (stmt.Step ());
+    if (stmt.Get<int64_t> (0) == 0)
+      return;
+  }
+
+  const std::string table = std::string ("`") + UNDO_TABLE + "`";
+  int64_t count;
+  {
+    auto stmt = db.PrepareRo ("SELECT COUNT (*) FROM " + table);
+    CHECK (stmt.Step ());
+    count = stmt.Get<int64_t> (0);
+  }
+  if (count == 0)
+    return;
+
+  LOG (WARNING)
+      << "Removing undo data for " << count << " blocks, which is invalid"
+      << " after the schema migration; blocks from before the migration"
+      << " cannot be detached anymore, and a reorg past it requires"
+      << " to resync the game state";
+  db.Execute ("DELETE FROM " + table);
+}
+
+/**
+ * The schema migrations, in order.  Each entry is applied exactly once
+ * to a database (after the base schema above), and the number of applied
+ * migrations is tracked in the schema_version table.  Entries must never
+ * be changed or removed once released, only new ones appended.
+ */
+const Migration MIGRATIONS[] = {
+
+  /* 1: Covering index for checking signers.  IsValidSigner looks up by
+     name and address and only needs the application, so with this it
+     does not need to access the table itself.  The previous index on
+     just the name is a prefix of this one and no longer needed.  */
+  {R"(
+    CREATE INDEX IF NOT EXISTS `signers_name_address`
+      ON `signers` (`name`, `address`, `application`);
+    DROP INDEX IF EXISTS `signers_name`;
+  )", nullptr, false},
+
+  /* 2: Names, applications and address keys are repeated in many rows
+     (and index entries), with applications and keys coming from a small
+     set of strings.  They are moved to dictionary tables, and referenced
+     by their integer ID in the signers and addresses tables.  Global
+     signers still have a NULL application.  */
+  {R"(
+    CREATE TABLE `names` (
+      `id` INTEGER PRIMARY KEY,
+      `value` TEXT NOT NULL UNIQUE
+    );
+    CREATE TABLE `applications` (
+      `id` INTEGER PRIMARY KEY,
+      `value` TEXT NOT NULL UNIQUE
+    );
+    CREATE TABLE `keys` (
+      `id` INTEGER PRIMARY KEY,
+      `value` TEXT NOT NULL UNIQUE
+    );
+
+    INSERT INTO `names` (`value`)
+      SELECT `name` FROM `signers`
+      UNION SELECT `name` FROM `addresses`;
+    INSERT INTO `applications` (`value`)
+      SELECT DISTINCT `application`
+        FROM `signers`
+        WHERE `application` IS NOT NULL;
+    INSERT INTO `keys` (`value`)
+      SELECT DISTINCT `key` FROM `addresses`;
+
+    CREATE TABLE `signers_new` (
+      `name_id` INTEGER NOT NULL,
+      `application_id` INTEGER NULL,
+      `address` TEXT NOT NULL
+    );
+    INSERT INTO `signers_new` (`name_id`, `application_id`, `address`)
+      SELECT `n`.`id`, `a`.`id`, `s`.`address`
+        FROM `signers` AS `s`
+          INNER JOIN `names` AS `n` ON `n`.`value` = `s`.`name`
+          LEFT JOIN `applications` AS `a`
+            ON `a`.`value` = `s`.`application`;
+    DROP TABLE `signers`;
+    ALTER TABLE `signers_new` RENAME TO `signers`;
+
+    CREATE TABLE `addresses_new` (
+      `name_id` INTEGER NOT NULL,
+      `key_id` INTEGER NOT NULL,
+      `address` TEXT NOT NULL,
+      PRIMARY KEY (`name_id`, `key_id`)
+    );
+    INSERT INTO `addresses_new` (`name_id`, `key_id`, `address`)
+      SELECT `n`.`id`, `k`.`id`, `a`.`address`
+        FROM `addresses` AS `a`
+          INNER JOIN `names` AS `n` ON `n`.`value` = `a`.`name`
+          INNER JOIN `keys` AS `k` ON `k`.`value` = `a`.`key`;
+    DROP TABLE `addresses`;
+    ALTER TABLE `addresses_new` RENAME TO `addresses`;
+
+    CREATE INDEX `signers_name_address`
+      ON `signers` (`name_id`, `address`, `application_id`);
+    CREATE INDEX `signers_address` ON `signers` (`address`);
+    CREATE INDEX `addresses_key_address`
+      ON `addresses` (`key_id`, `address`);
+  )", nullptr, true},
+
+  /* 3: Signer addresses are stored in binary form where possible (see
+     EncodeSignerAddress), which makes them and the index entries smaller
+     and cheaper to compare.  The table is changed to WITHOUT ROWID,
+     with a primary key that directly serves IsValidSigner.  Since primary
+     key columns cannot be NULL, global signers use application ID zero
+     (dictionary IDs start at one).  Undo data still refers to the
+     old layout and is removed.  */
+  {R"(
+    CREATE TABLE `signers_new` (
+      `name_id` INTEGER NOT NULL,
+      `address` BLOB NOT NULL,
+      `application_id` INTEGER NOT NULL,
+      PRIMARY KEY (`name_id`, `address`, `application_id`)
+    ) WITHOUT ROWID;
+  )", &ConvertSignerAddresses, true},
+
+};
+
 } // anonymous namespace
 
+const unsigned SCHEMA_VERSION = sizeof (MIGRATIONS) / sizeof (MIGRATIONS[0]);
+
+unsigned
+GetSchemaVersion (const xaya::SQLiteDatabase& db)
+{
+  auto stmt = db.PrepareRo (R"(
+    SELECT `version`
+      FROM `schema_version`
+  )");
+
+  if (!stmt.Step ())
+    return 0;
+
+  const unsigned res = stmt.Get<int64_t> (0);
+  CHECK (!stmt.Step ()) << "Multiple rows in schema_version";
+
+  return res;
+}
+
 void
 SetupDatabaseSchema (xaya::SQLiteDatabase& db)
 {
+  SetupDatabaseSchema (db, SCHEMA_VERSION);
+}
+
+void
+SetupDatabaseSchema (xaya::SQLiteDatabase& db, const unsigned targetVersion)
+{
+  CHECK_LE (targetVersion, SCHEMA_VERSION);
   db.Execute (SCHEMA_SQL);
+
+  const unsigned version = GetSchemaVersion (db);
+  CHECK_LE (version, SCHEMA_VERSION)
+      << "Database schema version " << version
+      << " is newer than supported version " << SCHEMA_VERSION;
+
+  /* Each migration is applied together with the version update inside
+     a savepoint, so that it is atomic (also if we are already inside
+     a transaction).  */
+  for (unsigned v = version; v < targetVersion; ++v)
+    {
+      LOG (INFO) << "Applying schema migration " << (v + 1);
+      db.Execute ("SAVEPOINT `xid_migration`");
+      db.Execute (MIGRATIONS[v].sql);
+      if (MIGRATIONS[v].convert != nullptr)
+        MIGRATIONS[v].convert (db);
+      if (MIGRATIONS[v].invalidatesUndo)
+        RemoveUndoData (db);
+
+      db.Execute ("DELETE FROM `schema_version`");
+      auto stmt = db.Prepare (R"(
+        INSERT INTO `schema_version` (`version`) VALUES (?1)
+      )");
+      stmt.Bind<int64_t> (1, v + 1);
+      stmt.Execute ();
+
+      db.Execute ("RELEASE `xid_migration`");
+    }
 }
 
 } // namespace xid
@@ -1,13 +1,21 @@
-// Copyright (C) 2019-2020 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "schema.hpp"
 
 #include "dbtest.hpp"
+#include "gamestatejson.hpp"
+#include "testutils.hpp"
 
 #include <gtest/gtest.h>
 
+#include <glog/logging.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+
 namespace xid
 {
 namespace
@@ -26,5 +34,313 @@ TEST_F (SchemaTests, TwiceIsOk)
   SetupDatabaseSchema (GetDb ());
 }
 
+/**
+ * Returns true if an index with the given name exists.
+ */
+bool
+HasIndex (const xaya::SQLiteDatabase& db, const std::string& name)
+{
+  auto stmt = db.PrepareRo (R"(
+    SELECT COUNT(*)
+      FROM `sqlite_master`
+      WHERE `type` = 'index' AND `name` = ?1
+  )");
+  stmt.Bind (1, name);
+  CHECK (stmt.Step ());
+  return stmt.Get<int64_t> (0) > 0;
+}
+
+/**
+ * Sets up the database with the schema from before the versioning
+ * and the lookup indices were added, i.e. as created by older versions
+ * of xid, and inserts some data.  This is also the layout of version 0
+ * (without any migrations applied).
+ */
+void
+CreateOldSchema (xaya::SQLiteDatabase& db)
+{
+  db.Execute (R"(
+    CREATE TABLE `signers` (
+      `name` TEXT NOT NULL,
+      `application` TEXT NULL,
+      `address` TEXT NOT NULL
+    );
+    CREATE INDEX `signers_name` ON `signers` (`name`);
+    CREATE TABLE `addresses` (
+      `name` TEXT NOT NULL,
+      `key` TEXT NOT NULL,
+      `address` TEXT NOT NULL,
+      PRIMARY KEY (`name`, `key`)
+    );
+    INSERT INTO `signers` (`name`, `application`, `address`)
+      VALUES ("domob", NULL, "addr"), ("domob", "app", "addr");
+    INSERT INTO `addresses` (`name`, `key`, `address`)
+      VALUES ("domob", "btc", "1domob");
+  )");
+}
+
+/**
+ * Returns the query plan of the given statement as a single string.
+ */
+std::string
+GetQueryPlan (const xaya::SQLiteDatabase& db, const std::string& sql)
+{
+  auto stmt = db.PrepareRo ("EXPLAIN QUERY PLAN " + sql);
+
+  std::string res;
+  while (stmt.Step ())
+    res += stmt.Get<std::string> (3) + "\n";
+
+  return res;
+}
+
+TEST_F (SchemaTests, FreshDatabaseHasLatestVersion)
+{
+  EXPECT_GT (SCHEMA_VERSION, 0);
+  SetupDatabaseSchema (GetDb ());
+  EXPECT_EQ (GetSchemaVersion (GetDb ()), SCHEMA_VERSION);
+
+  SetupDatabaseSchema (GetDb ());
+  EXPECT_EQ (GetSchemaVersion (GetDb ()), SCHEMA_VERSION);
+
+  auto stmt = GetDb ().PrepareRo (R"(
+    SELECT COUNT(*) FROM `schema_version`
+  )");
+  ASSERT_TRUE (stmt.Step ());
+  EXPECT_EQ (stmt.Get<int64_t> (0), 1);
+}
+
+TEST_F (SchemaTests, LookupIndicesAddedToExistingDatabase)
+{
+  CreateOldSchema (GetDb ());
+  EXPECT_FALSE (HasIndex (GetDb (), "signers_address"));
+  EXPECT_FALSE (HasIndex (GetDb (), "addresses_key_address"));
+
+  SetupDatabaseSchema (GetDb ());
+  EXPECT_TRUE (HasIndex (GetDb (), "signers_address"));
+  EXPECT_TRUE (HasIndex (GetDb (), "addresses_key_address"));
+  EXPECT_TRUE (JsonEquals (LookupAddress (GetDb (), "btc", "1domob"),
+                           R"(["domob"])"));
+}
+
+TEST_F (SchemaTests, MigrationCoveringSignerIndex)
+{
+  CreateOldSchema (GetDb ());
+  EXPECT_TRUE (HasIndex (GetDb (), "signers_name"));
+
+  SetupDatabaseSchema (GetDb (), 1);
+  EXPECT_EQ (GetSchemaVersion (GetDb ()), 1);
+  EXPECT_TRUE (HasIndex (GetDb (), "signers_name_address"));
+  EXPECT_FALSE (HasIndex (GetDb (), "signers_name"));
+
+  const std::string query = R"(
+    SELECT `application`
+      FROM `signers`
+      WHERE `name` = 'domob' AND `address` = 'addr'
+  )";
+  EXPECT_NE (GetQueryPlan (GetDb (), query)
+                .find ("COVERING INDEX signers_name_address"),
+             std::string::npos)
+      << GetQueryPlan (GetDb (), query);
+
+  auto stmt = GetDb ().PrepareRo (query + " ORDER BY `application`");
+  ASSERT_TRUE (stmt.Step ());
+  EXPECT_TRUE (stmt.IsNull (0));
+  ASSERT_TRUE (stmt.Step ());
+  EXPECT_EQ (stmt.Get<std::string> (0), "app");
+  EXPECT_FALSE (stmt.Step ());
+}
+
+TEST_F (SchemaTests, MigrationDictionaries)
+{
+  CreateOldSchema (GetDb ());
+  GetDb ().Execute (R"(
+    INSERT INTO `signers` (`name`, `application`, `address`)
+      VALUES ("foo", "app", "foo"), ("foo", "", "empty");
+    INSERT INTO `addresses` (`name`, `key`, `address`)
+      VALUES ("bar", "btc", "1bar"), ("bar", "eth", "0xbar");
+  )");
+  SetupDatabaseSchema (GetDb (), 1);
+
+  SetupDatabaseSchema (GetDb (), 2);
+  EXPECT_EQ (GetSchemaVersion (GetDb ()), 2);
+  EXPECT_TRUE (JsonEquals (GetFullState (GetDb ()), R"({
+    "names":
+      {
+        "bar":
+          {
+            "name": "bar",
+            "signers": [],
+            "addresses": {"btc": "1bar", "eth": "0xbar"}
+          },
+        "domob":
+          {
+            "name": "domob",
+            "signers":
+              [
+                {"addresses": ["addr"]},
+                {"application": "app", "addresses": ["addr"]}
+              ],
+            "addresses": {"btc": "1domob"}
+          },
+        "foo":
+          {
+            "name": "foo",
+            "signers":
+              [
+                {"application": "", "addresses": ["empty"]},
+                {"application": "app", "addresses": ["foo"]}
+              ],
+            "addresses": {}
+          }
+      }
+  })"));
+
+  /* Each string is only stored once.  */
+  for (const auto& entry : std::map<std::string, int> ({
+      {"names", 3}, {"applications", 2}, {"keys", 2},
+    }))
+    {
+      auto stmt = GetDb ().PrepareRo ("SELECT COUNT(*) FROM `"
+                                        + entry.first + "`");
+      ASSERT_TRUE (stmt.Step ());
+      EXPECT_EQ (stmt.Get<int64_t> (0), entry.second) << entry.first;
+    }
+
+  /* Checking a signer only needs the indices.  */
+  const std::string query = R"(
+    SELECT `a`.`value`
+      FROM `names` AS `n`
+        INNER JOIN `signers` AS `s` ON `s`.`name_id` = `n`.`id`
+        LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`
+      WHERE `n`.`value` = 'domob' AND `s`.`address` = 'addr'
+  )";
+  EXPECT_NE (GetQueryPlan (GetDb (), query)
+                .find ("COVERING INDEX signers_name_address"),
+             std::string::npos)
+      << GetQueryPlan (GetDb (), query);
+}
+
+/**
+ * Creates a table like libxayagame's undo data with some entries.
+ */
+void
+CreateUndoData (xaya::SQLiteDatabase& db)
+{
+  db.Execute (R"(
+    CREATE TABLE `xayagame_undo` (
+      `hash` TEXT PRIMARY KEY,
+      `data` BLOB NOT NULL,
+      `height` INTEGER NOT NULL
+    );
+    INSERT INTO `xayagame_undo` (`hash`, `data`, `height`)
+      VALUES ("block 1", x'00', 1), ("block 2", x'00', 2);
+  )");
+}
+
+/**
+ * Returns the number of entries in the undo table.
+ */
+int64_t
+CountUndoData (const xaya::SQLiteDatabase& db)
+{
+  auto stmt = db.PrepareRo ("SELECT COUNT (*) FROM `xayagame_undo`");
+  CHECK (stmt.Step ());
+  return stmt.Get<int64_t> (0);
+}
+
+TEST_F (SchemaTests, MigrationDictionariesRemovesUndoData)
+{
+  CreateOldSchema (GetDb ());
+  CreateUndoData (GetDb ());
+
+  SetupDatabaseSchema (GetDb (), 1);
+  EXPECT_EQ (CountUndoData (GetDb ()), 2);
+
+  SetupDatabaseSchema (GetDb (), 2);
+  EXPECT_EQ (CountUndoData (GetDb ()), 0);
+}
+
+TEST_F (SchemaTests, MigrationBinaryAddressesRemovesUndoData)
+{
+  CreateOldSchema (GetDb ());
+  SetupDatabaseSchema (GetDb (), 2);
+
+  CreateUndoData (GetDb ());
+  EXPECT_EQ (CountUndoData (GetDb ()), 2);
+
+  SetupDatabaseSchema (GetDb (), 3);
+  EXPECT_EQ (CountUndoData (GetDb ()), 0);
+}
+
+TEST_F (SchemaTests, MigrationBinarySignerAddresses)
+{
+  CreateOldSchema (GetDb ());
+  GetDb ().Execute (R"(
+    INSERT INTO `signers` (`name`, `application`, `address`)
+      VALUES ("foo", NULL, "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"),
+             ("foo", "app", "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"),
+             ("foo", "app", "0x06aFd46bCDfD22eF94aC122aA11f241244A37ECc"),
+             ("bar", "", "cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn");
+  )");
+  SetupDatabaseSchema (GetDb (), 2);
+
+  std::ostringstream before;
+  WriteFullState (GetDb (), before);
+
+  SetupDatabaseSchema (GetDb (), 3);
+  EXPECT_EQ (GetSchemaVersion (GetDb ()), 3);
+  EXPECT_TRUE (HasIndex (GetDb (), "signers_address"));
+  EXPECT_FALSE (HasIndex (GetDb (), "signers_name_address"));
+
+  std::ostringstream after;
+  WriteFullState (GetDb (), after);
+  EXPECT_EQ (after.str (), before.str ());
+  EXPECT_TRUE (JsonEquals (
+      LookupSigner (GetDb (), "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"), R"([
+        {"name": "foo"},
+        {"name": "foo", "application": "app"}
+      ])"));
+
+  auto stmt = GetDb ().PrepareRo (R"(
+    SELECT typeof (`address`), COUNT (*), SUM (`application_id` = 0)
+      FROM `signers`
+      GROUP BY typeof (`address`)
+      ORDER BY typeof (`address`)
+  )");
+  ASSERT_TRUE (stmt.Step ());
+  EXPECT_EQ (stmt.Get<std::string> (0), "blob");
+  EXPECT_EQ (stmt.Get<int64_t> (1), 3);
+  EXPECT_EQ (stmt.Get<int64_t> (2), 1);
+  ASSERT_TRUE (stmt.Step ());
+  EXPECT_EQ (stmt.Get<std::string> (0), "text");
+  EXPECT_EQ (stmt.Get<int64_t> (1), 3);
+  EXPECT_EQ (stmt.Get<int64_t> (2), 1);
+  EXPECT_FALSE (stmt.Step ());
+
+  /* Checking a signer does not need to scan any table.  Depending on
+     its statistics, SQLite may use the primary key or the address index,
+     both of which contain all needed columns.  */
+  const std::string query = R"(
+    SELECT `a`.`value`
+      FROM `names` AS `n`
+        INNER JOIN `signers` AS `s` ON `s`.`name_id` = `n`.`id`
+        LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`
+      WHERE `n`.`value` = 'domob' AND `s`.`address` = 'addr'
+  )";
+  EXPECT_EQ (GetQueryPlan (GetDb (), query).find ("SCAN"),
+             std::string::npos)
+      << GetQueryPlan (GetDb (), query);
+}
+
+TEST_F (SchemaTests, NewerVersionFails)
+{
+  SetupDatabaseSchema (GetDb ());
+  GetDb ().Execute (R"(
+    UPDATE `schema_version` SET `version` = `version` + 1
+  )");
+  EXPECT_DEATH (SetupDatabaseSchema (GetDb ()), "is newer than supported");
+}
+
 } // anonymous namespace
 } // namespace xid
@@ -0,0 +1,136 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sessions.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+#include <glog/logging.h>
+
+namespace xid
+{
+
+namespace
+{
+
+/** Size of the MAC (HMAC-SHA256) in bytes.  */
+constexpr size_t MAC_SIZE = 32;
+
+/** Size of the token payload (expiry and generation) in bytes.  */
+constexpr size_t PAYLOAD_SIZE = 16;
+
+/**
+ * Appends a 64-bit integer in big-endian byte order to a string.
+ */
+void
+AppendUint64 (const uint64_t val, std::string& out)
+{
+  for (int i = 7; i >= 0; --i)
+    out.push_back (static_cast<char> ((val >> (8 * i)) & 0xFF));
+}
+
+/**
+ * Reads a big-endian 64-bit integer from the given position of a string.
+ */
+uint64_t
+ReadUint64 (const std::string& data, const size_t pos)
+{
+  uint64_t res = 0;
+  for (size_t i = 0; i < 8; ++i)
+    res = (res << 8) | static_cast<unsigned char> (data[pos + i]);
+  return res;
+}
+
+/**
+ * Appends a string with its length to the data, so that the concatenation
+ * of multiple strings is unambiguous.
+ */
+void
+AppendString (const std::string& str, std::string& out)
+{
+  AppendUint64 (str.size (), out);
+  out.append (str);
+}
+
+} // anonymous namespace
+
+SessionManager::SessionManager (const NameGenerations& g)
+  : generations(g)
+{
+  key.resize (KEY_SIZE);
+  CHECK_EQ (RAND_bytes (reinterpret_cast<unsigned char*> (&key[0]), KEY_SIZE),
+            1);
+}
+
+SessionManager::SessionManager (const NameGenerations& g, const std::string& k)
+  : generations(g), key(k)
+{}
+
+std::string
+SessionManager::ComputeMac (const std::string& name, const std::string& app,
+                            const std::string& data) const
+{
+  std::string msg;
+  AppendString (name, msg);
+  AppendString (app, msg);
+  msg.append (data);
+
+  unsigned char mac[MAC_SIZE];
+  unsigned macLen;
+  CHECK (HMAC (EVP_sha256 (), key.data (), key.size (),
+               reinterpret_cast<const unsigned char*> (msg.data ()),
+               msg.size (), mac, &macLen) != nullptr);
+  CHECK_EQ (macLen, MAC_SIZE);
+
+  return std::string (reinterpret_cast<const char*> (mac), MAC_SIZE);
+}
+
+std::string
+SessionManager::CreateToken (const std::string& name, const std::string& app,
+                             const uint64_t generation,
+                             const int64_t expiry) const
+{
+  std::string data;
+  AppendUint64 (static_cast<uint64_t> (expiry), data);
+  AppendUint64 (generation, data);
+  CHECK_EQ (data.size (), PAYLOAD_SIZE);
+
+  return xaya::EncodeBase64 (data + ComputeMac (name, app, data));
+}
+
+SessionManager::TokenState
+SessionManager::VerifyToken (const std::string& name, const std::string& app,
+                             const std::string& token, const int64_t now,
+                             int64_t& expiry) const
+{
+  std::string raw;
+  if (!xaya::DecodeBase64 (token, raw))
+    return TokenState::MALFORMED;
+  if (raw.size () != PAYLOAD_SIZE + MAC_SIZE)
+    return TokenState::MALFORMED;
+
+  const std::string data = raw.substr (0, PAYLOAD_SIZE);
+  const std::string expectedMac = ComputeMac (name, app, data);
+  if (CRYPTO_memcmp (expectedMac.data (), raw.data () + PAYLOAD_SIZE,
+                     MAC_SIZE) != 0)
+    return TokenState::INVALID;
+
+  expiry = static_cast<int64_t> (ReadUint64 (data, 0));
+  const uint64_t generation = ReadUint64 (data, 8);
+
+  if (generation != generations.Get (name))
+    return TokenState::OUTDATED;
+  /* Like for credentials, the expiry time itself is still valid.  */
+  if (now > expiry)
+    return TokenState::EXPIRED;
+
+  return TokenState::VALID;
+}
+
+} // namespace xid
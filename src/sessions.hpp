@@ -0,0 +1,101 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_SESSIONS_HPP
+#define XID_SESSIONS_HPP
+
+#include "namegenerations.hpp"
+
+#include <cstdint>
+#include <string>
+
+namespace xid
+{
+
+/**
+ * Manager for session tokens.  After successful verification of credentials,
+ * verifyauth can issue a short-lived token, which allows the client to
+ * re-authenticate with a single HMAC check instead of full verification.
+ *
+ * Tokens are signed with a key that is generated randomly when the manager
+ * is constructed, so they are only valid for the lifetime of the process.
+ * Each token also commits to the NameGenerations value of the name it is
+ * for, so that a signer change invalidates all tokens for the name
+ * issued before.
+ *
+ * All methods are thread-safe.
+ */
+class SessionManager
+{
+
+public:
+
+  /** Result of verifying a session token.  */
+  enum class TokenState
+  {
+    /** The token is valid.  */
+    VALID,
+    /** The token could not be decoded at all.  */
+    MALFORMED,
+    /** The MAC is wrong (e.g. the token is for another name).  */
+    INVALID,
+    /** The signers of the name may have changed since it was issued.  */
+    OUTDATED,
+    /** The token has expired.  */
+    EXPIRED,
+  };
+
+private:
+
+  /** Size of the HMAC key in bytes.  */
+  static constexpr size_t KEY_SIZE = 32;
+
+  /** The generations of names, against which tokens are checked.  */
+  const NameGenerations& generations;
+
+  /** The key used for the HMAC of tokens.  */
+  std::string key;
+
+  /**
+   * Computes the MAC for the given token data.
+   */
+  std::string ComputeMac (const std::string& name, const std::string& app,
+                          const std::string& data) const;
+
+public:
+
+  /**
+   * Constructs a manager with a random key.
+   */
+  explicit SessionManager (const NameGenerations& g);
+
+  /**
+   * Constructs a manager with a given key.  This is used in tests.
+   */
+  explicit SessionManager (const NameGenerations& g, const std::string& k);
+
+  SessionManager (const SessionManager&) = delete;
+  void operator= (const SessionManager&) = delete;
+
+  /**
+   * Creates a token for the given name and application, generation
+   * and expiry (as Unix timestamp).
+   */
+  std::string CreateToken (const std::string& name, const std::string& app,
+                           uint64_t generation, int64_t expiry) const;
+
+  /**
+   * Verifies a token for the given name and application at the given
+   * time (as Unix timestamp).  If the token could be decoded and the MAC
+   * is valid, expiry is set to its expiration time.
+   */
+  TokenState VerifyToken (const std::string& name, const std::string& app,
+                          const std::string& token, int64_t now,
+                          int64_t& expiry) const;
+
+};
+
+} // namespace xid
+
+#endif // XID_SESSIONS_HPP
@@ -0,0 +1,166 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "sessions.hpp"
+
+#include "auth/credentials.hpp"
+#include "auth/time.hpp"
+
+#include <xayautil/base64.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+using TokenState = SessionManager::TokenState;
+
+class SessionManagerTests : public testing::Test
+{
+
+protected:
+
+  NameGenerations generations;
+  SessionManager sessions;
+
+  SessionManagerTests ()
+    : sessions(generations, "test key")
+  {}
+
+  /**
+   * Verifies a token at the given time and returns the state.
+   */
+  TokenState
+  Verify (const std::string& name, const std::string& app,
+          const std::string& token, const int64_t now = 100)
+  {
+    int64_t expiry;
+    return sessions.VerifyToken (name, app, token, now, expiry);
+  }
+
+};
+
+TEST_F (SessionManagerTests, Valid)
+{
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  int64_t expiry;
+  EXPECT_EQ (sessions.VerifyToken ("domob", "app", token, 100, expiry),
+             TokenState::VALID);
+  EXPECT_EQ (expiry, 1'000);
+}
+
+TEST_F (SessionManagerTests, Malformed)
+{
+  EXPECT_EQ (Verify ("domob", "app", "invalid base64"), TokenState::MALFORMED);
+  EXPECT_EQ (Verify ("domob", "app", ""), TokenState::MALFORMED);
+  EXPECT_EQ (Verify ("domob", "app", xaya::EncodeBase64 ("too short")),
+             TokenState::MALFORMED);
+}
+
+TEST_F (SessionManagerTests, WrongNameOrApplication)
+{
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  EXPECT_EQ (Verify ("other", "app", token), TokenState::INVALID);
+  EXPECT_EQ (Verify ("domob", "other", token), TokenState::INVALID);
+
+  /* The encoding of name and application must be unambiguous.  */
+  const auto t2 = sessions.CreateToken ("ab", "c", gen, 1'000);
+  EXPECT_EQ (Verify ("a", "bc", t2), TokenState::INVALID);
+}
+
+TEST_F (SessionManagerTests, OtherKey)
+{
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  SessionManager other(generations);
+  int64_t expiry;
+  EXPECT_EQ (other.VerifyToken ("domob", "app", token, 100, expiry),
+             TokenState::INVALID);
+}
+
+TEST_F (SessionManagerTests, Tampered)
+{
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  std::string raw;
+  ASSERT_TRUE (xaya::DecodeBase64 (token, raw));
+  raw[7] ^= 1;
+  EXPECT_EQ (Verify ("domob", "app", xaya::EncodeBase64 (raw)),
+             TokenState::INVALID);
+}
+
+TEST_F (SessionManagerTests, Expired)
+{
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  EXPECT_EQ (Verify ("domob", "app", token, 999), TokenState::VALID);
+  EXPECT_EQ (Verify ("domob", "app", token, 1'000), TokenState::VALID);
+  EXPECT_EQ (Verify ("domob", "app", token, 1'001), TokenState::EXPIRED);
+}
+
+TEST_F (SessionManagerTests, ExpiryBoundaryAsCredentials)
+{
+  /* A session capped at the expiry of the credentials must be valid for
+     exactly as long as the credentials themselves.  */
+  Credentials cred("domob", "app");
+  cred.SetExpiry (TimeFromUnix (1'000));
+
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  for (const int64_t now : {999, 1'000, 1'001})
+    EXPECT_EQ (Verify ("domob", "app", token, now) == TokenState::EXPIRED,
+               cred.IsExpired (TimeFromUnix (now)))
+        << "at time " << now;
+}
+
+TEST_F (SessionManagerTests, NameChanged)
+{
+  const auto gen = generations.Get ("domob");
+  const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+  generations.Bump ("domob");
+  EXPECT_EQ (Verify ("domob", "app", token), TokenState::OUTDATED);
+
+  const auto newToken = sessions.CreateToken (
+      "domob", "app", generations.Get ("domob"), 1'000);
+  EXPECT_EQ (Verify ("domob", "app", newToken), TokenState::VALID);
+}
+
+TEST_F (SessionManagerTests, OtherNameChanged)
+{
+  /* Other names may share the bucket with our name, in which case
+     changes to them invalidate our token as well.  But there must be
+     names in other buckets, whose changes do not affect us.  */
+  for (unsigned i = 0; i < 10; ++i)
+    {
+      const auto gen = generations.Get ("domob");
+      const auto token = sessions.CreateToken ("domob", "app", gen, 1'000);
+
+      generations.Bump ("other " + std::to_string (i));
+      if (generations.Get ("domob") == gen)
+        {
+          EXPECT_EQ (Verify ("domob", "app", token), TokenState::VALID);
+          return;
+        }
+
+      EXPECT_EQ (Verify ("domob", "app", token), TokenState::OUTDATED);
+    }
+
+  FAIL () << "all other names share the bucket";
+}
+
+} // anonymous namespace
+} // namespace xid
@@ -0,0 +1,123 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "signaturecache.hpp"
+
+#include <glog/logging.h>
+
+#include <functional>
+
+namespace xid
+{
+
+namespace
+{
+
+/** After how many lookups the statistics are logged.  */
+constexpr uint64_t STATS_LOG_INTERVAL = 10'000;
+
+/**
+ * Logs the given cache statistics.
+ */
+void
+LogStats (const SignatureCache::Stats& s)
+{
+  LOG (INFO)
+      << "Signature cache: " << s.size << " entries, "
+      << s.hits << " hits, " << s.misses << " misses, "
+      << s.evictions << " evictions";
+}
+
+} // anonymous namespace
+
+size_t
+SignatureCache::KeyHash::operator() (const Key& k) const
+{
+  const std::hash<std::string> hasher;
+  const size_t h = hasher (k.msg);
+  return h ^ (hasher (k.sgn) + 0x9e3779b9 + (h << 6) + (h >> 2));
+}
+
+SignatureCache::SignatureCache (const size_t s)
+  : maxSize(s)
+{
+  index.reserve (maxSize);
+}
+
+SignatureCache::~SignatureCache ()
+{
+  LogStats (GetStats ());
+}
+
+bool
+SignatureCache::Lookup (const std::string& msg, const std::string& sgn,
+                        std::string& addr)
+{
+  std::lock_guard<std::mutex> lock(mut);
+
+  if ((stats.hits + stats.misses + 1) % STATS_LOG_INTERVAL == 0)
+    {
+      Stats s = stats;
+      s.size = entries.size ();
+      LogStats (s);
+    }
+
+  const auto mit = index.find (Key {msg, sgn});
+  if (mit == index.end ())
+    {
+      ++stats.misses;
+      return false;
+    }
+
+  ++stats.hits;
+  entries.splice (entries.begin (), entries, mit->second);
+  addr = mit->second->address;
+
+  return true;
+}
+
+void
+SignatureCache::Insert (const std::string& msg, const std::string& sgn,
+                        const std::string& addr)
+{
+  if (maxSize == 0)
+    return;
+
+  std::lock_guard<std::mutex> lock(mut);
+
+  Key key {msg, sgn};
+  const auto mit = index.find (key);
+  if (mit != index.end ())
+    {
+      /* Another thread may have inserted the same entry concurrently after
+         both missed on lookup.  The address is the same in this case.  */
+      entries.splice (entries.begin (), entries, mit->second);
+      mit->second->address = addr;
+      return;
+    }
+
+  if (entries.size () >= maxSize)
+    {
+      index.erase (entries.back ().key);
+      entries.pop_back ();
+      ++stats.evictions;
+    }
+
+  entries.push_front (Entry {std::move (key), addr});
+  index.emplace (entries.front ().key, entries.begin ());
+  CHECK_EQ (entries.size (), index.size ());
+}
+
+SignatureCache::Stats
+SignatureCache::GetStats () const
+{
+  std::lock_guard<std::mutex> lock(mut);
+
+  Stats res = stats;
+  res.size = entries.size ();
+
+  return res;
+}
+
+} // namespace xid
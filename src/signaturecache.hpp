@@ -0,0 +1,131 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_SIGNATURECACHE_HPP
+#define XID_SIGNATURECACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xid
+{
+
+/**
+ * Bounded LRU cache for the results of signature verification, i.e. the
+ * address recovered from a (message, signature) pair.  The result depends
+ * only on the message and signature, so it can be cached indefinitely.
+ * This saves repeated Xaya Core RPC calls when the same credentials are
+ * verified over and over (e.g. on reconnects).
+ *
+ * All methods are thread-safe.
+ */
+class SignatureCache
+{
+
+public:
+
+  /** Statistics about the cache usage.  */
+  struct Stats
+  {
+
+    /** Number of lookups that found an entry.  */
+    uint64_t hits = 0;
+
+    /** Number of lookups that did not find an entry.  */
+    uint64_t misses = 0;
+
+    /** Number of entries removed to make room for new ones.  */
+    uint64_t evictions = 0;
+
+    /** Current number of entries.  */
+    size_t size = 0;
+
+  };
+
+private:
+
+  /** Key of a cache entry, i.e. the message and signature.  */
+  struct Key
+  {
+
+    std::string msg;
+    std::string sgn;
+
+    friend bool
+    operator== (const Key& a, const Key& b)
+    {
+      return a.msg == b.msg && a.sgn == b.sgn;
+    }
+
+  };
+
+  /** Hasher for keys.  */
+  struct KeyHash
+  {
+    size_t operator() (const Key& k) const;
+  };
+
+  /** An entry in the LRU list.  */
+  struct Entry
+  {
+    Key key;
+    std::string address;
+  };
+
+  /** Maximum number of entries.  */
+  const size_t maxSize;
+
+  /** Lock for the cache state.  */
+  mutable std::mutex mut;
+
+  /** The entries, with the most recently used one at the front.  */
+  std::list<Entry> entries;
+
+  /** Index of the entries by key.  */
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index;
+
+  /** Usage statistics.  */
+  Stats stats;
+
+public:
+
+  /**
+   * Constructs an empty cache with the given maximum number of entries.
+   * If the size is zero, nothing is ever cached.
+   */
+  explicit SignatureCache (size_t s);
+
+  ~SignatureCache ();
+
+  SignatureCache (const SignatureCache&) = delete;
+  void operator= (const SignatureCache&) = delete;
+
+  /**
+   * Looks up the recovered address for a message and signature.  Returns
+   * true and sets addr if an entry is found.
+   */
+  bool Lookup (const std::string& msg, const std::string& sgn,
+               std::string& addr);
+
+  /**
+   * Adds the recovered address for a message and signature to the cache,
+   * evicting the least recently used entry if the cache is full.
+   */
+  void Insert (const std::string& msg, const std::string& sgn,
+               const std::string& addr);
+
+  /**
+   * Returns the current usage statistics.
+   */
+  Stats GetStats () const;
+
+};
+
+} // namespace xid
+
+#endif // XID_SIGNATURECACHE_HPP
@@ -0,0 +1,117 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "signaturecache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xid
+{
+namespace
+{
+
+TEST (SignatureCacheTests, HitAndMiss)
+{
+  SignatureCache cache(10);
+  std::string addr;
+
+  EXPECT_FALSE (cache.Lookup ("msg", "sgn", addr));
+  cache.Insert ("msg", "sgn", "addr");
+  ASSERT_TRUE (cache.Lookup ("msg", "sgn", addr));
+  EXPECT_EQ (addr, "addr");
+
+  EXPECT_FALSE (cache.Lookup ("msg", "other", addr));
+  EXPECT_FALSE (cache.Lookup ("other", "sgn", addr));
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.hits, 1);
+  EXPECT_EQ (stats.misses, 3);
+  EXPECT_EQ (stats.evictions, 0);
+  EXPECT_EQ (stats.size, 1);
+}
+
+TEST (SignatureCacheTests, KeyIsNotConcatenation)
+{
+  SignatureCache cache(10);
+  cache.Insert ("ab", "c", "first");
+
+  std::string addr;
+  EXPECT_FALSE (cache.Lookup ("a", "bc", addr));
+}
+
+TEST (SignatureCacheTests, LeastRecentlyUsedEvicted)
+{
+  SignatureCache cache(2);
+  std::string addr;
+
+  cache.Insert ("a", "sgn", "addr a");
+  cache.Insert ("b", "sgn", "addr b");
+  ASSERT_TRUE (cache.Lookup ("a", "sgn", addr));
+  cache.Insert ("c", "sgn", "addr c");
+
+  EXPECT_FALSE (cache.Lookup ("b", "sgn", addr));
+  ASSERT_TRUE (cache.Lookup ("a", "sgn", addr));
+  EXPECT_EQ (addr, "addr a");
+  ASSERT_TRUE (cache.Lookup ("c", "sgn", addr));
+  EXPECT_EQ (addr, "addr c");
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.evictions, 1);
+  EXPECT_EQ (stats.size, 2);
+}
+
+TEST (SignatureCacheTests, DuplicateInsert)
+{
+  SignatureCache cache(2);
+  cache.Insert ("a", "sgn", "addr");
+  cache.Insert ("a", "sgn", "addr");
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.evictions, 0);
+  EXPECT_EQ (stats.size, 1);
+}
+
+TEST (SignatureCacheTests, Disabled)
+{
+  SignatureCache cache(0);
+  cache.Insert ("msg", "sgn", "addr");
+
+  std::string addr;
+  EXPECT_FALSE (cache.Lookup ("msg", "sgn", addr));
+  EXPECT_EQ (cache.GetStats ().size, 0);
+}
+
+TEST (SignatureCacheTests, Concurrent)
+{
+  SignatureCache cache(50);
+
+  std::vector<std::thread> threads;
+  for (unsigned t = 0; t < 4; ++t)
+    threads.emplace_back ([&cache] ()
+      {
+        for (unsigned i = 0; i < 1'000; ++i)
+          {
+            const std::string msg = std::to_string (i % 100);
+            std::string addr;
+            if (cache.Lookup (msg, "sgn", addr))
+              EXPECT_EQ (addr, "addr " + msg);
+            else
+              cache.Insert (msg, "sgn", "addr " + msg);
+          }
+      });
+
+  for (auto& t : threads)
+    t.join ();
+
+  const auto stats = cache.GetStats ();
+  EXPECT_EQ (stats.hits + stats.misses, 4 * 1'000);
+  EXPECT_LE (stats.size, 50);
+}
+
+} // anonymous namespace
+} // namespace xid
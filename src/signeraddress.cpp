@@ -0,0 +1,56 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "signeraddress.hpp"
+
+#include "base58.hpp"
+
+namespace xid
+{
+
+namespace
+{
+
+/** Size of decoded addresses (version byte and hash).  */
+constexpr size_t RAW_ADDRESS_SIZE = 21;
+
+/**
+ * Maximum length of the base58 encoding of such addresses (including the
+ * checksum).  Longer strings are not even tried to be decoded.
+ */
+constexpr size_t MAX_ENCODED_SIZE = 35;
+
+} // anonymous namespace
+
+bool
+EncodeSignerAddress (const std::string& addr, std::string& raw)
+{
+  /* Base58 encoding is bijective, so decoded addresses are converted back
+     to exactly the original string.  */
+  return addr.size () <= MAX_ENCODED_SIZE
+            && DecodeBase58Check (addr, raw)
+            && raw.size () == RAW_ADDRESS_SIZE;
+}
+
+void
+BindSignerAddress (xaya::SQLiteDatabase::Statement& stmt, const int ind,
+                   const std::string& addr)
+{
+  std::string raw;
+  if (EncodeSignerAddress (addr, raw))
+    stmt.BindBlob (ind, raw);
+  else
+    stmt.Bind (ind, addr);
+}
+
+std::string
+GetSignerAddress (const xaya::SQLiteDatabase::Statement& stmt, const int ind)
+{
+  if (!stmt.Get<bool> (ind + 1))
+    return stmt.Get<std::string> (ind);
+
+  return EncodeBase58Check (stmt.GetBlob<std::string> (ind));
+}
+
+} // namespace xid
@@ -0,0 +1,42 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_SIGNERADDRESS_HPP
+#define XID_SIGNERADDRESS_HPP
+
+#include <xayagame/sqlitestorage.hpp>
+
+#include <string>
+
+namespace xid
+{
+
+/**
+ * Converts a signer address to the form in which it is stored in the
+ * signers table.  Base58 addresses (with a version byte and 20-byte hash,
+ * i.e. P2PKH and P2SH addresses) are stored as the decoded 21 bytes.
+ * In that case, the raw data is returned in the output and the function
+ * returns true.  Any other string (e.g. an EVM address) does not decode,
+ * and is stored as TEXT as it is.
+ */
+bool EncodeSignerAddress (const std::string& addr, std::string& raw);
+
+/**
+ * Binds a signer address in its stored form (BLOB or TEXT) to a statement
+ * parameter.
+ */
+void BindSignerAddress (xaya::SQLiteDatabase::Statement& stmt, int ind,
+                        const std::string& addr);
+
+/**
+ * Returns a signer address as string from a statement result.  The column
+ * at the given index must be the stored address, and the next column
+ * whether it is binary (i.e. typeof (address) = 'blob').
+ */
+std::string GetSignerAddress (const xaya::SQLiteDatabase::Statement& stmt,
+                              int ind);
+
+} // namespace xid
+
+#endif // XID_SIGNERADDRESS_HPP
@@ -0,0 +1,110 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "signeraddress.hpp"
+
+#include "dbtest.hpp"
+
+#include <gtest/gtest.h>
+
+#include <glog/logging.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+TEST (SignerAddressTests, Encode)
+{
+  std::string raw;
+  ASSERT_TRUE (EncodeSignerAddress ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C",
+                                    raw));
+  EXPECT_EQ (raw.size (), 21);
+  EXPECT_EQ (raw[0], 28);
+  ASSERT_TRUE (EncodeSignerAddress ("cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn",
+                                    raw));
+  EXPECT_EQ (raw[0], 88);
+
+  for (const std::string addr : {
+      "", "domob", "global 1",
+      "0x06aFd46bCDfD22eF94aC122aA11f241244A37ECc",
+      "chi1qxvzq8qdfv5hma9d46x2hwdq6v7v03fqcv2q0nu",
+      "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5D",
+      /* Valid base58 with checksum, but not an address.  */
+      "11WARUd14",
+    })
+    EXPECT_FALSE (EncodeSignerAddress (addr, raw)) << addr;
+}
+
+class SignerAddressDbTests : public DBTest
+{
+
+protected:
+
+  SignerAddressDbTests ()
+  {
+    GetDb ().Execute (R"(
+      CREATE TABLE `test` (`address` BLOB NOT NULL PRIMARY KEY)
+    )");
+  }
+
+  /**
+   * Inserts an address into the test table.
+   */
+  void
+  Insert (const std::string& addr)
+  {
+    auto stmt = GetDb ().Prepare (R"(
+      INSERT INTO `test` (`address`) VALUES (?1)
+    )");
+    BindSignerAddress (stmt, 1, addr);
+    stmt.Execute ();
+  }
+
+  /**
+   * Looks up the given address in the test table, and returns its type
+   * as stored (or the empty string if it is not found).
+   */
+  std::string
+  Lookup (const std::string& addr)
+  {
+    auto stmt = GetDb ().Prepare (R"(
+      SELECT `address`, typeof (`address`) = 'blob', typeof (`address`)
+        FROM `test`
+        WHERE `address` = ?1
+    )");
+    BindSignerAddress (stmt, 1, addr);
+
+    if (!stmt.Step ())
+      return "";
+
+    EXPECT_EQ (GetSignerAddress (stmt, 0), addr);
+    const auto res = stmt.Get<std::string> (2);
+    CHECK (!stmt.Step ());
+
+    return res;
+  }
+
+};
+
+TEST_F (SignerAddressDbTests, RoundTrip)
+{
+  Insert ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C");
+  Insert ("cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn");
+  Insert ("0x06aFd46bCDfD22eF94aC122aA11f241244A37ECc");
+  Insert ("domob");
+
+  EXPECT_EQ (Lookup ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C"), "blob");
+  EXPECT_EQ (Lookup ("cRMSLaFUmKypuaQC2VtnxA7NLPK1s4uUFn"), "blob");
+  EXPECT_EQ (Lookup ("0x06aFd46bCDfD22eF94aC122aA11f241244A37ECc"), "text");
+  EXPECT_EQ (Lookup ("domob"), "text");
+
+  EXPECT_EQ (Lookup ("0x06afd46bcdfd22ef94ac122aa11f241244a37ecc"), "");
+  EXPECT_EQ (Lookup ("CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5D"), "");
+}
+
+} // anonymous namespace
+} // namespace xid
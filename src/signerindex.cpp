@@ -0,0 +1,190 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "signerindex.hpp"
+
+#include "signeraddress.hpp"
+
+#include <glog/logging.h>
+
+#include <functional>
+
+namespace xid
+{
+
+namespace
+{
+
+/**
+ * Start of the query for (name, application, address) of signers, with
+ * the address in the form expected by GetSignerAddress.
+ */
+const std::string SELECT_SIGNERS = R"(
+    SELECT `n`.`value`, `a`.`value`,
+           `s`.`address`, typeof (`s`.`address`) = 'blob'
+      FROM `names` AS `n`
+        INNER JOIN `signers` AS `s` ON `s`.`name_id` = `n`.`id`
+        LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`
+)";
+
+} // anonymous namespace
+
+constexpr size_t SignerIndex::NUM_SHARDS;
+
+size_t
+SignerIndex::GetShard (const std::string& name)
+{
+  return std::hash<std::string> () (name) % NUM_SHARDS;
+}
+
+void
+SignerIndex::AddSigner (const xaya::SQLiteDatabase::Statement& stmt,
+                        NameSigners& signers)
+{
+  const std::string addr = GetSignerAddress (stmt, 2);
+  if (stmt.IsNull (1))
+    signers.global.insert (addr);
+  else
+    signers.apps[stmt.Get<std::string> (1)].insert (addr);
+}
+
+bool
+SignerIndex::Snapshot::IsValidSigner (const std::string& name,
+                                      const std::string& app,
+                                      const std::string& addr) const
+{
+  const Shard& shard = *shards[GetShard (name)];
+  const auto mit = shard.find (name);
+  if (mit == shard.end ())
+    return false;
+
+  const NameSigners& signers = *mit->second;
+  if (signers.global.count (addr) > 0)
+    return true;
+
+  const auto ait = signers.apps.find (app);
+  return ait != signers.apps.end () && ait->second.count (addr) > 0;
+}
+
+std::shared_ptr<SignerIndex::Snapshot>
+SignerIndex::Build (const xaya::SQLiteDatabase& db)
+{
+  std::vector<Shard> shards(NUM_SHARDS);
+  std::unordered_map<std::string, std::shared_ptr<NameSigners>> names;
+
+  auto stmt = db.PrepareRo (SELECT_SIGNERS);
+  while (stmt.Step ())
+    {
+      auto& entry = names[stmt.Get<std::string> (0)];
+      if (entry == nullptr)
+        entry = std::make_shared<NameSigners> ();
+      AddSigner (stmt, *entry);
+    }
+
+  for (auto& entry : names)
+    {
+      Shard& shard = shards[GetShard (entry.first)];
+      shard.emplace (entry.first, std::move (entry.second));
+    }
+
+  auto res = std::make_shared<Snapshot> ();
+  res->shards.reserve (NUM_SHARDS);
+  for (auto& shard : shards)
+    res->shards.push_back (std::make_shared<const Shard> (std::move (shard)));
+
+  LOG (INFO) << "Built signer index with " << names.size () << " names";
+  return res;
+}
+
+std::shared_ptr<const SignerIndex::Snapshot>
+SignerIndex::GetSnapshot () const
+{
+  return std::atomic_load (&current);
+}
+
+void
+SignerIndex::Rebuild (const xaya::SQLiteDatabase& db)
+{
+  std::shared_ptr<const Snapshot> published = Build (db);
+  std::atomic_store (&current, std::move (published));
+}
+
+void
+SignerIndex::Update (const xaya::SQLiteDatabase& db,
+                     const std::set<std::string>& names,
+                     const std::string& blockHash, const uint64_t height,
+                     const std::string& state)
+{
+  const auto old = std::atomic_load (&current);
+
+  std::shared_ptr<Snapshot> next;
+  if (old == nullptr)
+    next = Build (db);
+  else
+    {
+      next = std::make_shared<Snapshot> (*old);
+
+      /* Shards that have been copied already for this update, and can
+         thus be modified in place.  */
+      std::unordered_map<size_t, std::shared_ptr<Shard>> copied;
+
+      auto stmt = db.PrepareRo (SELECT_SIGNERS + R"(
+        WHERE `n`.`value` = ?1
+      )");
+
+      for (const auto& name : names)
+        {
+          const size_t ind = GetShard (name);
+          auto& shard = copied[ind];
+          if (shard == nullptr)
+            {
+              shard = std::make_shared<Shard> (*next->shards[ind]);
+              next->shards[ind] = shard;
+            }
+
+          auto entry = std::make_shared<NameSigners> ();
+          bool found = false;
+
+          stmt.Reset ();
+          stmt.Bind (1, name);
+          while (stmt.Step ())
+            {
+              found = true;
+              AddSigner (stmt, *entry);
+            }
+
+          if (found)
+            (*shard)[name] = std::move (entry);
+          else
+            shard->erase (name);
+        }
+    }
+
+  next->blockHash = blockHash;
+  next->height = height;
+  next->state = state;
+
+  std::shared_ptr<const Snapshot> published = std::move (next);
+  std::atomic_store (&current, std::move (published));
+}
+
+bool
+SignerIndex::UpdateBlock (const std::shared_ptr<const Snapshot>& expected,
+                          const std::string& blockHash, const uint64_t height,
+                          const std::string& state)
+{
+  CHECK (expected != nullptr);
+
+  /* The shards are shared with the expected snapshot, so this is cheap.  */
+  auto next = std::make_shared<Snapshot> (*expected);
+  next->blockHash = blockHash;
+  next->height = height;
+  next->state = state;
+
+  std::shared_ptr<const Snapshot> exp = expected;
+  std::shared_ptr<const Snapshot> published = std::move (next);
+  return std::atomic_compare_exchange_strong (&current, &exp, published);
+}
+
+} // namespace xid
@@ -0,0 +1,203 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_SIGNERINDEX_HPP
+#define XID_SIGNERINDEX_HPP
+
+#include <xayagame/sqlitestorage.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace xid
+{
+
+/**
+ * In-memory copy of the signers table, mapping names to their global
+ * signers and to the signers for each application.  It allows checking
+ * signers for verifyauth without a database snapshot.  The database
+ * remains the source of truth; the index is built from it when the
+ * database is opened, and the signers of names touched by a block are
+ * reloaded from it after the block is processed or undone.
+ *
+ * Readers get an immutable Snapshot, which is replaced as a whole on
+ * updates (read-copy-update).  Each snapshot also carries the block and
+ * sync state it corresponds to, so that they are published atomically
+ * together with the signers.  Lookups thus only atomically load a pointer
+ * and never wait for block processing.  To keep updates cheap, names are
+ * distributed over a fixed number of shards, and an update only copies
+ * the shards containing names whose signers changed.
+ *
+ * GetSnapshot and UpdateBlock are thread-safe.  Rebuild and Update must
+ * only be called from the block-processing thread.
+ */
+class SignerIndex
+{
+
+private:
+
+  /** Number of shards into which names are distributed.  */
+  static constexpr size_t NUM_SHARDS = 1 << 10;
+
+  /** The signers of a single name.  */
+  struct NameSigners
+  {
+
+    /** Addresses of global signers.  */
+    std::unordered_set<std::string> global;
+
+    /** Addresses of signers for each application.  */
+    std::unordered_map<std::string, std::unordered_set<std::string>> apps;
+
+  };
+
+  /** Names in a shard with their signers.  */
+  using Shard
+      = std::unordered_map<std::string, std::shared_ptr<const NameSigners>>;
+
+public:
+
+  /**
+   * The state of the index after some block.
+   */
+  class Snapshot
+  {
+
+  private:
+
+    /** The shards with the names.  */
+    std::vector<std::shared_ptr<const Shard>> shards;
+
+    /**
+     * The block hash this corresponds to.  It is empty if the snapshot
+     * was built from the database as it was opened, and the block is not
+     * known yet.
+     */
+    std::string blockHash;
+
+    /** The block height this corresponds to.  */
+    uint64_t height = 0;
+
+    /**
+     * The sync state of the game (as string like in the game-state JSON)
+     * when this snapshot was published, or empty if unknown.
+     */
+    std::string state;
+
+    friend class SignerIndex;
+
+  public:
+
+    Snapshot () = default;
+
+    Snapshot (const Snapshot&) = default;
+    void operator= (const Snapshot&) = delete;
+
+    /**
+     * Returns true if the given address is authorised to sign for the
+     * given name and application (either as global signer or one for
+     * that application).
+     */
+    bool IsValidSigner (const std::string& name, const std::string& app,
+                        const std::string& addr) const;
+
+    const std::string&
+    GetBlockHash () const
+    {
+      return blockHash;
+    }
+
+    uint64_t
+    GetHeight () const
+    {
+      return height;
+    }
+
+    const std::string&
+    GetState () const
+    {
+      return state;
+    }
+
+  };
+
+private:
+
+  /**
+   * The current snapshot, or null if the index is not built.  It is
+   * accessed with the atomic functions for shared_ptr.
+   */
+  std::shared_ptr<const Snapshot> current;
+
+  /**
+   * Returns the shard index for a name.
+   */
+  static size_t GetShard (const std::string& name);
+
+  /**
+   * Adds the signer from a row of the SELECT_SIGNERS query to the signers
+   * of a name.
+   */
+  static void AddSigner (const xaya::SQLiteDatabase::Statement& stmt,
+                         NameSigners& signers);
+
+  /**
+   * Builds a new snapshot from all signers in the database.
+   */
+  static std::shared_ptr<Snapshot> Build (const xaya::SQLiteDatabase& db);
+
+public:
+
+  SignerIndex () = default;
+
+  SignerIndex (const SignerIndex&) = delete;
+  void operator= (const SignerIndex&) = delete;
+
+  /**
+   * Returns the current snapshot, or null if the index is not available
+   * at the moment.
+   */
+  std::shared_ptr<const Snapshot> GetSnapshot () const;
+
+  /**
+   * Builds the index from all signers in the database, replacing any
+   * existing snapshot.  This is done when the database is opened, and
+   * the resulting snapshot has no block hash or state.
+   */
+  void Rebuild (const xaya::SQLiteDatabase& db);
+
+  /**
+   * Updates the index after a block has been processed or undone, which
+   * led to the given database state at the given block.  The signers of
+   * the given names are reloaded from the database.  If the index is not
+   * built yet, it is built from all signers instead.
+   */
+  void Update (const xaya::SQLiteDatabase& db,
+               const std::set<std::string>& names,
+               const std::string& blockHash, uint64_t height,
+               const std::string& state);
+
+  /**
+   * Publishes a new block hash, height and state for the signers of the
+   * given snapshot, if that is still the current one.  This is used to
+   * fill in information that is only known outside of block processing
+   * (e.g. when the game becomes up-to-date).  The caller must make sure
+   * the data matches the signers in the snapshot.  Returns true if the
+   * snapshot was replaced.
+   */
+  bool UpdateBlock (const std::shared_ptr<const Snapshot>& expected,
+                    const std::string& blockHash, uint64_t height,
+                    const std::string& state);
+
+};
+
+} // namespace xid
+
+#endif // XID_SIGNERINDEX_HPP
@@ -0,0 +1,227 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "signerindex.hpp"
+
+#include "dbtest.hpp"
+#include "signeraddress.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace xid
+{
+namespace
+{
+
+class SignerIndexTests : public DBTestWithSchema
+{
+
+protected:
+
+  SignerIndex index;
+
+  /**
+   * Adds a signer for the given name and application (or a global one
+   * if the application is empty).
+   */
+  void
+  AddSigner (const std::string& name, const std::string& app,
+             const std::string& addr)
+  {
+    auto stmt = GetDb ().Prepare (R"(
+      INSERT INTO `test_signers` (`name`, `application`, `address`)
+        VALUES (?1, ?2, ?3)
+    )");
+    stmt.Bind (1, name);
+    if (app.empty ())
+      stmt.BindNull (2);
+    else
+      stmt.Bind (2, app);
+    stmt.Bind (3, addr);
+    stmt.Execute ();
+  }
+
+  /**
+   * Removes all signers of the given name.
+   */
+  void
+  ClearSigners (const std::string& name)
+  {
+    auto stmt = GetDb ().Prepare (R"(
+      DELETE FROM `signers`
+        WHERE `name_id` = (SELECT `id` FROM `names` WHERE `value` = ?1)
+    )");
+    stmt.Bind (1, name);
+    stmt.Execute ();
+  }
+
+};
+
+TEST_F (SignerIndexTests, NotBuilt)
+{
+  EXPECT_EQ (index.GetSnapshot (), nullptr);
+}
+
+TEST_F (SignerIndexTests, Build)
+{
+  AddSigner ("domob", "", "global");
+  AddSigner ("domob", "app", "app 1");
+  AddSigner ("domob", "app", "app 2");
+  AddSigner ("domob", "other", "other");
+  AddSigner ("andy", "app", "andy");
+
+  index.Update (GetDb (), {}, "block", 42, "up-to-date");
+  const auto snapshot = index.GetSnapshot ();
+  ASSERT_NE (snapshot, nullptr);
+  EXPECT_EQ (snapshot->GetBlockHash (), "block");
+  EXPECT_EQ (snapshot->GetHeight (), 42);
+  EXPECT_EQ (snapshot->GetState (), "up-to-date");
+
+  EXPECT_TRUE (snapshot->IsValidSigner ("domob", "app", "global"));
+  EXPECT_TRUE (snapshot->IsValidSigner ("domob", "foo", "global"));
+  EXPECT_TRUE (snapshot->IsValidSigner ("domob", "app", "app 1"));
+  EXPECT_TRUE (snapshot->IsValidSigner ("domob", "app", "app 2"));
+  EXPECT_TRUE (snapshot->IsValidSigner ("domob", "other", "other"));
+  EXPECT_TRUE (snapshot->IsValidSigner ("andy", "app", "andy"));
+
+  EXPECT_FALSE (snapshot->IsValidSigner ("domob", "other", "app 1"));
+  EXPECT_FALSE (snapshot->IsValidSigner ("domob", "", "app 1"));
+  EXPECT_FALSE (snapshot->IsValidSigner ("domob", "app", "andy"));
+  EXPECT_FALSE (snapshot->IsValidSigner ("andy", "app", "global"));
+  EXPECT_FALSE (snapshot->IsValidSigner ("andy", "other", "andy"));
+  EXPECT_FALSE (snapshot->IsValidSigner ("foo", "app", "global"));
+}
+
+TEST_F (SignerIndexTests, BinaryAddresses)
+{
+  const std::string addr = "CH5FG4NCAWBFqa2zZKufrdnAa7rRE1gH5C";
+
+  AddSigner ("domob", "", "dummy");
+  auto stmt = GetDb ().Prepare (R"(
+    UPDATE `signers` SET `address` = ?1
+  )");
+  BindSignerAddress (stmt, 1, addr);
+  stmt.Execute ();
+
+  index.Update (GetDb (), {}, "block", 1, "up-to-date");
+  const auto snapshot = index.GetSnapshot ();
+  ASSERT_NE (snapshot, nullptr);
+  EXPECT_TRUE (snapshot->IsValidSigner ("domob", "app", addr));
+  EXPECT_FALSE (snapshot->IsValidSigner ("domob", "app", "dummy"));
+}
+
+TEST_F (SignerIndexTests, IncrementalUpdate)
+{
+  AddSigner ("domob", "", "old");
+  AddSigner ("andy", "", "andy");
+  AddSigner ("removed", "", "removed");
+  index.Update (GetDb (), {}, "first", 1, "up-to-date");
+  const auto first = index.GetSnapshot ();
+
+  ClearSigners ("domob");
+  AddSigner ("domob", "app", "new");
+  ClearSigners ("removed");
+  AddSigner ("added", "", "added");
+
+  /* Changes to names that are not passed to the update are ignored,
+     since the index trusts the caller about what may have changed.  */
+  ClearSigners ("andy");
+
+  index.Update (GetDb (), {"domob", "removed", "added"}, "second", 2,
+                "catching-up");
+  const auto second = index.GetSnapshot ();
+  ASSERT_NE (second, nullptr);
+  EXPECT_EQ (second->GetBlockHash (), "second");
+  EXPECT_EQ (second->GetHeight (), 2);
+  EXPECT_EQ (second->GetState (), "catching-up");
+
+  EXPECT_FALSE (second->IsValidSigner ("domob", "app", "old"));
+  EXPECT_TRUE (second->IsValidSigner ("domob", "app", "new"));
+  EXPECT_FALSE (second->IsValidSigner ("removed", "app", "removed"));
+  EXPECT_TRUE (second->IsValidSigner ("added", "app", "added"));
+  EXPECT_TRUE (second->IsValidSigner ("andy", "app", "andy"));
+
+  /* The previous snapshot is not affected.  */
+  EXPECT_EQ (first->GetBlockHash (), "first");
+  EXPECT_TRUE (first->IsValidSigner ("domob", "app", "old"));
+  EXPECT_FALSE (first->IsValidSigner ("domob", "app", "new"));
+  EXPECT_TRUE (first->IsValidSigner ("removed", "app", "removed"));
+  EXPECT_FALSE (first->IsValidSigner ("added", "app", "added"));
+}
+
+TEST_F (SignerIndexTests, Rebuild)
+{
+  AddSigner ("domob", "", "old");
+  index.Rebuild (GetDb ());
+  const auto first = index.GetSnapshot ();
+  ASSERT_NE (first, nullptr);
+  EXPECT_EQ (first->GetBlockHash (), "");
+  EXPECT_EQ (first->GetState (), "");
+  EXPECT_TRUE (first->IsValidSigner ("domob", "app", "old"));
+
+  ClearSigners ("domob");
+  AddSigner ("domob", "", "new");
+  index.Update (GetDb (), {"domob"}, "block", 1, "up-to-date");
+  EXPECT_EQ (index.GetSnapshot ()->GetBlockHash (), "block");
+
+  /* Rebuilding replaces the snapshot even if there is one already.  */
+  ClearSigners ("domob");
+  index.Rebuild (GetDb ());
+  const auto second = index.GetSnapshot ();
+  ASSERT_NE (second, nullptr);
+  EXPECT_EQ (second->GetBlockHash (), "");
+  EXPECT_FALSE (second->IsValidSigner ("domob", "app", "new"));
+}
+
+TEST_F (SignerIndexTests, UndoReloadsNames)
+{
+  AddSigner ("domob", "", "old");
+  index.Update (GetDb (), {}, "first", 1, "up-to-date");
+
+  ClearSigners ("domob");
+  AddSigner ("domob", "", "new");
+  index.Update (GetDb (), {"domob"}, "second", 2, "up-to-date");
+
+  /* Undoing the second block reloads the names touched by it, which
+     restores their signers from the database.  */
+  ClearSigners ("domob");
+  AddSigner ("domob", "", "old");
+  index.Update (GetDb (), {"domob"}, "first", 1, "up-to-date");
+  const auto undone = index.GetSnapshot ();
+  ASSERT_NE (undone, nullptr);
+  EXPECT_EQ (undone->GetBlockHash (), "first");
+  EXPECT_EQ (undone->GetHeight (), 1);
+  EXPECT_TRUE (undone->IsValidSigner ("domob", "app", "old"));
+  EXPECT_FALSE (undone->IsValidSigner ("domob", "app", "new"));
+}
+
+TEST_F (SignerIndexTests, UpdateBlock)
+{
+  AddSigner ("domob", "", "addr");
+  index.Rebuild (GetDb ());
+  const auto built = index.GetSnapshot ();
+  ASSERT_NE (built, nullptr);
+
+  ASSERT_TRUE (index.UpdateBlock (built, "block", 10, "up-to-date"));
+  const auto updated = index.GetSnapshot ();
+  ASSERT_NE (updated, built);
+  EXPECT_EQ (updated->GetBlockHash (), "block");
+  EXPECT_EQ (updated->GetHeight (), 10);
+  EXPECT_EQ (updated->GetState (), "up-to-date");
+  EXPECT_TRUE (updated->IsValidSigner ("domob", "app", "addr"));
+
+  /* The snapshot has been replaced, so another update based on the old
+     one is rejected.  */
+  EXPECT_FALSE (index.UpdateBlock (built, "other", 11, "catching-up"));
+  EXPECT_EQ (index.GetSnapshot (), updated);
+
+  index.Update (GetDb (), {}, "next", 11, "up-to-date");
+  EXPECT_FALSE (index.UpdateBlock (updated, "block", 10, "disconnected"));
+  EXPECT_EQ (index.GetSnapshot ()->GetBlockHash (), "next");
+}
+
+} // anonymous namespace
+} // namespace xid
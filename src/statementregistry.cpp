@@ -0,0 +1,41 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "statementregistry.hpp"
+
+#include <glog/logging.h>
+
+namespace xid
+{
+
+xaya::SQLiteDatabase::Statement&
+StatementRegistry::Get (xaya::SQLiteDatabase& d, const std::string& sql)
+{
+  if (db == nullptr)
+    db = &d;
+  else
+    CHECK (db == &d)
+        << "StatementRegistry used with another connection without Clear";
+
+  auto mit = statements.find (sql);
+  if (mit == statements.end ())
+    {
+      VLOG (2) << "Preparing new statement:\n" << sql;
+      ++numPrepared;
+      mit = statements.emplace (sql, db->Prepare (sql)).first;
+      return mit->second;
+    }
+
+  mit->second.Reset ();
+  return mit->second;
+}
+
+void
+StatementRegistry::Clear ()
+{
+  statements.clear ();
+  db = nullptr;
+}
+
+} // namespace xid
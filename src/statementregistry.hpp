@@ -0,0 +1,84 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_STATEMENTREGISTRY_HPP
+#define XID_STATEMENTREGISTRY_HPP
+
+#include <xayagame/sqlitestorage.hpp>
+
+#include <map>
+#include <string>
+
+namespace xid
+{
+
+/**
+ * Registry of prepared SQL statements for one database connection.  It is
+ * used for statements that are executed over and over during block
+ * processing (e.g. the updates done by MoveProcessor), so that each of them
+ * is prepared only once instead of for each move.
+ *
+ * The registry keeps track of how many statements it has prepared in total,
+ * which allows tests to verify that this number does not depend on how
+ * many moves have been processed.
+ */
+class StatementRegistry
+{
+
+private:
+
+  /**
+   * The database connection for which the statements in the registry
+   * have been prepared.  This is null if there are no statements yet.
+   * It is only used to catch misuse, not to detect a new connection (which
+   * may well be allocated at the same address as a closed one).
+   */
+  xaya::SQLiteDatabase* db = nullptr;
+
+  /** The prepared statements, keyed by their SQL string.  */
+  std::map<std::string, xaya::SQLiteDatabase::Statement> statements;
+
+  /** Total number of statements that have been prepared.  */
+  unsigned numPrepared = 0;
+
+public:
+
+  StatementRegistry () = default;
+
+  StatementRegistry (const StatementRegistry&) = delete;
+  void operator= (const StatementRegistry&) = delete;
+
+  /**
+   * Returns the statement with the given SQL for the given database
+   * connection.  If it has been prepared already, the existing statement
+   * is reset and returned.  Bindings from previous uses are kept, so the
+   * caller should bind all parameters again.
+   *
+   * All calls between two Clear's must use the same connection.  When the
+   * connection is closed or replaced, the registry must be cleared.
+   */
+  xaya::SQLiteDatabase::Statement& Get (xaya::SQLiteDatabase& d,
+                                        const std::string& sql);
+
+  /**
+   * Releases all prepared statements, after which the registry can be
+   * used with a new database connection.
+   */
+  void Clear ();
+
+  /**
+   * Returns the total number of statements that have been prepared
+   * through this registry.
+   */
+  unsigned
+  GetNumPrepared () const
+  {
+    return numPrepared;
+  }
+
+};
+
+} // namespace xid
+
+#endif // XID_STATEMENTREGISTRY_HPP
@@ -1,4 +1,4 @@
-// Copyright (C) 2019 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -25,4 +25,13 @@ JsonEquals (const Json::Value& actual, const std::string& expected)
   return false;
 }
 
+Json::Value
+ParseJson (const std::string& str)
+{
+  std::istringstream in(str);
+  Json::Value res;
+  in >> res;
+  return res;
+}
+
 } // namespace xid
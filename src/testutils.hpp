@@ -1,4 +1,4 @@
-// Copyright (C) 2019 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -18,6 +18,11 @@ namespace xid
  */
 bool JsonEquals (const Json::Value& actual, const std::string& expected);
 
+/**
+ * Parses a JSON value from the given string.
+ */
+Json::Value ParseJson (const std::string& str);
+
 } // namespace xid
 
 #endif // XID_TESTUTILS_HPP
@@ -0,0 +1,110 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "workerpool.hpp"
+
+#include <glog/logging.h>
+
+#include <exception>
+
+namespace xid
+{
+
+WorkerPool::WorkerPool (const unsigned n)
+{
+  LOG (INFO) << "Starting worker pool with " << n << " threads";
+  for (unsigned i = 0; i < n; ++i)
+    threads.emplace_back ([this] () { RunWorker (); });
+}
+
+WorkerPool::~WorkerPool ()
+{
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    stopping = true;
+    cvWork.notify_all ();
+  }
+
+  for (auto& t : threads)
+    t.join ();
+
+  CHECK (queue.empty ());
+}
+
+void
+WorkerPool::RunWorker ()
+{
+  while (true)
+    {
+      std::function<void ()> work;
+
+      {
+        std::unique_lock<std::mutex> lock(mut);
+        while (queue.empty () && !stopping)
+          cvWork.wait (lock);
+
+        if (queue.empty ())
+          return;
+
+        work = std::move (queue.front ());
+        queue.pop_front ();
+      }
+
+      work ();
+    }
+}
+
+void
+WorkerPool::ParallelFor (const size_t n,
+                         const std::function<void (size_t)>& fcn)
+{
+  if (threads.empty () || n <= 1)
+    {
+      for (size_t i = 0; i < n; ++i)
+        fcn (i);
+      return;
+    }
+
+  /* State shared between all work items of this call.  It lives on our
+     stack, which is fine since we wait for all items to be done before
+     returning.  */
+  std::mutex mutBatch;
+  std::condition_variable cvDone;
+  size_t remaining = n;
+  std::exception_ptr error;
+
+  {
+    std::lock_guard<std::mutex> lock(mut);
+    for (size_t i = 0; i < n; ++i)
+      queue.push_back ([&, i] ()
+        {
+          std::exception_ptr cur;
+          try
+            {
+              fcn (i);
+            }
+          catch (...)
+            {
+              cur = std::current_exception ();
+            }
+
+          std::lock_guard<std::mutex> lock(mutBatch);
+          if (cur != nullptr && error == nullptr)
+            error = cur;
+          --remaining;
+          if (remaining == 0)
+            cvDone.notify_all ();
+        });
+    cvWork.notify_all ();
+  }
+
+  std::unique_lock<std::mutex> lock(mutBatch);
+  while (remaining > 0)
+    cvDone.wait (lock);
+
+  if (error != nullptr)
+    std::rethrow_exception (error);
+}
+
+} // namespace xid
@@ -0,0 +1,84 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef XID_WORKERPOOL_HPP
+#define XID_WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xid
+{
+
+/**
+ * A simple pool of worker threads, which can be used to run independent
+ * pieces of work (e.g. decoding moves or verifying signatures) in parallel.
+ */
+class WorkerPool
+{
+
+private:
+
+  /** The worker threads.  */
+  std::vector<std::thread> threads;
+
+  /** Mutex protecting the queue of work.  */
+  std::mutex mut;
+
+  /** Condition variable notified when new work is queued or on shutdown.  */
+  std::condition_variable cvWork;
+
+  /** Work items that are queued but not yet taken up by a worker.  */
+  std::deque<std::function<void ()>> queue;
+
+  /** Set to true when the pool is being shut down.  */
+  bool stopping = false;
+
+  /**
+   * The main function of each worker thread.
+   */
+  void RunWorker ();
+
+public:
+
+  /**
+   * Constructs the pool with the given number of worker threads.  If that
+   * is zero, all work is simply done on the calling thread.
+   */
+  explicit WorkerPool (unsigned n);
+
+  ~WorkerPool ();
+
+  WorkerPool () = delete;
+  WorkerPool (const WorkerPool&) = delete;
+  void operator= (const WorkerPool&) = delete;
+
+  /**
+   * Returns the number of worker threads in the pool.
+   */
+  unsigned
+  GetNumThreads () const
+  {
+    return threads.size ();
+  }
+
+  /**
+   * Runs fcn(i) for each i in [0, n) on the worker threads, and blocks until
+   * all of them are done.  If any of the calls throws, the first exception
+   * is rethrown here (after all calls have finished).
+   *
+   * This method may be called concurrently from multiple threads.
+   */
+  void ParallelFor (size_t n, const std::function<void (size_t)>& fcn);
+
+};
+
+} // namespace xid
+
+#endif // XID_WORKERPOOL_HPP
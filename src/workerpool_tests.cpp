@@ -0,0 +1,75 @@
+// Copyright (C) 2026 The Xaya developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "workerpool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace xid
+{
+namespace
+{
+
+TEST (WorkerPoolTests, AllIndicesProcessed)
+{
+  for (const unsigned threads : {0, 1, 4})
+    {
+      WorkerPool pool(threads);
+      EXPECT_EQ (pool.GetNumThreads (), threads);
+
+      for (const size_t n : {0, 1, 2, 100})
+        {
+          std::vector<std::atomic<unsigned>> calls(n);
+          pool.ParallelFor (n, [&calls] (const size_t i)
+            {
+              ++calls[i];
+            });
+
+          for (const auto& c : calls)
+            EXPECT_EQ (c, 1);
+        }
+    }
+}
+
+TEST (WorkerPoolTests, ConcurrentCallers)
+{
+  WorkerPool pool(3);
+
+  std::atomic<unsigned> total(0);
+  std::vector<std::thread> callers;
+  for (unsigned i = 0; i < 5; ++i)
+    callers.emplace_back ([&pool, &total] ()
+      {
+        pool.ParallelFor (50, [&total] (const size_t i)
+          {
+            ++total;
+          });
+      });
+
+  for (auto& t : callers)
+    t.join ();
+
+  EXPECT_EQ (total, 5 * 50);
+}
+
+TEST (WorkerPoolTests, Exception)
+{
+  WorkerPool pool(2);
+
+  std::atomic<unsigned> calls(0);
+  EXPECT_THROW (pool.ParallelFor (10, [&calls] (const size_t i)
+    {
+      ++calls;
+      if (i == 5)
+        throw std::runtime_error ("failure");
+    }), std::runtime_error);
+  EXPECT_EQ (calls, 10);
+}
+
+} // anonymous namespace
+} // namespace xid
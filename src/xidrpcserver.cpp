@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2025 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -6,14 +6,23 @@
 
 #include "gamestatejson.hpp"
 #include "rpcerrors.hpp"
+#include "signeraddress.hpp"
 
-#include "auth/credentials.hpp"
+#include "auth/credentialsdata.hpp"
 #include "auth/time.hpp"
 
 #include <xayagame/gamerpcserver.hpp>
 
 #include <glog/logging.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
 namespace xid
 {
 
@@ -35,6 +44,15 @@ XidRpcServer::EnableUnsafeMethods ()
   unsafeMethods = true;
 }
 
+void
+XidRpcServer::SetVerifyThreads (const unsigned n)
+{
+  if (n == 0)
+    verifyPool.reset ();
+  else
+    verifyPool = std::make_unique<WorkerPool> (n);
+}
+
 void
 XidRpcServer::stop ()
 {
@@ -48,7 +66,23 @@ XidRpcServer::getcurrentstate ()
 {
   LOG (INFO) << "RPC method called: getcurrentstate";
   EnsureUnsafeAllowed ("getcurrentstate");
-  return game.GetCurrentJsonState ();
+
+  /* The state is serialised by the same code as for the REST API's
+     /fullstate endpoint, so that both return the same data.  The JSON-RPC
+     server needs a Json::Value, though, so the text is parsed back.  */
+  std::ostringstream out;
+  logic.WriteCurrentState (game, out, true);
+  const std::string text = out.str ();
+
+  Json::CharReaderBuilder rbuilder;
+  const std::unique_ptr<Json::CharReader> reader(rbuilder.newCharReader ());
+  Json::Value res;
+  std::string parseErrs;
+  CHECK (reader->parse (text.data (), text.data () + text.size (),
+                        &res, &parseErrs))
+      << "Failed to parse written state: " << parseErrs;
+
+  return res;
 }
 
 Json::Value
@@ -76,6 +110,78 @@ XidRpcServer::getnamestate (const std::string& name)
       });
 }
 
+Json::Value
+XidRpcServer::getnamestates (const Json::Value& names)
+{
+  LOG (INFO) << "RPC method called: getnamestates " << names;
+
+  std::vector<std::string> nameList;
+  if (!ParseNameList (names, nameList))
+    ThrowJsonError (ErrorCode::INVALID_ARGUMENT,
+                    "names must be an array of at most "
+                      + std::to_string (MAX_NAMES_PER_BATCH) + " strings");
+
+  return logic.GetCustomStateData (game,
+    [&nameList] (const xaya::SQLiteDatabase& db)
+      {
+        return GetNameStates (db, nameList);
+      });
+}
+
+Json::Value
+XidRpcServer::listnames (const int count, const std::string& cursor)
+{
+  LOG (INFO)
+      << "RPC method called: listnames\n"
+      << "  count: " << count << "\n"
+      << "  cursor: " << cursor;
+
+  if (count <= 0 || count > static_cast<int> (MAX_NAMES_PER_PAGE))
+    ThrowJsonError (ErrorCode::INVALID_ARGUMENT,
+                    "count must be between 1 and "
+                      + std::to_string (MAX_NAMES_PER_PAGE));
+
+  bool ok = false;
+  const Json::Value res = logic.GetCustomStateData (game,
+    [count, &cursor, &ok] (const xaya::SQLiteDatabase& db)
+      {
+        Json::Value page;
+        ok = ListNames (db, cursor, count, page);
+        return page;
+      });
+
+  if (!ok)
+    ThrowJsonError (ErrorCode::INVALID_ARGUMENT, "invalid cursor");
+
+  return res;
+}
+
+Json::Value
+XidRpcServer::lookupsigner (const std::string& address)
+{
+  LOG (INFO) << "RPC method called: lookupsigner " << address;
+  return logic.GetCustomStateData (game,
+    [&address] (const xaya::SQLiteDatabase& db)
+      {
+        return LookupSigner (db, address);
+      });
+}
+
+Json::Value
+XidRpcServer::lookupaddress (const std::string& address,
+                             const std::string& key)
+{
+  LOG (INFO)
+      << "RPC method called: lookupaddress\n"
+      << "  key: " << key << "\n"
+      << "  address: " << address;
+  return logic.GetCustomStateData (game,
+    [&key, &address] (const xaya::SQLiteDatabase& db)
+      {
+        return LookupAddress (db, key, address);
+      });
+}
+
 Json::Value
 XidRpcServer::getauthmessage (const std::string& application,
                               const Json::Value& data,
@@ -103,12 +209,14 @@ IsValidSigner (const xaya::SQLiteDatabase& db, const std::string& addr,
                const std::string& name, const std::string& app)
 {
   auto stmt = db.PrepareRo (R"(
-    SELECT `application`
-      FROM `signers`
-      WHERE `name` = ?1 AND `address` = ?2
+    SELECT `a`.`value`
+      FROM `names` AS `n`
+        INNER JOIN `signers` AS `s` ON `s`.`name_id` = `n`.`id`
+        LEFT JOIN `applications` AS `a` ON `a`.`id` = `s`.`application_id`
+      WHERE `n`.`value` = ?1 AND `s`.`address` = ?2
   )");
   stmt.Bind (1, name);
-  stmt.Bind (2, addr);
+  BindSignerAddress (stmt, 2, addr);
 
   while (stmt.Step ())
     {
@@ -124,6 +232,323 @@ IsValidSigner (const xaya::SQLiteDatabase& db, const std::string& addr,
   return false;
 }
 
+/**
+ * State of a verifyauth call after the checks that do not need access
+ * to the game state (i.e. everything except the signer check).
+ */
+struct PendingAuth
+{
+
+  /** The result JSON built so far.  */
+  Json::Value res;
+
+  /**
+   * True if the credentials are fine so far, and the result depends on
+   * whether or not the signer is valid.  If false, res is final.
+   */
+  bool needsSignerCheck = false;
+
+  /** The address that signed the credentials (if needsSignerCheck).  */
+  std::string signer;
+
+  /** Whether the credentials are expired (if needsSignerCheck).  */
+  bool expired = false;
+
+  /** The generation of the name read before the state snapshot is taken.  */
+  uint64_t generation = 0;
+
+  /**
+   * Whether the result only depends on the signers of the name in the
+   * game state (as tracked by its generation).  This is not the case for
+   * delegation-contract credentials, whose results must thus neither be
+   * cached nor get session tokens.
+   */
+  bool fromGameState = true;
+
+};
+
+/**
+ * Performs the parts of verifyauth that do not need the game state:
+ * Parsing and validating the password and recovering the signer address
+ * (which may involve an RPC call to Xaya Core).  Credentials with the
+ * delegation-contract protocol are fully verified here.
+ */
+PendingAuth
+PrepareVerifyAuth (XidGame& logic, const std::string& name,
+                   const std::string& application,
+                   const std::string& password)
+{
+  PendingAuth pending;
+  pending.generation = logic.GetNameGenerations ().Get (name);
+
+  Json::Value& res = pending.res;
+  res = Json::Value (Json::objectValue);
+  res["valid"] = false;
+
+  /* Each thread (the RPC threads as well as the workers for batches) reuses
+     its own parser, so that decoding the password and building the auth
+     message do not need fresh allocations each time.  */
+  thread_local CredentialsData cred;
+  if (!cred.Parse (password))
+    {
+      res["state"] = "malformed";
+      return pending;
+    }
+
+  /* Delegation-contract credentials are supported if we have a verifier
+     for them.  They are then checked completely here.  */
+  DelegationVerifier* delegation = nullptr;
+  if (cred.GetProtocol () == Protocol::DELEGATION_CONTRACT)
+    delegation = logic.GetDelegationVerifier ();
+  if (cred.GetProtocol () != Protocol::XID_GSP && delegation == nullptr)
+    {
+      res["state"] = "unsupported-protocol";
+      return pending;
+    }
+  pending.fromGameState = (delegation == nullptr);
+
+  if (!cred.ValidateFormat (name, application))
+    {
+      res["state"] = "invalid-data";
+      return pending;
+    }
+
+  res["expiry"]
+      = cred.GetData ().has_expiry ()
+          ? static_cast<Json::Int64> (TimeToUnix (cred.GetExpiry ()))
+          : Json::Value ();
+
+  const auto& extraView = cred.GetExtra ();
+  Json::Value extra(Json::objectValue);
+  for (const auto& entry : extraView)
+    extra[std::string (entry.first)] = std::string (entry.second);
+  CHECK_EQ (extraView.size (), extra.size ());
+  res["extra"] = extra;
+
+  const bool expired = cred.IsExpired (std::time (nullptr));
+
+  if (delegation != nullptr)
+    {
+      /* As for the game state, expiry is checked last.  */
+      switch (delegation->Verify (name, application, cred))
+        {
+        case DelegationVerifier::Result::VALID:
+          res["state"] = expired ? "expired" : "valid";
+          res["valid"] = !expired;
+          break;
+        case DelegationVerifier::Result::INVALID:
+          res["state"] = "invalid-signature";
+          break;
+        case DelegationVerifier::Result::UNAVAILABLE:
+          res["state"] = "unavailable";
+          break;
+        }
+      return pending;
+    }
+
+  const std::string& authMsg = cred.BuildAuthMessage (name, application);
+  pending.signer = logic.VerifyMessage (authMsg, cred.GetSignature ());
+  pending.expired = expired;
+  pending.needsSignerCheck = true;
+
+  return pending;
+}
+
+/**
+ * Finishes a verifyauth call, given whether the signer is valid (which is
+ * ignored if no signer check is needed).  Returns the final result
+ * (without session token).
+ */
+Json::Value
+FinishVerifyAuth (const PendingAuth& pending, const bool validSigner)
+{
+  Json::Value res = pending.res;
+  if (!pending.needsSignerCheck)
+    return res;
+
+  if (!validSigner)
+    {
+      VLOG (1) << "Not a valid signer address: " << pending.signer;
+      res["state"] = "invalid-signature";
+      return res;
+    }
+
+  /* The check for being expired is the last thing done.  This ensures
+     that an "expired" state means that all else is good, and that the
+     credentials are really "ok except for expiry".  Together with the
+     returned "expiry" field, this allows client applications to
+     re-evaluate expiry if they want (e.g. if the current system time
+     may not be correct or applicable).  */
+  if (pending.expired)
+    {
+      res["state"] = "expired";
+      return res;
+    }
+
+  res["state"] = "valid";
+  res["valid"] = true;
+
+  return res;
+}
+
+/**
+ * Checks the signer of a pending verifyauth call against the game state.
+ * If the signer index is used in cross-check mode, the signer is checked
+ * with it as well, and mismatches are logged.
+ */
+bool
+CheckSigner (const XidGame& logic, const xaya::SQLiteDatabase& db,
+             const PendingAuth& pending, const std::string& name,
+             const std::string& application)
+{
+  if (!pending.needsSignerCheck)
+    return false;
+
+  const bool res = IsValidSigner (db, pending.signer, name, application);
+  if (logic.GetSignerIndexMode () != SignerIndexMode::CROSS_CHECK)
+    return res;
+
+  const auto index = logic.GetSignerIndex ()->GetSnapshot ();
+  if (index == nullptr)
+    return res;
+
+  /* The index may already reflect a block processed after the snapshot
+     was taken.  In that case the generation of the name has changed since
+     it was read (before taking the snapshot), and a mismatch is expected.  */
+  const bool indexed = index->IsValidSigner (name, application,
+                                             pending.signer);
+  if (indexed != res
+        && logic.GetNameGenerations ().Get (name) == pending.generation)
+    LOG (ERROR)
+        << "Signer index mismatch:\n"
+        << "  name: " << name << "\n"
+        << "  application: " << application << "\n"
+        << "  signer: " << pending.signer << "\n"
+        << "  index: " << indexed << "\n"
+        << "  database: " << res;
+
+  return res;
+}
+
+/**
+ * Checks the signer of a pending verifyauth call with the signer index.
+ */
+bool
+CheckSigner (const SignerIndex::Snapshot& index, const PendingAuth& pending,
+             const std::string& name, const std::string& application)
+{
+  return pending.needsSignerCheck
+            && index.IsValidSigner (name, application, pending.signer);
+}
+
+/**
+ * Re-evaluates whether credentials that passed all other checks are expired
+ * at the current time.  This is applied to results from the AuthCache, which
+ * may have been computed at a different time.
+ */
+void
+RefreshExpiry (Json::Value& res)
+{
+  const std::string state = res["state"].asString ();
+  if (state != "valid" && state != "expired")
+    return;
+
+  const auto& expiry = res["expiry"];
+  const bool expired = !expiry.isNull ()
+      && static_cast<int64_t> (TimeToUnix (std::time (nullptr)))
+            > expiry.asInt64 ();
+
+  res["state"] = expired ? "expired" : "valid";
+  res["valid"] = !expired;
+}
+
+/**
+ * Adds a session token to a verifyauth result if the credentials are valid
+ * and sessions are enabled.  The generation must have been read before the
+ * state snapshot from which the result was computed.
+ */
+void
+AddSessionToken (XidGame& logic, const std::string& name,
+                 const std::string& application, const uint64_t generation,
+                 Json::Value& res)
+{
+  const SessionManager* sessions = logic.GetSessions ();
+  if (sessions == nullptr || !res["valid"].asBool ())
+    return;
+
+  /* The session expires after the configured lifetime, but never after
+     the credentials themselves.  */
+  int64_t expiry = TimeToUnix (std::time (nullptr))
+                      + logic.GetSessionLifetime ();
+  if (!res["expiry"].isNull ())
+    expiry = std::min<int64_t> (expiry, res["expiry"].asInt64 ());
+
+  Json::Value session(Json::objectValue);
+  session["token"] = sessions->CreateToken (name, application,
+                                            generation, expiry);
+  session["expiry"] = static_cast<Json::Int64> (expiry);
+  res["session"] = session;
+}
+
+/** Maximum number of credentials in one verifyauthbatch call.  */
+constexpr unsigned MAX_AUTH_BATCH = 1'000;
+
+/**
+ * One entry of a verifyauthbatch call.
+ */
+struct BatchedAuth
+{
+  std::string name;
+  std::string application;
+  std::string password;
+
+  /** Whether the result was found in the AuthCache.  */
+  bool cached = false;
+
+  /** The cached result (if cached).  */
+  Json::Value cachedResult;
+
+  /**
+   * The prepared verification.  If the result was cached, only the
+   * generation it was computed at is set.
+   */
+  PendingAuth pending;
+};
+
+/**
+ * Parses the credentials argument of verifyauthbatch.  Returns false
+ * if it is invalid.
+ */
+bool
+ParseAuthBatch (const Json::Value& val, std::vector<BatchedAuth>& batch)
+{
+  if (!val.isArray () || val.size () > MAX_AUTH_BATCH)
+    return false;
+
+  batch.clear ();
+  batch.reserve (val.size ());
+  for (const auto& entry : val)
+    {
+      if (!entry.isObject () || entry.size () != 3)
+        return false;
+
+      const auto& name = entry["name"];
+      const auto& application = entry["application"];
+      const auto& password = entry["password"];
+      if (!name.isString () || !application.isString ()
+            || !password.isString ())
+        return false;
+
+      BatchedAuth cur;
+      cur.name = name.asString ();
+      cur.application = application.asString ();
+      cur.password = password.asString ();
+      batch.push_back (std::move (cur));
+    }
+
+  return true;
+}
+
 } // anonymous namespace
 
 Json::Value
@@ -136,69 +561,250 @@ XidRpcServer::verifyauth (const std::string& application,
       << "  name: " << name << "\n"
       << "  application: " << application << "\n"
       << "  password: " << password;
-  return logic.GetCustomStateData (game,
-    [this, &name, &application, &password] (const xaya::SQLiteDatabase& db)
-      {
-        Json::Value res(Json::objectValue);
-        res["valid"] = false;
 
-        Credentials cred(name, application);
-        if (!cred.FromPassword (password))
-          {
-            res["state"] = "malformed";
-            return res;
-          }
+  /* Results in the cache are still current as long as the generation of
+     the name has not changed.  Then we can skip everything, including
+     the game-state snapshot.  Only expiry needs to be checked again.  */
+  AuthCache* cache = logic.GetAuthCache ();
+  Json::Value res;
+  uint64_t generation;
+  bool fromGameState = true;
+  if (cache != nullptr
+        && cache->Lookup (name, application, password, res, generation))
+    {
+      VLOG (1) << "Using cached verifyauth result";
+      RefreshExpiry (res["data"]);
+    }
+  else
+    {
+      /* Everything that does not need the game state, in particular the
+         (potentially slow) signature verification, is done before the
+         snapshot is taken.  That way the snapshot is only held for the
+         quick signer lookup in the database.  */
+      const PendingAuth pending
+          = PrepareVerifyAuth (logic, name, application, password);
 
-        if (cred.GetProtocol () != Protocol::XID_GSP)
+      /* If the signer index is available, it is used instead of taking
+         a snapshot at all.  */
+      res = logic.GetIndexedStateData (
+        [&pending, &name, &application] (const SignerIndex::Snapshot& index)
           {
-            res["state"] = "unsupported-protocol";
-            return res;
-          }
+            return FinishVerifyAuth (pending, CheckSigner (index, pending, name,
+                                                           application));
+          });
+      if (res.isNull ())
+        res = logic.GetCustomStateData (game,
+          [this, &pending, &name, &application] (
+              const xaya::SQLiteDatabase& db)
+            {
+              return FinishVerifyAuth (pending,
+                                       CheckSigner (logic, db, pending, name,
+                                                    application));
+            });
+      generation = pending.generation;
+      fromGameState = pending.fromGameState;
 
-        if (!cred.ValidateFormat ())
-          {
-            res["state"] = "invalid-data";
-            return res;
-          }
+      if (cache != nullptr && fromGameState)
+        cache->Insert (name, application, password, generation, res);
+    }
+
+  if (fromGameState)
+    AddSessionToken (logic, name, application, generation, res["data"]);
+  return res;
+}
+
+Json::Value
+XidRpcServer::verifyauthbatch (const Json::Value& credentials)
+{
+  LOG (INFO)
+      << "RPC method called: verifyauthbatch with "
+      << credentials.size () << " entries";
+
+  std::vector<BatchedAuth> batch;
+  if (!ParseAuthBatch (credentials, batch))
+    ThrowJsonError (ErrorCode::INVALID_ARGUMENT,
+                    "credentials must be an array of at most "
+                      + std::to_string (MAX_AUTH_BATCH)
+                      + " objects with name, application and password");
+
+  /* Runs a function for each index up to n, on the worker pool
+     if there is one.  */
+  const auto forEach = [this] (const size_t n, const auto& fn)
+    {
+      if (verifyPool == nullptr)
+        for (size_t i = 0; i < n; ++i)
+          fn (i);
+      else
+        verifyPool->ParallelFor (n, fn);
+    };
+
+  AuthCache* cache = logic.GetAuthCache ();
+  forEach (batch.size (), [this, cache, &batch] (const size_t i)
+    {
+      auto& entry = batch[i];
+      if (cache != nullptr)
+        {
+          Json::Value cachedRes;
+          if (cache->Lookup (entry.name, entry.application, entry.password,
+                             cachedRes, entry.pending.generation))
+            {
+              entry.cached = true;
+              entry.cachedResult = std::move (cachedRes["data"]);
+              return;
+            }
+        }
+
+      entry.pending = PrepareVerifyAuth (logic, entry.name, entry.application,
+                                         entry.password);
+    });
+
+  /* All signer checks are answered from the same snapshot (of the signer
+     index if available, or the database otherwise).  The function passed
+     to finishBatch checks the signer for an entry in it.
+
+     Unlike for a single verifyauth, the cached results are returned together
+     with this snapshot.  They are only correct for it if the signers did not
+     change since the lookup.  Otherwise (which is very rare), finishBatch
+     just collects the outdated entries and returns no result.  They are
+     then verified again after leaving the snapshot (reading their new
+     generation before the next one is taken), and the check is repeated
+     with a new snapshot.  */
+  const NameGenerations& generations = logic.GetNameGenerations ();
+  std::vector<size_t> stale;
+  const auto finishBatch = [&generations, &batch, &stale] (const auto& check)
+    {
+      for (size_t i = 0; i < batch.size (); ++i)
+        if (batch[i].cached
+              && generations.Get (batch[i].name)
+                    != batch[i].pending.generation)
+          stale.push_back (i);
+      if (!stale.empty ())
+        return Json::Value ();
 
-        res["expiry"]
-            = cred.HasExpiry ()
-                ? static_cast<Json::Int64> (TimeToUnix (cred.GetExpiry ()))
-                : Json::Value ();
-
-        const auto& extraMap = cred.GetExtra ();
-        Json::Value extra(Json::objectValue);
-        for (const auto& entry : extraMap)
-          extra[entry.first] = entry.second;
-        CHECK_EQ (extraMap.size (), extra.size ());
-        res["extra"] = extra;
-
-        const std::string authMsg = cred.GetAuthMessage ();
-        const std::string sgnAddr = logic.VerifyMessage (authMsg,
-                                                         cred.GetSignature ());
-        if (!IsValidSigner (db, sgnAddr, name, application))
+      Json::Value data(Json::arrayValue);
+      for (auto& entry : batch)
+        if (entry.cached)
           {
-            VLOG (1) << "Not a valid signer address: " << sgnAddr;
-            res["state"] = "invalid-signature";
-            return res;
+            RefreshExpiry (entry.cachedResult);
+            data.append (entry.cachedResult);
           }
+        else
+          data.append (FinishVerifyAuth (entry.pending, check (entry)));
+      return data;
+    };
 
-        /* The check for being expired is the last thing done.  This ensures
-           that an "expired" state means that all else is good, and that the
-           credentials are really "ok except for expiry".  Together with the
-           returned "expiry" field, this allows client applications to
-           re-evaluate expiry if they want (e.g. if the current system time
-           may not be correct or applicable).  */
-        if (cred.IsExpired ())
+  Json::Value res;
+  while (true)
+    {
+      stale.clear ();
+      res = logic.GetIndexedStateData (
+        [&finishBatch] (const SignerIndex::Snapshot& index)
           {
-            res["state"] = "expired";
-            return res;
-          }
+            return finishBatch ([&index] (const BatchedAuth& entry)
+              {
+                return CheckSigner (index, entry.pending, entry.name,
+                                    entry.application);
+              });
+          });
+      if (res.isNull ())
+        res = logic.GetCustomStateData (game,
+          [this, &finishBatch] (const xaya::SQLiteDatabase& db)
+            {
+              return finishBatch ([this, &db] (const BatchedAuth& entry)
+                {
+                  return CheckSigner (logic, db, entry.pending, entry.name,
+                                      entry.application);
+                });
+            });
 
-        res["state"] = "valid";
-        res["valid"] = true;
-        return res;
-      });
+      if (stale.empty ())
+        break;
+
+      VLOG (1)
+          << "Verifying " << stale.size ()
+          << " outdated cached results of verifyauthbatch again";
+      forEach (stale.size (), [this, &batch, &stale] (const size_t i)
+        {
+          auto& entry = batch[stale[i]];
+          entry.cached = false;
+          entry.pending = PrepareVerifyAuth (logic, entry.name,
+                                             entry.application,
+                                             entry.password);
+        });
+    }
+
+  /* Newly verified results are cached individually, with the state
+     information of the batch.  */
+  if (cache != nullptr)
+    {
+      Json::Value envelope = res;
+      envelope.removeMember ("data");
+      for (size_t i = 0; i < batch.size (); ++i)
+        {
+          const auto& entry = batch[i];
+          if (entry.cached || !entry.pending.fromGameState)
+            continue;
+
+          Json::Value single = envelope;
+          single["data"] = res["data"][static_cast<Json::ArrayIndex> (i)];
+          cache->Insert (entry.name, entry.application, entry.password,
+                         entry.pending.generation, single);
+        }
+    }
+
+  for (size_t i = 0; i < batch.size (); ++i)
+    if (batch[i].pending.fromGameState)
+      AddSessionToken (logic, batch[i].name, batch[i].application,
+                       batch[i].pending.generation,
+                       res["data"][static_cast<Json::ArrayIndex> (i)]);
+
+  return res;
+}
+
+Json::Value
+XidRpcServer::verifysession (const std::string& application,
+                             const std::string& name,
+                             const std::string& token)
+{
+  LOG (INFO)
+      << "RPC method called: verifysession\n"
+      << "  name: " << name << "\n"
+      << "  application: " << application;
+
+  const SessionManager* sessions = logic.GetSessions ();
+  if (sessions == nullptr)
+    ThrowJsonError (ErrorCode::SESSIONS_NOT_ENABLED,
+                    "session tokens are not enabled");
+
+  int64_t expiry = 0;
+  const auto state
+      = sessions->VerifyToken (name, application, token,
+                               TimeToUnix (std::time (nullptr)), expiry);
+
+  Json::Value res(Json::objectValue);
+  res["valid"] = false;
+  switch (state)
+    {
+    case SessionManager::TokenState::VALID:
+      res["valid"] = true;
+      res["state"] = "valid";
+      break;
+    case SessionManager::TokenState::MALFORMED:
+      res["state"] = "malformed";
+      return res;
+    case SessionManager::TokenState::INVALID:
+      res["state"] = "invalid";
+      return res;
+    case SessionManager::TokenState::OUTDATED:
+      res["state"] = "outdated";
+      break;
+    case SessionManager::TokenState::EXPIRED:
+      res["state"] = "expired";
+      break;
+    }
+  res["expiry"] = static_cast<Json::Int64> (expiry);
+
+  return res;
 }
 
 } // namespace xid
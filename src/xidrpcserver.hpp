@@ -1,4 +1,4 @@
-// Copyright (C) 2019-2025 The Xaya developers
+// Copyright (C) 2019-2026 The Xaya developers
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
@@ -9,6 +9,7 @@
 
 #include "logic.hpp"
 #include "nonstaterpc.hpp"
+#include "workerpool.hpp"
 
 #include <xayagame/game.hpp>
 #include <xayagame/rpc-stubs/xayawalletrpcclient.h>
@@ -16,6 +17,7 @@
 #include <json/json.h>
 #include <jsonrpccpp/server.h>
 
+#include <memory>
 #include <string>
 
 namespace xid
@@ -45,6 +47,12 @@ private:
    */
   bool unsafeMethods = false;
 
+  /**
+   * Worker pool used to verify the signatures of batched credentials
+   * in parallel.  If null, they are verified sequentially.
+   */
+  std::unique_ptr<WorkerPool> verifyPool;
+
   /**
    * Checks if unsafe methods are allowed.  If not, throws a JSON-RPC
    * exception to the caller.
@@ -64,12 +72,23 @@ public:
    */
   void EnableUnsafeMethods ();
 
+  /**
+   * Sets the number of worker threads used to verify signatures in
+   * verifyauthbatch.  If zero, they are verified on the RPC thread.
+   */
+  void SetVerifyThreads (unsigned n);
+
   void stop () override;
   Json::Value getcurrentstate () override;
   Json::Value getnullstate () override;
   std::string waitforchange (const std::string& knownBlock) override;
 
   Json::Value getnamestate (const std::string& name) override;
+  Json::Value getnamestates (const Json::Value& names) override;
+  Json::Value listnames (int count, const std::string& cursor) override;
+  Json::Value lookupsigner (const std::string& address) override;
+  Json::Value lookupaddress (const std::string& address,
+                             const std::string& key) override;
 
   Json::Value getauthmessage (const std::string& application,
                               const Json::Value& data,
@@ -79,6 +98,10 @@ public:
   Json::Value verifyauth (const std::string& application,
                           const std::string& name,
                           const std::string& password) override;
+  Json::Value verifyauthbatch (const Json::Value& credentials) override;
+  Json::Value verifysession (const std::string& application,
+                             const std::string& name,
+                             const std::string& token) override;
 
 };
 